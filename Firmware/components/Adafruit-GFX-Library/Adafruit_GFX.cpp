@@ -38,86 +38,31 @@ POSSIBILITY OF SUCH DAMAGE.
 #include "glcdfont.c"
 
 
-#ifndef pgm_read_byte
- #define pgm_read_byte(addr) (*(const unsigned char *)(addr))
-#endif
-#ifndef pgm_read_word
- #define pgm_read_word(addr) (*(const unsigned short *)(addr))
-#endif
-#ifndef pgm_read_dword
- #define pgm_read_dword(addr) (*(const unsigned long *)(addr))
-#endif
-
-// Pointers are a peculiar case...typically 16-bit on AVR boards,
-// 32 bits elsewhere.  Try to accommodate both...
-
-#if !defined(__INT_MAX__) || (__INT_MAX__ > 0xFFFF)
- #define pgm_read_pointer(addr) ((void *)pgm_read_dword(addr))
-#else
- #define pgm_read_pointer(addr) ((void *)pgm_read_word(addr))
-#endif
-
 #ifndef min
 #define min(a,b) (((a) < (b)) ? (a) : (b))
 #endif
 
-#ifndef _swap_int16_t
-#define _swap_int16_t(a, b) { int16_t t = a; a = b; b = t; }
-#endif
-
 Adafruit_GFX::Adafruit_GFX(int16_t w, int16_t h):
-WIDTH(w), HEIGHT(h)
+Core(w, h)
 {
-    _width    = WIDTH;
-    _height   = HEIGHT;
-    rotation  = 0;
     cursor_y  = cursor_x    = 0;
     textsize  = 1;
     textcolor = textbgcolor = 0xFFFF;
     wrap      = true;
-    _cp437    = false;
-    gfxFont   = NULL;
+    _utf8     = false;
+    _utf8Code = 0;
+    _utf8Left = 0;
+    _textCache     = NULL;
+    _textCacheSize = 0;
+    _textCacheUsed = 0;
 }
 
-// Bresenham's algorithm - thx wikpedia
+// The primitives run the algorithms of the rendering core (gfxcore.h)
+
+// Bresenham's algorithm, clipped before the first step
 void Adafruit_GFX::writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
         uint16_t color) {
-    int16_t steep = abs(y1 - y0) > abs(x1 - x0);
-    if (steep) {
-        _swap_int16_t(x0, y0);
-        _swap_int16_t(x1, y1);
-    }
-
-    if (x0 > x1) {
-        _swap_int16_t(x0, x1);
-        _swap_int16_t(y0, y1);
-    }
-
-    int16_t dx, dy;
-    dx = x1 - x0;
-    dy = abs(y1 - y0);
-
-    int16_t err = dx / 2;
-    int16_t ystep;
-
-    if (y0 < y1) {
-        ystep = 1;
-    } else {
-        ystep = -1;
-    }
-
-    for (; x0<=x1; x0++) {
-        if (steep) {
-            writePixel(y0, x0, color);
-        } else {
-            writePixel(x0, y0, color);
-        }
-        err -= dy;
-        if (err < 0) {
-            y0 += ystep;
-            err += dx;
-        }
-    }
+    Core::writeLine(x0, y0, x1, y1, color);
 }
 
 void Adafruit_GFX::startWrite(){
@@ -164,9 +109,7 @@ void Adafruit_GFX::endWrite(){
 void Adafruit_GFX::drawFastVLine(int16_t x, int16_t y,
         int16_t h, uint16_t color) {
     // Update in subclasses if desired!
-    startWrite();
-    writeLine(x, y, x, y+h-1, color);
-    endWrite();
+    Core::drawFastVLine(x, y, h, color);
 }
 
 // (x,y) is leftmost point; if unsure, calling function
@@ -174,19 +117,13 @@ void Adafruit_GFX::drawFastVLine(int16_t x, int16_t y,
 void Adafruit_GFX::drawFastHLine(int16_t x, int16_t y,
         int16_t w, uint16_t color) {
     // Update in subclasses if desired!
-    startWrite();
-    writeLine(x, y, x+w-1, y, color);
-    endWrite();
+    Core::drawFastHLine(x, y, w, color);
 }
 
 void Adafruit_GFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
         uint16_t color) {
     // Update in subclasses if desired!
-    startWrite();
-    for (int16_t i=x; i<x+w; i++) {
-        writeFastVLine(i, y, h, color);
-    }
-    endWrite();
+    Core::fillRect(x, y, w, h, color);
 }
 
 void Adafruit_GFX::fillScreen(uint16_t color) {
@@ -197,259 +134,65 @@ void Adafruit_GFX::fillScreen(uint16_t color) {
 void Adafruit_GFX::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
         uint16_t color) {
     // Update in subclasses if desired!
-    if(x0 == x1){
-        if(y0 > y1) _swap_int16_t(y0, y1);
-        drawFastVLine(x0, y0, y1 - y0 + 1, color);
-    } else if(y0 == y1){
-        if(x0 > x1) _swap_int16_t(x0, x1);
-        drawFastHLine(x0, y0, x1 - x0 + 1, color);
-    } else {
-        startWrite();
-        writeLine(x0, y0, x1, y1, color);
-        endWrite();
-    }
+    Core::drawLine(x0, y0, x1, y1, color);
 }
 
 // Draw a circle outline
 void Adafruit_GFX::drawCircle(int16_t x0, int16_t y0, int16_t r,
         uint16_t color) {
-    int16_t f = 1 - r;
-    int16_t ddF_x = 1;
-    int16_t ddF_y = -2 * r;
-    int16_t x = 0;
-    int16_t y = r;
-
-    startWrite();
-    writePixel(x0  , y0+r, color);
-    writePixel(x0  , y0-r, color);
-    writePixel(x0+r, y0  , color);
-    writePixel(x0-r, y0  , color);
-
-    while (x<y) {
-        if (f >= 0) {
-            y--;
-            ddF_y += 2;
-            f += ddF_y;
-        }
-        x++;
-        ddF_x += 2;
-        f += ddF_x;
-
-        writePixel(x0 + x, y0 + y, color);
-        writePixel(x0 - x, y0 + y, color);
-        writePixel(x0 + x, y0 - y, color);
-        writePixel(x0 - x, y0 - y, color);
-        writePixel(x0 + y, y0 + x, color);
-        writePixel(x0 - y, y0 + x, color);
-        writePixel(x0 + y, y0 - x, color);
-        writePixel(x0 - y, y0 - x, color);
-    }
-    endWrite();
+    Core::drawCircle(x0, y0, r, color);
 }
 
 void Adafruit_GFX::drawCircleHelper( int16_t x0, int16_t y0,
         int16_t r, uint8_t cornername, uint16_t color) {
-    int16_t f     = 1 - r;
-    int16_t ddF_x = 1;
-    int16_t ddF_y = -2 * r;
-    int16_t x     = 0;
-    int16_t y     = r;
-
-    while (x<y) {
-        if (f >= 0) {
-            y--;
-            ddF_y += 2;
-            f     += ddF_y;
-        }
-        x++;
-        ddF_x += 2;
-        f     += ddF_x;
-        if (cornername & 0x4) {
-            writePixel(x0 + x, y0 + y, color);
-            writePixel(x0 + y, y0 + x, color);
-        }
-        if (cornername & 0x2) {
-            writePixel(x0 + x, y0 - y, color);
-            writePixel(x0 + y, y0 - x, color);
-        }
-        if (cornername & 0x8) {
-            writePixel(x0 - y, y0 + x, color);
-            writePixel(x0 - x, y0 + y, color);
-        }
-        if (cornername & 0x1) {
-            writePixel(x0 - y, y0 - x, color);
-            writePixel(x0 - x, y0 - y, color);
-        }
-    }
+    Core::drawCircleHelper(x0, y0, r, cornername, color);
 }
 
 void Adafruit_GFX::fillCircle(int16_t x0, int16_t y0, int16_t r,
         uint16_t color) {
-    startWrite();
-    writeFastVLine(x0, y0-r, 2*r+1, color);
-    fillCircleHelper(x0, y0, r, 3, 0, color);
-    endWrite();
+    Core::fillCircle(x0, y0, r, color);
 }
 
 // Used to do circles and roundrects
 void Adafruit_GFX::fillCircleHelper(int16_t x0, int16_t y0, int16_t r,
         uint8_t cornername, int16_t delta, uint16_t color) {
+    Core::fillCircleHelper(x0, y0, r, cornername, delta, color);
+}
 
-    int16_t f     = 1 - r;
-    int16_t ddF_x = 1;
-    int16_t ddF_y = -2 * r;
-    int16_t x     = 0;
-    int16_t y     = r;
-
-    while (x<y) {
-        if (f >= 0) {
-            y--;
-            ddF_y += 2;
-            f     += ddF_y;
-        }
-        x++;
-        ddF_x += 2;
-        f     += ddF_x;
-
-        if (cornername & 0x1) {
-            writeFastVLine(x0+x, y0-y, 2*y+1+delta, color);
-            writeFastVLine(x0+y, y0-x, 2*x+1+delta, color);
-        }
-        if (cornername & 0x2) {
-            writeFastVLine(x0-x, y0-y, 2*y+1+delta, color);
-            writeFastVLine(x0-y, y0-x, 2*x+1+delta, color);
-        }
-    }
+// Default for drivers without a batch function, one line per span
+void Adafruit_GFX::fillSpans(const GFXspan *spans, uint16_t count,
+        bool vertical, uint16_t color) {
+    Core::fillSpans(spans, count, vertical, color);
 }
 
 // Draw a rectangle
 void Adafruit_GFX::drawRect(int16_t x, int16_t y, int16_t w, int16_t h,
         uint16_t color) {
-    startWrite();
-    writeFastHLine(x, y, w, color);
-    writeFastHLine(x, y+h-1, w, color);
-    writeFastVLine(x, y, h, color);
-    writeFastVLine(x+w-1, y, h, color);
-    endWrite();
+    Core::drawRect(x, y, w, h, color);
 }
 
 // Draw a rounded rectangle
 void Adafruit_GFX::drawRoundRect(int16_t x, int16_t y, int16_t w,
         int16_t h, int16_t r, uint16_t color) {
-    // smarter version
-    startWrite();
-    writeFastHLine(x+r  , y    , w-2*r, color); // Top
-    writeFastHLine(x+r  , y+h-1, w-2*r, color); // Bottom
-    writeFastVLine(x    , y+r  , h-2*r, color); // Left
-    writeFastVLine(x+w-1, y+r  , h-2*r, color); // Right
-    // draw four corners
-    drawCircleHelper(x+r    , y+r    , r, 1, color);
-    drawCircleHelper(x+w-r-1, y+r    , r, 2, color);
-    drawCircleHelper(x+w-r-1, y+h-r-1, r, 4, color);
-    drawCircleHelper(x+r    , y+h-r-1, r, 8, color);
-    endWrite();
+    Core::drawRoundRect(x, y, w, h, r, color);
 }
 
 // Fill a rounded rectangle
 void Adafruit_GFX::fillRoundRect(int16_t x, int16_t y, int16_t w,
         int16_t h, int16_t r, uint16_t color) {
-    // smarter version
-    startWrite();
-    writeFillRect(x+r, y, w-2*r, h, color);
-
-    // draw four corners
-    fillCircleHelper(x+w-r-1, y+r, r, 1, h-2*r-1, color);
-    fillCircleHelper(x+r    , y+r, r, 2, h-2*r-1, color);
-    endWrite();
+    Core::fillRoundRect(x, y, w, h, r, color);
 }
 
 // Draw a triangle
 void Adafruit_GFX::drawTriangle(int16_t x0, int16_t y0,
         int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color) {
-    drawLine(x0, y0, x1, y1, color);
-    drawLine(x1, y1, x2, y2, color);
-    drawLine(x2, y2, x0, y0, color);
+    Core::drawTriangle(x0, y0, x1, y1, x2, y2, color);
 }
 
 // Fill a triangle
 void Adafruit_GFX::fillTriangle(int16_t x0, int16_t y0,
         int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color) {
-
-    int16_t a, b, y, last;
-
-    // Sort coordinates by Y order (y2 >= y1 >= y0)
-    if (y0 > y1) {
-        _swap_int16_t(y0, y1); _swap_int16_t(x0, x1);
-    }
-    if (y1 > y2) {
-        _swap_int16_t(y2, y1); _swap_int16_t(x2, x1);
-    }
-    if (y0 > y1) {
-        _swap_int16_t(y0, y1); _swap_int16_t(x0, x1);
-    }
-
-    startWrite();
-    if(y0 == y2) { // Handle awkward all-on-same-line case as its own thing
-        a = b = x0;
-        if(x1 < a)      a = x1;
-        else if(x1 > b) b = x1;
-        if(x2 < a)      a = x2;
-        else if(x2 > b) b = x2;
-        writeFastHLine(a, y0, b-a+1, color);
-        endWrite();
-        return;
-    }
-
-    int16_t
-    dx01 = x1 - x0,
-    dy01 = y1 - y0,
-    dx02 = x2 - x0,
-    dy02 = y2 - y0,
-    dx12 = x2 - x1,
-    dy12 = y2 - y1;
-    int32_t
-    sa   = 0,
-    sb   = 0;
-
-    // For upper part of triangle, find scanline crossings for segments
-    // 0-1 and 0-2.  If y1=y2 (flat-bottomed triangle), the scanline y1
-    // is included here (and second loop will be skipped, avoiding a /0
-    // error there), otherwise scanline y1 is skipped here and handled
-    // in the second loop...which also avoids a /0 error here if y0=y1
-    // (flat-topped triangle).
-    if(y1 == y2) last = y1;   // Include y1 scanline
-    else         last = y1-1; // Skip it
-
-    for(y=y0; y<=last; y++) {
-        a   = x0 + sa / dy01;
-        b   = x0 + sb / dy02;
-        sa += dx01;
-        sb += dx02;
-        /* longhand:
-        a = x0 + (x1 - x0) * (y - y0) / (y1 - y0);
-        b = x0 + (x2 - x0) * (y - y0) / (y2 - y0);
-        */
-        if(a > b) _swap_int16_t(a,b);
-        writeFastHLine(a, y, b-a+1, color);
-    }
-
-    // For lower part of triangle, find scanline crossings for segments
-    // 0-2 and 1-2.  This loop is skipped if y1=y2.
-    sa = dx12 * (y - y1);
-    sb = dx02 * (y - y0);
-    for(; y<=y2; y++) {
-        a   = x1 + sa / dy12;
-        b   = x0 + sb / dy02;
-        sa += dx12;
-        sb += dx02;
-        /* longhand:
-        a = x1 + (x2 - x1) * (y - y1) / (y2 - y1);
-        b = x0 + (x2 - x0) * (y - y0) / (y2 - y0);
-        */
-        if(a > b) _swap_int16_t(a,b);
-        writeFastHLine(a, y, b-a+1, color);
-    }
-    endWrite();
+    Core::fillTriangle(x0, y0, x1, y1, x2, y2, color);
 }
 
 // BITMAP / XBITMAP / GRAYSCALE / RGB BITMAP FUNCTIONS ---------------------
@@ -704,101 +447,39 @@ void Adafruit_GFX::drawRGBBitmap(int16_t x, int16_t y,
 // Draw a character
 void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c,
   uint16_t color, uint16_t bg, uint8_t size) {
+    Core::drawChar(x, y, c, color, bg, size);
+}
 
-    if(!gfxFont) { // 'Classic' built-in font
+// Draw glyph 'index' of the current GFX font
+void Adafruit_GFX::drawGlyph(int16_t x, int16_t y, uint16_t index,
+  uint16_t color, uint8_t size) {
+    Core::drawGlyph(x, y, index, color, size);
+}
 
-        if((x >= _width)            || // Clip right
-           (y >= _height)           || // Clip bottom
-           ((x + 6 * size - 1) < 0) || // Clip left
-           ((y + 8 * size - 1) < 0))   // Clip top
-            return;
-
-        if(!_cp437 && (c >= 176)) c++; // Handle 'classic' charset behavior
-
-        startWrite();
-        for(int8_t i=0; i<5; i++ ) { // Char bitmap = 5 columns
-            uint8_t line = pgm_read_byte(&font[c * 5 + i]);
-            for(int8_t j=0; j<8; j++, line >>= 1) {
-                if(line & 1) {
-                    if(size == 1)
-                        writePixel(x+i, y+j, color);
-                    else
-                        writeFillRect(x+i*size, y+j*size, size, size, color);
-                } else if(bg != color) {
-                    if(size == 1)
-                        writePixel(x+i, y+j, bg);
-                    else
-                        writeFillRect(x+i*size, y+j*size, size, size, bg);
-                }
-            }
-        }
-        if(bg != color) { // If opaque, draw vertical line for last column
-            if(size == 1) writeFastVLine(x+5, y, 8, bg);
-            else          writeFillRect(x+5*size, y, size, 8*size, bg);
-        }
-        endWrite();
+// Draw icon 'index' of a precompiled icon set, the bitmap is in page order
+// (see gfxicon.h).  Set bits get 'color', clear bits 'bg' unless both are
+// equal.
+void Adafruit_GFX::drawIcon(int16_t x, int16_t y, const GFXiconSet *set,
+  uint8_t index, uint16_t color, uint16_t bg) {
 
-    } else { // Custom font
+    GFXicon *icon   = &(((GFXicon *)pgm_read_pointer(&set->icon))[index]);
+    uint8_t *bitmap = (uint8_t *)pgm_read_pointer(&set->bitmap);
+    uint16_t bo     = pgm_read_word(&icon->bitmapOffset);
+    uint8_t  w      = pgm_read_byte(&icon->width),
+             h      = pgm_read_byte(&icon->height);
 
-        // Character is assumed previously filtered by write() to eliminate
-        // newlines, returns, non-printable characters, etc.  Calling
-        // drawChar() directly with 'bad' characters of font may cause mayhem!
-
-        c -= (uint8_t)pgm_read_byte(&gfxFont->first);
-        GFXglyph *glyph  = &(((GFXglyph *)pgm_read_pointer(&gfxFont->glyph))[c]);
-        uint8_t  *bitmap = (uint8_t *)pgm_read_pointer(&gfxFont->bitmap);
-
-        uint16_t bo = pgm_read_word(&glyph->bitmapOffset);
-        uint8_t  w  = pgm_read_byte(&glyph->width),
-                 h  = pgm_read_byte(&glyph->height);
-        int8_t   xo = pgm_read_byte(&glyph->xOffset),
-                 yo = pgm_read_byte(&glyph->yOffset);
-        uint8_t  xx, yy, bits = 0, bit = 0;
-        int16_t  xo16 = 0, yo16 = 0;
-
-        if(size > 1) {
-            xo16 = xo;
-            yo16 = yo;
-        }
-
-        // Todo: Add character clipping here
-
-        // NOTE: THERE IS NO 'BACKGROUND' COLOR OPTION ON CUSTOM FONTS.
-        // THIS IS ON PURPOSE AND BY DESIGN.  The background color feature
-        // has typically been used with the 'classic' font to overwrite old
-        // screen contents with new data.  This ONLY works because the
-        // characters are a uniform size; it's not a sensible thing to do with
-        // proportionally-spaced fonts with glyphs of varying sizes (and that
-        // may overlap).  To replace previously-drawn text when using a custom
-        // font, use the getTextBounds() function to determine the smallest
-        // rectangle encompassing a string, erase the area with fillRect(),
-        // then draw new text.  This WILL infortunately 'blink' the text, but
-        // is unavoidable.  Drawing 'background' pixels will NOT fix this,
-        // only creates a new set of problems.  Have an idea to work around
-        // this (a canvas object type for MCUs that can afford the RAM and
-        // displays supporting setAddrWindow() and pushColors()), but haven't
-        // implemented this yet.
-
-        startWrite();
-        for(yy=0; yy<h; yy++) {
-            for(xx=0; xx<w; xx++) {
-                if(!(bit++ & 7)) {
-                    bits = pgm_read_byte(&bitmap[bo++]);
-                }
-                if(bits & 0x80) {
-                    if(size == 1) {
-                        writePixel(x+xo+xx, y+yo+yy, color);
-                    } else {
-                        writeFillRect(x+(xo16+xx)*size, y+(yo16+yy)*size,
-                          size, size, color);
-                    }
-                }
-                bits <<= 1;
+    startWrite();
+    for(int16_t j=0; j<h; j++) {
+        uint8_t *row = &bitmap[bo + (j / 8) * w];
+        for(int16_t i=0; i<w; i++) {
+            if(pgm_read_byte(&row[i]) & (1 << (j & 7))) {
+                writePixel(x+i, y+j, color);
+            } else if(bg != color) {
+                writePixel(x+i, y+j, bg);
             }
         }
-        endWrite();
-
-    } // End classic vs custom font
+    }
+    endWrite();
 }
 
 void Adafruit_GFX::print(const char * s) {
@@ -813,18 +494,79 @@ void Adafruit_GFX::println(const char * s) {
     write('\n');
 }
 
-void Adafruit_GFX::write(uint8_t c) {
+// Adds byte c to a UTF-8 sequence, returns true when the code point is
+// complete.  Invalid bytes and code points beyond U+FFFF are dropped.
+static bool utf8Feed(uint8_t c, uint16_t &code, uint8_t &left) {
+    if(c < 0x80) {        // ASCII, ends an incomplete sequence
+        code = c;
+        left = 0;
+        return true;
+    }
+    if(c < 0xC0) {        // Continuation byte
+        if(!left) return false;
+        code = (code << 6) | (c & 0x3F);
+        return (--left == 0);
+    }
+    if(c < 0xE0) {
+        code = c & 0x1F;
+        left = 1;
+    } else if(c < 0xF0) {
+        code = c & 0x0F;
+        left = 2;
+    } else {
+        left = 0;
+    }
+    return false;
+}
+
+// Latin-1 characters U+00A0..U+00FF in the classic font (CP437), 0 = none
+static const uint8_t latin1Cp437[96] = {
+    0xFF, 0xAD, 0x9B, 0x9C, 0x00, 0x9D, 0x00, 0x00, // A0  ¡ ¢ £   ¥
+    0x00, 0x00, 0xA6, 0xAE, 0xAA, 0x00, 0x00, 0x00, // A8    ª « ¬
+    0xF8, 0xF1, 0xFD, 0x00, 0x00, 0xE6, 0x00, 0xFA, // B0 ° ± ²     µ   ·
+    0x00, 0x00, 0xA7, 0xAF, 0xAC, 0xAB, 0x00, 0xA8, // B8     º » ¼ ½   ¿
+    0x00, 0x00, 0x00, 0x00, 0x8E, 0x8F, 0x92, 0x80, // C0         Ä Å Æ Ç
+    0x00, 0x90, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // C8   É
+    0x00, 0xA5, 0x00, 0x00, 0x00, 0x00, 0x99, 0x00, // D0   Ñ         Ö
+    0x00, 0x00, 0x00, 0x00, 0x9A, 0x00, 0x00, 0xE1, // D8         Ü     ß
+    0x85, 0xA0, 0x83, 0x00, 0x84, 0x86, 0x91, 0x87, // E0 à á â   ä å æ ç
+    0x8A, 0x82, 0x88, 0x89, 0x8D, 0xA1, 0x8C, 0x8B, // E8 è é ê ë ì í î ï
+    0x00, 0xA4, 0x95, 0xA2, 0x93, 0x00, 0x94, 0xF6, // F0   ñ ò ó ô   ö ÷
+    0x00, 0x97, 0xA3, 0x96, 0x81, 0x00, 0x00, 0x98  // F8   ù ú û ü     ÿ
+};
+
+// Character of the classic font for code point c, -1 if it has none.  The
+// result is what drawChar() expects, i.e. it includes the shift of the
+// 'classic' charset behavior (see cp437()).
+static inline int16_t classicChar(uint16_t c, bool utf8, bool cp437) {
+    if(!utf8 || (c < 0x80)) return c;
+    if((c < 0xA0) || (c > 0xFF)) return -1;
+
+    uint8_t cp = latin1Cp437[c - 0xA0];
+    if(!cp) return -1;
+    return (!cp437 && (cp > 176)) ? cp - 1 : cp;
+}
+
+void Adafruit_GFX::write(uint8_t b) {
+    uint16_t c = b; // Code point
+    if(((b >= 0x80) || _utf8Left) && _utf8) {
+        if(!utf8Feed(b, _utf8Code, _utf8Left)) return; // Sequence incomplete
+        c = _utf8Code;
+    }
+
     if(!gfxFont) { // 'Classic' built-in font
 
         if(c == '\n') {                        // Newline?
             cursor_x  = 0;                     // Reset x to zero,
             cursor_y += textsize * 8;          // advance y one line
         } else if(c != '\r') {                 // Ignore carriage returns
+            int16_t ch = classicChar(c, _utf8, _cp437);
+            if(ch < 0) return;                 // No glyph for code point
             if(wrap && ((cursor_x + textsize * 6) > _width)) { // Off right?
                 cursor_x  = 0;                 // Reset x to zero,
                 cursor_y += textsize * 8;      // advance y one line
             }
-            drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize);
+            drawChar(cursor_x, cursor_y, ch, textcolor, textbgcolor, textsize);
             cursor_x += textsize * 6;          // Advance x one char
         }
 
@@ -835,10 +577,10 @@ void Adafruit_GFX::write(uint8_t c) {
             cursor_y += (int16_t)textsize *
                         (uint8_t)pgm_read_byte(&gfxFont->yAdvance);
         } else if(c != '\r') {
-            uint8_t first = pgm_read_byte(&gfxFont->first);
-            if((c >= first) && (c <= (uint8_t)pgm_read_byte(&gfxFont->last))) {
+            int16_t index = gfxFontGlyphIndex(gfxFont, c);
+            if(index >= 0) { // Char present in this font?
                 GFXglyph *glyph = &(((GFXglyph *)pgm_read_pointer(
-                  &gfxFont->glyph))[c - first]);
+                  &gfxFont->glyph))[index]);
                 uint8_t   w     = pgm_read_byte(&glyph->width),
                           h     = pgm_read_byte(&glyph->height);
                 if((w > 0) && (h > 0)) { // Is there an associated bitmap?
@@ -848,7 +590,7 @@ void Adafruit_GFX::write(uint8_t c) {
                         cursor_y += (int16_t)textsize *
                           (uint8_t)pgm_read_byte(&gfxFont->yAdvance);
                     }
-                    drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize);
+                    drawGlyph(cursor_x, cursor_y, index, textcolor, textsize);
                 }
                 cursor_x += (uint8_t)pgm_read_byte(&glyph->xAdvance) * (int16_t)textsize;
             }
@@ -869,6 +611,10 @@ int16_t Adafruit_GFX::getCursorY(void) const {
     return cursor_y;
 }
 
+bool Adafruit_GFX::getTextWrap(void) const {
+    return wrap;
+}
+
 void Adafruit_GFX::setTextSize(uint8_t s) {
     textsize = (s > 0) ? s : 1;
 }
@@ -894,6 +640,7 @@ uint8_t Adafruit_GFX::getRotation(void) const {
 
 void Adafruit_GFX::setRotation(uint8_t x) {
     rotation = (x & 3);
+    _textCacheUsed = 0; // Wrapped lines depend on the width
     switch(rotation) {
         case 0:
         case 2:
@@ -919,6 +666,15 @@ void Adafruit_GFX::cp437(bool x) {
     _cp437 = x;
 }
 
+// Decode text as UTF-8.  Code points beyond the ASCII range are drawn if the
+// GFX font has a glyph for them (see GFXcodePage), the classic font covers a
+// part of Latin-1 (e.g. the degree sign) with its CP437 characters.  Off by
+// default, so bytes written to the classic font select CP437 characters.
+void Adafruit_GFX::utf8(bool x) {
+    _utf8     = x;
+    _utf8Left = 0;
+}
+
 void Adafruit_GFX::setFont(const GFXfont *f) {
     if(f) {            // Font struct pointer passed in?
         if(!gfxFont) { // And no current font struct?
@@ -936,7 +692,7 @@ void Adafruit_GFX::setFont(const GFXfont *f) {
 
 // Broke this out as it's used by both the PROGMEM- and RAM-resident
 // getTextBounds() functions.
-void Adafruit_GFX::charBounds(char c, int16_t *x, int16_t *y,
+void Adafruit_GFX::charBounds(uint16_t c, int16_t *x, int16_t *y,
   int16_t *minx, int16_t *miny, int16_t *maxx, int16_t *maxy) {
 
     if(gfxFont) {
@@ -945,11 +701,10 @@ void Adafruit_GFX::charBounds(char c, int16_t *x, int16_t *y,
             *x  = 0;    // Reset x to zero, advance y by one line
             *y += textsize * (uint8_t)pgm_read_byte(&gfxFont->yAdvance);
         } else if(c != '\r') { // Not a carriage return; is normal char
-            uint8_t first = pgm_read_byte(&gfxFont->first),
-                    last  = pgm_read_byte(&gfxFont->last);
-            if((c >= first) && (c <= last)) { // Char present in this font?
+            int16_t index = gfxFontGlyphIndex(gfxFont, c);
+            if(index >= 0) { // Char present in this font?
                 GFXglyph *glyph = &(((GFXglyph *)pgm_read_pointer(
-                  &gfxFont->glyph))[c - first]);
+                  &gfxFont->glyph))[index]);
                 uint8_t gw = pgm_read_byte(&glyph->width),
                         gh = pgm_read_byte(&glyph->height),
                         xa = pgm_read_byte(&glyph->xAdvance);
@@ -978,7 +733,7 @@ void Adafruit_GFX::charBounds(char c, int16_t *x, int16_t *y,
             *x  = 0;                        // Reset x to zero,
             *y += textsize * 8;             // advance y one line
             // min/max x/y unchaged -- that waits for next 'normal' character
-        } else if(c != '\r') {  // Normal char; ignore carriage returns
+        } else if((c != '\r') && ((c < 0x80) || (classicChar(c, _utf8, _cp437) >= 0))) {
             if(wrap && ((*x + textsize * 6) > _width)) { // Off right?
                 *x  = 0;                    // Reset x to zero,
                 *y += textsize * 8;         // advance y one line
@@ -997,41 +752,128 @@ void Adafruit_GFX::charBounds(char c, int16_t *x, int16_t *y,
 // Pass string and a cursor position, returns UL corner and W,H.
 void Adafruit_GFX::getTextBounds(char *str, int16_t x, int16_t y,
         int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h) {
-    uint8_t c; // Current character
-
-    *x1 = x;
-    *y1 = y;
-    *w  = *h = 0;
-
-    int16_t minx = _width, miny = _height, maxx = -1, maxy = -1;
+    textBounds(str, false, x, y, x1, y1, w, h);
+}
 
-    while((c = *str++))
-        charBounds(c, &x, &y, &minx, &miny, &maxx, &maxy);
+// Same as above, but for PROGMEM strings
+void Adafruit_GFX::getTextBounds(const char *str,
+        int16_t x, int16_t y, int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h) {
+    textBounds(str, true, x, y, x1, y1, w, h);
+}
 
-    if(maxx >= minx) {
-        *x1 = minx;
-        *w  = maxx - minx + 1;
+// Bounds of several strings at the same cursor position, e.g. to lay out
+// the labels and values of a screen in one go
+void Adafruit_GFX::measureText(const char * const strings[], uint8_t count,
+        int16_t x, int16_t y, GFXbox boxes[]) {
+    for(uint8_t i=0; i<count; i++) {
+        textBounds(strings[i], false, x, y,
+          &boxes[i].x, &boxes[i].y, &boxes[i].w, &boxes[i].h);
     }
-    if(maxy >= miny) {
-        *y1 = miny;
-        *h  = maxy - miny + 1;
+}
+
+// Keep the bounds of the last 'count' strings measured in 'entries' (NULL
+// to stop).  Strings are told apart by a hash, font, text size, wrap and
+// utf8() are part of the key.  Measuring a repeated string is then a hash
+// of its characters instead of a glyph lookup per character.
+void Adafruit_GFX::setTextCache(GFXtextBounds *entries, uint8_t count) {
+    _textCache     = entries;
+    _textCacheSize = entries ? count : 0;
+    _textCacheUsed = 0;
+}
+
+// FNV-1a hash and length of a string, 'newline' is set if it has one
+static uint32_t textHash(const char *str, bool progmem, uint16_t *len,
+  bool *newline) {
+    const uint8_t *s = (const uint8_t *)str;
+    uint32_t hash = 0x811C9DC5;
+    uint8_t  c;
+
+    *len     = 0;
+    *newline = false;
+    while((c = progmem ? pgm_read_byte(s) : *s)) {
+        hash = (hash ^ c) * 0x01000193;
+        if(c == '\n') *newline = true;
+        s++;
+        (*len)++;
     }
+    return hash;
 }
 
-// Same as above, but for PROGMEM strings
-void Adafruit_GFX::getTextBounds(const char *str,
+static inline bool sameText(const GFXtextBounds &a, const GFXtextBounds &b) {
+    return (a.hash == b.hash) && (a.len == b.len) && (a.font == b.font) &&
+      (a.size == b.size) && (a.flags == b.flags) && (a.x == b.x);
+}
+
+void Adafruit_GFX::textBounds(const char *str, bool progmem,
         int16_t x, int16_t y, int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h) {
-    uint8_t *s = (uint8_t *)str, c;
+    const uint8_t *s = (const uint8_t *)str;
+    GFXtextBounds  key;
+    uint8_t        i, c; // Current character
+    bool           newline;
 
     *x1 = x;
     *y1 = y;
     *w  = *h = 0;
 
-    int16_t minx = _width, miny = _height, maxx = -1, maxy = -1;
+    // Extents of the characters, the result is limited like the walk of
+    // Adafruit_GFX has always been (starting from the display size)
+    int16_t minx = 0x7FFF, miny = 0x7FFF, maxx = -0x8000, maxy = -0x8000;
+
+    if(_textCacheSize) {
+        key.font  = gfxFont;
+        key.hash  = textHash(str, progmem, &key.len, &newline);
+        key.x     = (wrap || newline) ? x : 0; // Lines start at x = 0
+        key.size  = textsize;
+        key.flags = (wrap ? 1 : 0) | (_utf8 ? 2 : 0);
+        for(i=0; i<_textCacheUsed; i++) {
+            if(sameText(_textCache[i], key)) break;
+        }
+        if(i < _textCacheUsed) { // Hit, moves to the front
+            key = _textCache[i];
+            memmove(&_textCache[1], &_textCache[0], i * sizeof(GFXtextBounds));
+            _textCache[0] = key;
+            if(key.maxx >= key.minx) {
+                minx = x + key.minx;
+                miny = y + key.miny;
+                maxx = x + key.maxx;
+                maxy = y + key.maxy;
+            }
+            s = NULL;
+        }
+    }
 
-    while((c = pgm_read_byte(s++)))
-        charBounds(c, &x, &y, &minx, &miny, &maxx, &maxy);
+    if(s) {
+        int16_t  cx = x, cy = y;
+        uint16_t seq  = 0; // UTF-8 sequence, see write()
+        uint8_t  left = 0;
+        while((c = progmem ? pgm_read_byte(s) : *s)) {
+            s++;
+            uint16_t code = c;
+            if(c < 0x80) {
+                left = 0; // Ends an incomplete sequence
+            } else if(_utf8) {
+                if(!utf8Feed(c, seq, left)) continue; // Sequence incomplete
+                code = seq;
+            }
+            charBounds(code, &cx, &cy, &minx, &miny, &maxx, &maxy);
+        }
+
+        if(_textCacheSize) { // Miss, the least recently used entry drops out
+            key.minx = (maxx >= minx) ? minx - x : 1;
+            key.miny = (maxx >= minx) ? miny - y : 1;
+            key.maxx = (maxx >= minx) ? maxx - x : 0;
+            key.maxy = (maxx >= minx) ? maxy - y : 0;
+            if(_textCacheUsed < _textCacheSize) _textCacheUsed++;
+            memmove(&_textCache[1], &_textCache[0],
+              (_textCacheUsed - 1) * sizeof(GFXtextBounds));
+            _textCache[0] = key;
+        }
+    }
 
+    if(minx > _width)  minx = _width;
+    if(miny > _height) miny = _height;
+    if(maxx < -1)      maxx = -1;
+    if(maxy < -1)      maxy = -1;
     if(maxx >= minx) {
         *x1 = minx;
         *w  = maxx - minx + 1;
@@ -1210,6 +1052,186 @@ void GFXcanvas1::fillScreen(uint16_t color) {
     }
 }
 
+void GFXcanvas1::drawFastVLine(int16_t x, int16_t y,
+  int16_t h, uint16_t color) {
+    rectOp(x, y, 1, h, color ? GFX_ROP_OR : GFX_ROP_CLEAR);
+}
+
+void GFXcanvas1::drawFastHLine(int16_t x, int16_t y,
+  int16_t w, uint16_t color) {
+    rectOp(x, y, w, 1, color ? GFX_ROP_OR : GFX_ROP_CLEAR);
+}
+
+void GFXcanvas1::fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+  uint16_t color) {
+    rectOp(x, y, w, h, color ? GFX_ROP_OR : GFX_ROP_CLEAR);
+}
+
+void GFXcanvas1::fillSpans(const GFXspan *spans, uint16_t count,
+  bool vertical, uint16_t color) {
+    uint8_t rop = color ? GFX_ROP_OR : GFX_ROP_CLEAR;
+    for(uint16_t i=0; i<count; i++) {
+        if(vertical) rectOp(spans[i].x, spans[i].y, 1, spans[i].len, rop);
+        else         rectOp(spans[i].x, spans[i].y, spans[i].len, 1, rop);
+    }
+}
+
+void GFXcanvas1::invertRect(int16_t x, int16_t y, int16_t w, int16_t h) {
+    rectOp(x, y, w, h, GFX_ROP_XOR);
+}
+
+void GFXcanvas1::blit(int16_t x, int16_t y, const uint8_t bitmap[],
+  int16_t w, int16_t h, uint8_t rop) {
+    bitBlt(x, y, bitmap, (w + 7) / 8, 0, 0, w, h, rop);
+}
+
+void GFXcanvas1::copyRect(const GFXcanvas1 &src, int16_t sx, int16_t sy,
+  int16_t w, int16_t h, int16_t x, int16_t y, uint8_t rop) {
+    if(!src.buffer) return;
+
+    // Clip to the source canvas
+    if(sx < 0) { x -= sx; w += sx; sx = 0; }
+    if(sy < 0) { y -= sy; h += sy; sy = 0; }
+    if(sx + w > src.WIDTH)  w = src.WIDTH  - sx;
+    if(sy + h > src.HEIGHT) h = src.HEIGHT - sy;
+
+    bitBlt(x, y, src.buffer, (src.WIDTH + 7) / 8, sx, sy, w, h, rop);
+}
+
+void GFXcanvas1::copyToPages(uint8_t *pages) const {
+    if(!buffer) return;
+
+    uint16_t bytes = (WIDTH + 7) / 8;
+    for(int16_t y=0; y<HEIGHT; y+=8) {
+        for(uint16_t bx=0; bx<bytes; bx++) {
+            // 8x8 bit transpose (Hacker's Delight), the rows are taken in
+            // reverse order so that the top row ends up in the LSB
+            uint8_t r[8];
+            for(uint8_t i=0; i<8; i++) {
+                r[i] = (y + i < HEIGHT) ? buffer[(y + i) * bytes + bx] : 0;
+            }
+            uint32_t a = ((uint32_t)r[7] << 24) | ((uint32_t)r[6] << 16) |
+                         ((uint32_t)r[5] <<  8) | r[4];
+            uint32_t b = ((uint32_t)r[3] << 24) | ((uint32_t)r[2] << 16) |
+                         ((uint32_t)r[1] <<  8) | r[0];
+            uint32_t t;
+            t = (a ^ (a >>  7)) & 0x00AA00AA; a ^= t ^ (t <<  7);
+            t = (b ^ (b >>  7)) & 0x00AA00AA; b ^= t ^ (t <<  7);
+            t = (a ^ (a >> 14)) & 0x0000CCCC; a ^= t ^ (t << 14);
+            t = (b ^ (b >> 14)) & 0x0000CCCC; b ^= t ^ (t << 14);
+            t = (a & 0xF0F0F0F0) | ((b >> 4) & 0x0F0F0F0F);
+            b = ((a << 4) & 0xF0F0F0F0) | (b & 0x0F0F0F0F);
+            a = t;
+
+            uint8_t *col = &pages[(y / 8) * WIDTH + bx * 8];
+            for(uint8_t i=0; (i<8) && (bx * 8 + i < WIDTH); i++) {
+                col[i] = (i < 4) ? (a >> (24 - 8 * i)) : (b >> (56 - 8 * i));
+            }
+        }
+    }
+}
+
+// Fills, clears or inverts a rectangle given in rotated coordinates
+void GFXcanvas1::rectOp(int16_t x, int16_t y, int16_t w, int16_t h,
+  uint8_t rop) {
+    if((w <= 0) || (h <= 0)) return;
+
+    int16_t t;
+    switch(rotation) {
+        case 1:
+            t = x;
+            x = WIDTH  - y - h;
+            y = t;
+            t = w; w = h; h = t;
+            break;
+        case 2:
+            x = WIDTH  - x - w;
+            y = HEIGHT - y - h;
+            break;
+        case 3:
+            t = x;
+            x = y;
+            y = HEIGHT - t - w;
+            t = w; w = h; h = t;
+            break;
+    }
+    bitBlt(x, y, NULL, 0, 0, 0, w, h, rop);
+}
+
+// Reads n (1..32) bits starting at bit 'pos' of a MSB first bit row
+static inline uint32_t readBits(const uint8_t *row, int16_t pos, uint8_t n) {
+    const uint8_t *p   = &row[pos >> 3];
+    uint8_t        off = pos & 7;
+    uint8_t        len = (off + n + 7) >> 3; // Up to 5 bytes
+    uint64_t       v   = 0;
+    for(uint8_t i=0; i<len; i++) v = (v << 8) | p[i];
+    return (uint32_t)(v >> (len * 8 - off - n));
+}
+
+// Combines w pixels of the source row (NULL: all set) starting at bit 'sx'
+// into the destination row starting at bit 'x', up to 32 pixels per step.
+// Bytes are accessed one by one, rows need not be aligned and the end of
+// the row is never exceeded.
+static void rowOp(uint8_t *dst, int16_t x, const uint8_t *src, int16_t sx,
+  int16_t w, uint8_t rop) {
+    while(w > 0) {
+        uint8_t  *d    = &dst[x >> 3];
+        uint8_t   off  = x & 7;
+        uint8_t   n    = (w < 32 - off) ? w : 32 - off;
+        uint8_t   len  = (off + n + 7) >> 3;
+        uint32_t  mask = (0xFFFFFFFFUL >> off) &
+                         ((off + n < 32) ? ~(0xFFFFFFFFUL >> (off + n)) : 0xFFFFFFFFUL);
+        uint32_t  bits = src ? (readBits(src, sx, n) << (32 - off - n)) : 0xFFFFFFFFUL;
+        uint32_t  word = 0;
+
+        for(uint8_t i=0; i<len; i++) word |= (uint32_t)d[i] << (24 - 8 * i);
+        switch(rop) {
+            case GFX_ROP_COPY:  word = (word & ~mask) | (bits & mask); break;
+            case GFX_ROP_OR:    word |=  (bits & mask);                break;
+            case GFX_ROP_CLEAR: word &= ~(bits & mask);                break;
+            case GFX_ROP_XOR:   word ^=  (bits & mask);                break;
+        }
+        for(uint8_t i=0; i<len; i++) d[i] = word >> (24 - 8 * i);
+
+        x  += n;
+        sx += n;
+        w  -= n;
+    }
+}
+
+void GFXcanvas1::bitBlt(int16_t x, int16_t y, const uint8_t *src,
+  uint16_t stride, int16_t sx, int16_t sy, int16_t w, int16_t h,
+  uint8_t rop) {
+    if(!buffer) return;
+
+    // Clip to the canvas
+    if(x < 0) { sx -= x; w += x; x = 0; }
+    if(y < 0) { sy -= y; h += y; y = 0; }
+    if(x + w > WIDTH)  w = WIDTH  - x;
+    if(y + h > HEIGHT) h = HEIGHT - y;
+    if((w <= 0) || (h <= 0)) return;
+
+    uint16_t bytes = (WIDTH + 7) / 8;
+    if(!src && (w == 1)) {
+        // Vertical line, a single bit per row
+        uint8_t *ptr = &buffer[y * bytes + (x >> 3)];
+        uint8_t  bit = 0x80 >> (x & 7);
+        for(int16_t r=0; r<h; r++, ptr += bytes) {
+            switch(rop) {
+                case GFX_ROP_COPY:
+                case GFX_ROP_OR:    *ptr |=  bit; break;
+                case GFX_ROP_CLEAR: *ptr &= ~bit; break;
+                case GFX_ROP_XOR:   *ptr ^=  bit; break;
+            }
+        }
+        return;
+    }
+    for(int16_t r=0; r<h; r++) {
+        rowOp(&buffer[(y + r) * bytes], x,
+          src ? &src[(sy + r) * stride] : NULL, sx, w, rop);
+    }
+}
+
 GFXcanvas8::GFXcanvas8(uint16_t w, uint16_t h) : Adafruit_GFX(w, h) {
     uint32_t bytes = w * h;
     if((buffer = (uint8_t *)malloc(bytes))) {
@@ -4,9 +4,28 @@
 #include <stdint.h>
 #include <string.h>
 #include "gfxfont.h"
+#include "gfxicon.h"
+#include "gfxcore.h"
 
+// Bounding box of a string, see getTextBounds()
+typedef struct {
+  int16_t  x, y;
+  uint16_t w, h;
+} GFXbox;
 
-class Adafruit_GFX{
+// Text cache entry: extents of a string measured before, relative to the
+// cursor.  Keyed by font, size and a hash of the string, see setTextCache().
+typedef struct {
+  const GFXfont *font;
+  uint32_t hash;   // FNV-1a of the string
+  uint16_t len;
+  int16_t  x;      // Cursor x, only for wrapped text or several lines
+  uint8_t  size, flags;
+  int16_t  minx, miny, maxx, maxy; // maxx < minx: no pixels
+} GFXtextBounds;
+
+
+class Adafruit_GFX : protected GFXcore<Adafruit_GFX> {
 
  public:
 
@@ -43,7 +62,38 @@ class Adafruit_GFX{
     fillScreen(uint16_t color),
     // Optional and probably not necessary to change
     drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color),
-    drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color),
+    // Worth overriding for displays with a packed monochrome framebuffer
+    drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
+      int16_t w, int16_t h, uint16_t color),
+    drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
+      int16_t w, int16_t h, uint16_t color, uint16_t bg),
+    drawBitmap(int16_t x, int16_t y, uint8_t *bitmap,
+      int16_t w, int16_t h, uint16_t color),
+    drawBitmap(int16_t x, int16_t y, uint8_t *bitmap,
+      int16_t w, int16_t h, uint16_t color, uint16_t bg),
+    // Monochrome displays have to reduce the gray values, e.g. by dithering
+    drawGrayscaleBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
+      int16_t w, int16_t h),
+    drawGrayscaleBitmap(int16_t x, int16_t y, uint8_t *bitmap,
+      int16_t w, int16_t h),
+    drawGrayscaleBitmap(int16_t x, int16_t y,
+      const uint8_t bitmap[], const uint8_t mask[],
+      int16_t w, int16_t h),
+    drawGrayscaleBitmap(int16_t x, int16_t y,
+      uint8_t *bitmap, uint8_t *mask, int16_t w, int16_t h),
+    drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color,
+      uint16_t bg, uint8_t size),
+    // Glyph of the current GFX font by position, see gfxFontGlyphIndex()
+    drawGlyph(int16_t x, int16_t y, uint16_t index, uint16_t color,
+      uint8_t size),
+    // Icon of a precompiled set, bg == color draws it transparent
+    drawIcon(int16_t x, int16_t y, const GFXiconSet *set, uint8_t index,
+      uint16_t color, uint16_t bg),
+    // Batch of spans, all horizontal or all vertical, from fillCircle(),
+    // fillRoundRect() and fillTriangle()
+    fillSpans(const GFXspan *spans, uint16_t count, bool vertical,
+      uint16_t color);
 
   // These exist only with Adafruit_GFX (no subclass overrides)
   void
@@ -61,25 +111,8 @@ class Adafruit_GFX{
       int16_t radius, uint16_t color),
     fillRoundRect(int16_t x0, int16_t y0, int16_t w, int16_t h,
       int16_t radius, uint16_t color),
-    drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
-      int16_t w, int16_t h, uint16_t color),
-    drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
-      int16_t w, int16_t h, uint16_t color, uint16_t bg),
-    drawBitmap(int16_t x, int16_t y, uint8_t *bitmap,
-      int16_t w, int16_t h, uint16_t color),
-    drawBitmap(int16_t x, int16_t y, uint8_t *bitmap,
-      int16_t w, int16_t h, uint16_t color, uint16_t bg),
     drawXBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
       int16_t w, int16_t h, uint16_t color),
-    drawGrayscaleBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
-      int16_t w, int16_t h),
-    drawGrayscaleBitmap(int16_t x, int16_t y, uint8_t *bitmap,
-      int16_t w, int16_t h),
-    drawGrayscaleBitmap(int16_t x, int16_t y,
-      const uint8_t bitmap[], const uint8_t mask[],
-      int16_t w, int16_t h),
-    drawGrayscaleBitmap(int16_t x, int16_t y,
-      uint8_t *bitmap, uint8_t *mask, int16_t w, int16_t h),
     drawRGBBitmap(int16_t x, int16_t y, const uint16_t bitmap[],
       int16_t w, int16_t h),
     drawRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap,
@@ -89,19 +122,21 @@ class Adafruit_GFX{
       int16_t w, int16_t h),
     drawRGBBitmap(int16_t x, int16_t y,
       uint16_t *bitmap, uint8_t *mask, int16_t w, int16_t h),
-    drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color,
-      uint16_t bg, uint8_t size),
     setCursor(int16_t x, int16_t y),
     setTextColor(uint16_t c),
     setTextColor(uint16_t c, uint16_t bg),
     setTextSize(uint8_t s),
     setTextWrap(bool w),
     cp437(bool x=true),
+    utf8(bool x=true),
     setFont(const GFXfont *f = NULL),
     getTextBounds(char *string, int16_t x, int16_t y,
       int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h),
     getTextBounds(const char *s, int16_t x, int16_t y,
-      int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h);
+      int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h),
+    measureText(const char * const strings[], uint8_t count,
+      int16_t x, int16_t y, GFXbox boxes[]),
+    setTextCache(GFXtextBounds *entries, uint8_t count);
 
   void print(const char * s);
   void println(const char * s);
@@ -115,25 +150,39 @@ class Adafruit_GFX{
   int16_t getCursorX(void) const;
   int16_t getCursorY(void) const;
 
+  // e.g. to restore the wrap mode after drawing text that must not wrap
+  bool getTextWrap(void) const;
+
  protected:
+  // The primitives run the rendering core, with this class as target
+  friend class GFXcore<Adafruit_GFX>;
+  typedef GFXcore<Adafruit_GFX> Core;
+
   void
-    charBounds(char c, int16_t *x, int16_t *y,
-      int16_t *minx, int16_t *miny, int16_t *maxx, int16_t *maxy);
-  const int16_t
-    WIDTH, HEIGHT;   // This is the 'raw' display w/h - never changes
+    charBounds(uint16_t c, int16_t *x, int16_t *y,
+      int16_t *minx, int16_t *miny, int16_t *maxx, int16_t *maxy),
+    textBounds(const char *str, bool progmem, int16_t x, int16_t y,
+      int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h);
+  // WIDTH, HEIGHT, _width, _height, rotation, _cp437 and gfxFont are
+  // members of the core
   int16_t
-    _width, _height, // Display w/h as modified by current rotation
     cursor_x, cursor_y;
   uint16_t
     textcolor, textbgcolor;
   uint8_t
-    textsize,
-    rotation;
+    textsize;
   bool
     wrap,   // If set, 'wrap' text at right edge of display
-    _cp437; // If set, use correct CP437 charset (default is off)
-  GFXfont
-    *gfxFont;
+    _utf8;  // If set, text is decoded as UTF-8 (default is off)
+  uint16_t
+    _utf8Code;  // Code point of the sequence written so far
+  uint8_t
+    _utf8Left;  // Continuation bytes still expected
+  GFXtextBounds
+    *_textCache; // Most recently used first
+  uint8_t
+    _textCacheSize,
+    _textCacheUsed;
 };
 
 class Adafruit_GFX_Button {
@@ -167,15 +216,42 @@ class Adafruit_GFX_Button {
   bool currstate, laststate;
 };
 
+// Raster operations of the GFXcanvas1 bulk functions
+#define GFX_ROP_COPY  0 // Destination is replaced by the source
+#define GFX_ROP_OR    1 // Set source pixels are set
+#define GFX_ROP_CLEAR 2 // Set source pixels are cleared
+#define GFX_ROP_XOR   3 // Set source pixels are inverted
+
 class GFXcanvas1 : public Adafruit_GFX {
  public:
   GFXcanvas1(uint16_t w, uint16_t h);
   ~GFXcanvas1(void);
   void     drawPixel(int16_t x, int16_t y, uint16_t color),
-           fillScreen(uint16_t color);
+           fillScreen(uint16_t color),
+           drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color),
+           drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color),
+           fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color),
+           fillSpans(const GFXspan *spans, uint16_t count, bool vertical,
+             uint16_t color),
+           invertRect(int16_t x, int16_t y, int16_t w, int16_t h);
+  // Bulk copies, up to 32 pixels per step.  These work on the buffer as it
+  // is stored (rotation 0) and clip to the canvas.  The bitmap has the
+  // drawBitmap() layout, 'src' must not be this canvas.
+  void     blit(int16_t x, int16_t y, const uint8_t bitmap[],
+             int16_t w, int16_t h, uint8_t rop = GFX_ROP_COPY),
+           copyRect(const GFXcanvas1 &src, int16_t sx, int16_t sy,
+             int16_t w, int16_t h, int16_t x, int16_t y,
+             uint8_t rop = GFX_ROP_COPY);
+  // Converts the canvas into vertical page order as used by SSD1306 and
+  // similar controllers: WIDTH bytes per page of 8 rows, LSB = top row.
+  // 'pages' must hold WIDTH * ((HEIGHT + 7) / 8) bytes.
+  void     copyToPages(uint8_t *pages) const;
   uint8_t *getBuffer(void);
  private:
   uint8_t *buffer;
+  void     rectOp(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t rop),
+           bitBlt(int16_t x, int16_t y, const uint8_t *src, uint16_t stride,
+             int16_t sx, int16_t sy, int16_t w, int16_t h, uint8_t rop);
 };
 
 class GFXcanvas8 : public Adafruit_GFX {
@@ -572,6 +572,7 @@ const GFXglyph FreeMono24pt7bGlyphs[] PROGMEM = {
 const GFXfont FreeMono24pt7b PROGMEM = {
   (uint8_t  *)FreeMono24pt7bBitmaps,
   (GFXglyph *)FreeMono24pt7bGlyphs,
-  0x20, 0x7E, 47 };
+  0x20, 0x7E, 47, GFX_BITMAP_PLAIN,
+  NULL, NULL, 0 };
 
 // Approx. 6330 bytes
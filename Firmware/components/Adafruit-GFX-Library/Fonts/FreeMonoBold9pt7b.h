@@ -184,6 +184,7 @@ const GFXglyph FreeMonoBold9pt7bGlyphs[] PROGMEM = {
 const GFXfont FreeMonoBold9pt7b PROGMEM = {
   (uint8_t  *)FreeMonoBold9pt7bBitmaps,
   (GFXglyph *)FreeMonoBold9pt7bGlyphs,
-  0x20, 0x7E, 18 };
+  0x20, 0x7E, 18, GFX_BITMAP_PLAIN,
+  NULL, NULL, 0 };
 
 // Approx. 1672 bytes
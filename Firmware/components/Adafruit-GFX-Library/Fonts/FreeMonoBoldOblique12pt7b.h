@@ -264,6 +264,7 @@ const GFXglyph FreeMonoBoldOblique12pt7bGlyphs[] PROGMEM = {
 const GFXfont FreeMonoBoldOblique12pt7b PROGMEM = {
   (uint8_t  *)FreeMonoBoldOblique12pt7bBitmaps,
   (GFXglyph *)FreeMonoBoldOblique12pt7bGlyphs,
-  0x20, 0x7E, 24 };
+  0x20, 0x7E, 24, GFX_BITMAP_PLAIN,
+  NULL, NULL, 0 };
 
 // Approx. 2638 bytes
@@ -737,6 +737,7 @@ const GFXglyph FreeMonoBoldOblique24pt7bGlyphs[] PROGMEM = {
 const GFXfont FreeMonoBoldOblique24pt7b PROGMEM = {
   (uint8_t  *)FreeMonoBoldOblique24pt7bBitmaps,
   (GFXglyph *)FreeMonoBoldOblique24pt7bGlyphs,
-  0x20, 0x7E, 47 };
+  0x20, 0x7E, 47, GFX_BITMAP_PLAIN,
+  NULL, NULL, 0 };
 
 // Approx. 8307 bytes
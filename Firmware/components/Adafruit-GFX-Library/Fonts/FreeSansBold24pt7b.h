@@ -779,6 +779,7 @@ const GFXglyph FreeSansBold24pt7bGlyphs[] PROGMEM = {
 const GFXfont FreeSansBold24pt7b PROGMEM = {
   (uint8_t  *)FreeSansBold24pt7bBitmaps,
   (GFXglyph *)FreeSansBold24pt7bGlyphs,
-  0x20, 0x7E, 56 };
+  0x20, 0x7E, 56, GFX_BITMAP_PLAIN,
+  NULL, NULL, 0 };
 
 // Approx. 8815 bytes
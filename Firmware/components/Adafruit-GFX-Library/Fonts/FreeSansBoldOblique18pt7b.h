@@ -540,6 +540,7 @@ const GFXglyph FreeSansBoldOblique18pt7bGlyphs[] PROGMEM = {
 const GFXfont FreeSansBoldOblique18pt7b PROGMEM = {
   (uint8_t  *)FreeSansBoldOblique18pt7bBitmaps,
   (GFXglyph *)FreeSansBoldOblique18pt7bGlyphs,
-  0x20, 0x7E, 42 };
+  0x20, 0x7E, 42, GFX_BITMAP_PLAIN,
+  NULL, NULL, 0 };
 
 // Approx. 5943 bytes
@@ -513,6 +513,7 @@ const GFXglyph FreeSansOblique18pt7bGlyphs[] PROGMEM = {
 const GFXfont FreeSansOblique18pt7b PROGMEM = {
   (uint8_t  *)FreeSansOblique18pt7bBitmaps,
   (GFXglyph *)FreeSansOblique18pt7bGlyphs,
-  0x20, 0x7E, 42 };
+  0x20, 0x7E, 42, GFX_BITMAP_PLAIN,
+  NULL, NULL, 0 };
 
 // Approx. 5623 bytes
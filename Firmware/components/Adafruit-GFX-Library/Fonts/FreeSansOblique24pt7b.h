@@ -835,6 +835,7 @@ const GFXglyph FreeSansOblique24pt7bGlyphs[] PROGMEM = {
 const GFXfont FreeSansOblique24pt7b PROGMEM = {
   (uint8_t  *)FreeSansOblique24pt7bBitmaps,
   (GFXglyph *)FreeSansOblique24pt7bGlyphs,
-  0x20, 0x7E, 56 };
+  0x20, 0x7E, 56, GFX_BITMAP_PLAIN,
+  NULL, NULL, 0 };
 
 // Approx. 9483 bytes
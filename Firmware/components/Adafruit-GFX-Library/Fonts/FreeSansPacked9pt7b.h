@@ -0,0 +1,182 @@
+const uint8_t FreeSansPacked9pt7bBitmaps[] PROGMEM = {
+  0x7F, 0xF4, 0x18, 0x6F, 0x48, 0x04, 0xC1, 0x92, 0x7F, 0xC2, 0x64, 0x64,
+  0x5F, 0xF0, 0x98, 0x99, 0x00, 0x08, 0x07, 0xC2, 0x99, 0xA3, 0xB4, 0x11,
+  0xE0, 0x2E, 0x08, 0xDA, 0x39, 0x4C, 0x7E, 0x04, 0x10, 0x1C, 0x08, 0x3B,
+  0x08, 0x18, 0xC4, 0x0C, 0x64, 0x09, 0xB2, 0x00, 0x72, 0x00, 0x01, 0x3C,
+  0x01, 0x3B, 0x80, 0x98, 0xC0, 0x8C, 0x60, 0x47, 0x70, 0x41, 0xE0, 0x07,
+  0x01, 0x98, 0xC3, 0xC0, 0x18, 0x07, 0x80, 0xCD, 0x98, 0x59, 0x87, 0x18,
+  0x30, 0xC7, 0x87, 0x88, 0x7A, 0x08, 0xC4, 0x6B, 0x3E, 0x43, 0x44, 0x30,
+  0x80, 0x43, 0x08, 0x68, 0xFE, 0x23, 0x48, 0xC4, 0x00, 0x11, 0x57, 0xCA,
+  0x80, 0x19, 0xBF, 0x19, 0xC0, 0x66, 0x80, 0x78, 0x60, 0x06, 0x16, 0x26,
+  0x46, 0x84, 0x1E, 0x19, 0x88, 0x4C, 0x3F, 0xC8, 0x46, 0x61, 0xE0, 0x0C,
+  0x6F, 0x1F, 0xF8, 0x1F, 0x0C, 0x66, 0x0E, 0x01, 0x80, 0xE0, 0x70, 0x38,
+  0x18, 0x0C, 0x04, 0x04, 0xFF, 0x1E, 0x19, 0x98, 0x70, 0x18, 0x18, 0x38,
+  0x07, 0x01, 0xB0, 0xE6, 0x61, 0xE0, 0x06, 0x87, 0x0B, 0x49, 0x91, 0xAF,
+  0xE0, 0xDC, 0x3F, 0x88, 0x0D, 0x00, 0x7F, 0x1C, 0x60, 0x0F, 0x60, 0xCC,
+  0x61, 0xF0, 0x0F, 0x0C, 0x63, 0x0D, 0x80, 0xB7, 0x8E, 0x33, 0x07, 0x90,
+  0x66, 0x30, 0xF8, 0x7F, 0x80, 0xC0, 0x40, 0x60, 0x20, 0x30, 0x10, 0x18,
+  0xC2, 0x03, 0x08, 0x1F, 0x0C, 0x66, 0x0F, 0x31, 0x87, 0xC3, 0x19, 0x83,
+  0xCC, 0x61, 0xF0, 0x1E, 0x19, 0x98, 0x4C, 0x3C, 0xCE, 0x3B, 0x01, 0xD8,
+  0x46, 0x61, 0xE0, 0x63, 0xFB, 0x60, 0xFC, 0xC6, 0x40, 0xF2, 0x59, 0x9C,
+  0x42, 0xE8, 0x2E, 0x12, 0x9B, 0x6A, 0xCB, 0x84, 0x8E, 0x9D, 0x43, 0xA0,
+  0x00, 0x1C, 0x01, 0xC0, 0x1C, 0x00, 0xC0, 0xE0, 0xE1, 0xC0, 0x40, 0x00,
+  0x1F, 0x0C, 0x66, 0x0E, 0x01, 0x80, 0xC0, 0xE0, 0x30, 0x18, 0x40, 0x08,
+  0x60, 0x01, 0xF8, 0x01, 0x83, 0x80, 0xC0, 0x30, 0x60, 0x06, 0x30, 0xED,
+  0xCC, 0xC7, 0x36, 0x31, 0x8D, 0x98, 0x63, 0xB3, 0x08, 0xCC, 0xE6, 0x71,
+  0x9E, 0xF0, 0x60, 0x00, 0x0C, 0x00, 0x01, 0xC1, 0x00, 0x1F, 0xC0, 0x03,
+  0x00, 0x3C, 0x20, 0x90, 0x0C, 0xC4, 0x21, 0x03, 0x0C, 0x1F, 0xE0, 0x81,
+  0x0C, 0x0D, 0x60, 0x18, 0x7F, 0x86, 0x0C, 0x60, 0x6D, 0x83, 0x1F, 0xE1,
+  0x81, 0x98, 0x0F, 0x60, 0x67, 0xFC, 0x0F, 0xC1, 0x86, 0x30, 0x32, 0x03,
+  0x60, 0x0E, 0xC0, 0x64, 0x06, 0x60, 0xC3, 0x0C, 0x1F, 0x00, 0x7F, 0x86,
+  0x0C, 0x60, 0x66, 0x03, 0xFD, 0x81, 0x98, 0x31, 0xFE, 0x00, 0x7F, 0xD8,
+  0x0F, 0x7F, 0x98, 0x0F, 0x7F, 0xC0, 0x7F, 0xB0, 0x3D, 0xFC, 0xC0, 0xF8,
+  0x07, 0xC0, 0xC3, 0x8C, 0x0C, 0x60, 0x36, 0x00, 0x58, 0x3E, 0xC0, 0x39,
+  0x80, 0xCC, 0x0E, 0x30, 0xF0, 0x78, 0x80, 0x60, 0x3F, 0xBF, 0xFB, 0x01,
+  0xFC, 0x7F, 0xFE, 0x03, 0xFF, 0x63, 0xB1, 0x1E, 0x00, 0x60, 0x66, 0x0C,
+  0x61, 0x86, 0x30, 0x66, 0x06, 0xE0, 0x7E, 0x07, 0x30, 0x61, 0x8B, 0x06,
+  0x30, 0x34, 0x60, 0x7F, 0xF7, 0xF8, 0x70, 0x1E, 0xF0, 0x7D, 0xA0, 0xB6,
+  0xC6, 0xEC, 0x89, 0xB3, 0x67, 0x62, 0x8D, 0x8E, 0x38, 0x70, 0x3B, 0xC1,
+  0xB4, 0x1B, 0x61, 0xB3, 0x1B, 0x11, 0xB1, 0x9B, 0x0D, 0xD8, 0x3D, 0x81,
+  0xE0, 0x07, 0xC0, 0x60, 0xC3, 0x01, 0xAC, 0x01, 0xF9, 0x80, 0xD1, 0x83,
+  0x01, 0xF0, 0x7F, 0x8C, 0x19, 0x81, 0xEC, 0x19, 0xFE, 0x30, 0x0F, 0x80,
+  0x07, 0xC0, 0x60, 0xC3, 0x01, 0xAC, 0x01, 0xF9, 0x80, 0xC6, 0x1B, 0x0C,
+  0x18, 0x0F, 0xB0, 0x00, 0x40, 0x7F, 0xC3, 0x03, 0x98, 0x0D, 0xB0, 0x31,
+  0xFF, 0x0C, 0x0E, 0x60, 0x37, 0x60, 0x38, 0x1F, 0x86, 0x19, 0x81, 0xD8,
+  0x01, 0xE0, 0x0F, 0x80, 0x38, 0x01, 0xB0, 0x39, 0x86, 0x1F, 0x80, 0x7F,
+  0xC1, 0x8F, 0xFE, 0x60, 0x3F, 0xFC, 0xC1, 0x83, 0xE0, 0x60, 0x33, 0x03,
+  0x30, 0x21, 0x06, 0x18, 0x61, 0x84, 0x08, 0xC0, 0xCC, 0x0C, 0x80, 0x58,
+  0x07, 0x80, 0x70, 0x03, 0x00, 0x60, 0xC0, 0x8C, 0x38, 0x69, 0x85, 0x0C,
+  0x62, 0x62, 0x08, 0x99, 0x83, 0x22, 0x60, 0xD8, 0x98, 0x14, 0x34, 0x43,
+  0x83, 0x80, 0xC0, 0xE0, 0x10, 0x30, 0x30, 0x30, 0xC3, 0x21, 0x98, 0x07,
+  0x80, 0x38, 0x00, 0xC0, 0x0F, 0x00, 0xC8, 0x06, 0x60, 0x61, 0x86, 0x0E,
+  0x30, 0x30, 0x60, 0x19, 0x81, 0x86, 0x19, 0x0C, 0xC0, 0x76, 0x01, 0xE0,
+  0x06, 0x0F, 0x80, 0x8E, 0xDC, 0x22, 0xC9, 0x55, 0x34, 0x50, 0xDC, 0x35,
+  0x49, 0x61, 0x5E, 0x0B, 0x90, 0xEC, 0x76, 0xFF, 0xFD, 0xC0, 0x42, 0x46,
+  0x26, 0x16, 0x0C, 0x73, 0xFF, 0xFD, 0xC0, 0x18, 0x8A, 0x12, 0x13, 0x31,
+  0x21, 0x80, 0x8E, 0xC0, 0x61, 0x86, 0x3F, 0x1C, 0x66, 0x18, 0x06, 0x07,
+  0x8F, 0x66, 0x1A, 0xC7, 0x1E, 0xE0, 0x60, 0x36, 0xF1, 0xC6, 0x60, 0xFE,
+  0xE3, 0x37, 0x80, 0x1E, 0x19, 0x98, 0x6C, 0x0E, 0xC3, 0x33, 0x0F, 0x00,
+  0x01, 0xE3, 0xB3, 0x3B, 0x0F, 0xE6, 0x71, 0xD8, 0x1E, 0x19, 0x98, 0x77,
+  0xFB, 0x02, 0xC3, 0x33, 0x0F, 0x00, 0x19, 0xAF, 0x37, 0xF8, 0x1D, 0x99,
+  0xD8, 0x7F, 0x33, 0x8E, 0xC0, 0x76, 0x31, 0xF0, 0x60, 0x6D, 0xE7, 0x1B,
+  0x0F, 0xF8, 0x62, 0xFF, 0xE0, 0x18, 0x23, 0xFF, 0xF7, 0x00, 0x60, 0x36,
+  0x11, 0x88, 0x66, 0x1B, 0x07, 0xC1, 0xD8, 0x62, 0x18, 0xC6, 0x1A, 0x7F,
+  0xFE, 0x6F, 0x79, 0xC7, 0x36, 0x18, 0xFF, 0x80, 0x6F, 0x38, 0xD8, 0x7F,
+  0xC0, 0x1E, 0x19, 0x98, 0x7F, 0x33, 0x0F, 0x00, 0x6F, 0x1C, 0x66, 0x0F,
+  0xEE, 0x33, 0x78, 0xC0, 0x60, 0x1D, 0x99, 0xD8, 0x7F, 0x33, 0x8E, 0xC0,
+  0x78, 0x6D, 0xC6, 0x3F, 0x80, 0x1F, 0x38, 0xD8, 0x17, 0x00, 0xF0, 0x0E,
+  0xC3, 0x71, 0x9F, 0x80, 0x35, 0xE6, 0xFE, 0x70, 0x61, 0xFF, 0x63, 0x9E,
+  0xC0, 0x60, 0xC8, 0x23, 0x18, 0xC4, 0x11, 0x06, 0xC1, 0xA0, 0x28, 0x0E,
+  0x03, 0x00, 0x63, 0x0D, 0x8E, 0x22, 0x38, 0x8C, 0xA6, 0x36, 0x98, 0x5B,
+  0x41, 0x4D, 0x07, 0x1C, 0x1C, 0x60, 0x31, 0x80, 0x21, 0x98, 0x86, 0xC1,
+  0xC0, 0xC0, 0x70, 0x78, 0x26, 0x31, 0x10, 0xC0, 0x60, 0x88, 0x63, 0x18,
+  0xC4, 0x13, 0x06, 0xC1, 0xA0, 0x38, 0x86, 0x18, 0x40, 0x60, 0x00, 0x7F,
+  0x03, 0x06, 0x0C, 0x8C, 0x18, 0x10, 0x30, 0x3F, 0x80, 0x19, 0xBE, 0xE6,
+  0x38, 0xDF, 0x18, 0x7F, 0xFF, 0xE0, 0x61, 0xBE, 0x71, 0x9C, 0xDF, 0x60,
+  0x30, 0x49, 0x07 };
+
+const GFXglyph FreeSansPacked9pt7bGlyphs[] PROGMEM = {
+  {     0,   0,   0,   5,    0,    1 },   // 0x20 ' '
+  {     0,   2,  13,   6,    2,  -12 },   // 0x21 '!'
+  {     3,   5,   4,   6,    1,  -12 },   // 0x22 '"'
+  {     5,  10,  12,  10,    0,  -11 },   // 0x23 '#'
+  {    17,   9,  16,  10,    1,  -13 },   // 0x24 '$'
+  {    33,  16,  13,  16,    1,  -12 },   // 0x25 '%'
+  {    59,  11,  13,  12,    1,  -12 },   // 0x26 '&'
+  {    76,   2,   4,   4,    1,  -12 },   // 0x27 '''
+  {    77,   4,  17,   6,    1,  -12 },   // 0x28 '('
+  {    85,   4,  17,   6,    1,  -12 },   // 0x29 ')'
+  {    93,   5,   5,   7,    1,  -12 },   // 0x2A '*'
+  {    97,   6,   8,  11,    3,   -7 },   // 0x2B '+'
+  {   101,   2,   4,   5,    2,    0 },   // 0x2C ','
+  {   103,   4,   1,   6,    1,   -4 },   // 0x2D '-'
+  {   104,   2,   1,   5,    1,    0 },   // 0x2E '.'
+  {   105,   5,  13,   5,    0,  -12 },   // 0x2F '/'
+  {   110,   8,  13,  10,    1,  -12 },   // 0x30 '0'
+  {   119,   4,  13,  10,    3,  -12 },   // 0x31 '1'
+  {   123,   9,  13,  10,    1,  -12 },   // 0x32 '2'
+  {   137,   8,  13,  10,    1,  -12 },   // 0x33 '3'
+  {   150,   7,  13,  10,    2,  -12 },   // 0x34 '4'
+  {   158,   9,  13,  10,    1,  -12 },   // 0x35 '5'
+  {   170,   9,  13,  10,    1,  -12 },   // 0x36 '6'
+  {   183,   8,  13,  10,    0,  -12 },   // 0x37 '7'
+  {   195,   9,  13,  10,    1,  -12 },   // 0x38 '8'
+  {   207,   8,  13,  10,    1,  -12 },   // 0x39 '9'
+  {   219,   2,  10,   5,    1,   -9 },   // 0x3A ':'
+  {   221,   3,  12,   5,    1,   -8 },   // 0x3B ';'
+  {   225,   9,   9,  11,    1,   -8 },   // 0x3C '<'
+  {   236,   9,   4,  11,    1,   -5 },   // 0x3D '='
+  {   240,   9,   9,  11,    1,   -8 },   // 0x3E '>'
+  {   252,   9,  13,  10,    1,  -12 },   // 0x3F '?'
+  {   265,  17,  16,  18,    1,  -12 },   // 0x40 '@'
+  {   299,  12,  13,  12,    0,  -12 },   // 0x41 'A'
+  {   316,  11,  13,  12,    1,  -12 },   // 0x42 'B'
+  {   330,  11,  13,  13,    1,  -12 },   // 0x43 'C'
+  {   346,  11,  13,  13,    1,  -12 },   // 0x44 'D'
+  {   358,   9,  13,  11,    1,  -12 },   // 0x45 'E'
+  {   366,   8,  13,  11,    1,  -12 },   // 0x46 'F'
+  {   372,  12,  13,  14,    1,  -12 },   // 0x47 'G'
+  {   391,  11,  13,  13,    1,  -12 },   // 0x48 'H'
+  {   397,   2,  13,   5,    2,  -12 },   // 0x49 'I'
+  {   399,   7,  13,  10,    1,  -12 },   // 0x4A 'J'
+  {   405,  11,  13,  12,    1,  -12 },   // 0x4B 'K'
+  {   422,   8,  13,  10,    1,  -12 },   // 0x4C 'L'
+  {   426,  13,  13,  15,    1,  -12 },   // 0x4D 'M'
+  {   441,  11,  13,  13,    1,  -12 },   // 0x4E 'N'
+  {   457,  13,  13,  14,    1,  -12 },   // 0x4F 'O'
+  {   470,  10,  13,  12,    1,  -12 },   // 0x50 'P'
+  {   480,  13,  14,  14,    1,  -12 },   // 0x51 'Q'
+  {   497,  12,  13,  13,    1,  -12 },   // 0x52 'R'
+  {   511,  10,  13,  12,    1,  -12 },   // 0x53 'S'
+  {   527,   9,  13,  11,    1,  -12 },   // 0x54 'T'
+  {   531,  11,  13,  13,    1,  -12 },   // 0x55 'U'
+  {   537,  11,  13,  12,    0,  -12 },   // 0x56 'V'
+  {   557,  17,  13,  17,    0,  -12 },   // 0x57 'W'
+  {   582,  12,  13,  12,    0,  -12 },   // 0x58 'X'
+  {   602,  12,  13,  12,    0,  -12 },   // 0x59 'Y'
+  {   615,  10,  13,  11,    1,  -12 },   // 0x5A 'Z'
+  {   630,   3,  17,   5,    1,  -12 },   // 0x5B '['
+  {   634,   5,  13,   5,    0,  -12 },   // 0x5C '\'
+  {   639,   3,  17,   5,    0,  -12 },   // 0x5D ']'
+  {   643,   7,   7,   8,    1,  -12 },   // 0x5E '^'
+  {   650,  10,   1,  10,    0,    3 },   // 0x5F '_'
+  {   652,   4,   3,   5,    0,  -12 },   // 0x60 '`'
+  {   654,   9,  10,  10,    1,   -9 },   // 0x61 'a'
+  {   666,   9,  13,  10,    1,  -12 },   // 0x62 'b'
+  {   675,   8,  10,   9,    1,   -9 },   // 0x63 'c'
+  {   684,   8,  13,  10,    1,  -12 },   // 0x64 'd'
+  {   692,   8,  10,  10,    1,   -9 },   // 0x65 'e'
+  {   702,   4,  13,   5,    1,  -12 },   // 0x66 'f'
+  {   706,   8,  14,  10,    1,   -9 },   // 0x67 'g'
+  {   716,   8,  13,  10,    1,  -12 },   // 0x68 'h'
+  {   722,   2,  13,   4,    1,  -12 },   // 0x69 'i'
+  {   725,   4,  17,   4,    0,  -12 },   // 0x6A 'j'
+  {   730,   9,  13,   9,    1,  -12 },   // 0x6B 'k'
+  {   743,   2,  13,   4,    1,  -12 },   // 0x6C 'l'
+  {   745,  13,  10,  15,    1,   -9 },   // 0x6D 'm'
+  {   752,   8,  10,  10,    1,   -9 },   // 0x6E 'n'
+  {   757,   8,  10,  10,    1,   -9 },   // 0x6F 'o'
+  {   764,   9,  13,  10,    1,   -9 },   // 0x70 'p'
+  {   773,   8,  13,  10,    1,   -9 },   // 0x71 'q'
+  {   781,   5,  10,   6,    1,   -9 },   // 0x72 'r'
+  {   785,   8,  10,   9,    1,   -9 },   // 0x73 's'
+  {   796,   4,  12,   5,    1,  -11 },   // 0x74 't'
+  {   800,   8,  10,  10,    1,   -9 },   // 0x75 'u'
+  {   805,   9,  10,   9,    0,   -9 },   // 0x76 'v'
+  {   818,  13,  10,  13,    0,   -9 },   // 0x77 'w'
+  {   836,   8,  10,   9,    0,   -9 },   // 0x78 'x'
+  {   848,   9,  14,   9,    0,   -9 },   // 0x79 'y'
+  {   863,   7,  10,   9,    1,   -9 },   // 0x7A 'z'
+  {   873,   4,  17,   6,    1,  -12 },   // 0x7B '{'
+  {   879,   2,  17,   4,    2,  -12 },   // 0x7C '|'
+  {   882,   4,  17,   6,    1,  -12 },   // 0x7D '}'
+  {   888,   7,   3,   9,    1,   -7 } }; // 0x7E '~'
+
+const GFXfont FreeSansPacked9pt7b PROGMEM = {
+  (uint8_t  *)FreeSansPacked9pt7bBitmaps,
+  (GFXglyph *)FreeSansPacked9pt7bGlyphs,
+  0x20, 0x7E, 22, GFX_BITMAP_RLE,
+  NULL, NULL, 0 };
+
+// Approx. 1563 bytes
+// Bitmaps 891 bytes packed, 1150 bytes plain
@@ -754,6 +754,7 @@ const GFXglyph FreeSerifBold24pt7bGlyphs[] PROGMEM = {
 const GFXfont FreeSerifBold24pt7b PROGMEM = {
   (uint8_t  *)FreeSerifBold24pt7bBitmaps,
   (GFXglyph *)FreeSerifBold24pt7bGlyphs,
-  0x20, 0x7E, 56 };
+  0x20, 0x7E, 56, GFX_BITMAP_PLAIN,
+  NULL, NULL, 0 };
 
 // Approx. 8519 bytes
@@ -287,6 +287,7 @@ const GFXglyph FreeSerifBoldItalic12pt7bGlyphs[] PROGMEM = {
 const GFXfont FreeSerifBoldItalic12pt7b PROGMEM = {
   (uint8_t  *)FreeSerifBoldItalic12pt7bBitmaps,
   (GFXglyph *)FreeSerifBoldItalic12pt7bGlyphs,
-  0x20, 0x7E, 29 };
+  0x20, 0x7E, 29, GFX_BITMAP_PLAIN,
+  NULL, NULL, 0 };
 
 // Approx. 2910 bytes
@@ -788,6 +788,7 @@ const GFXglyph FreeSerifBoldItalic24pt7bGlyphs[] PROGMEM = {
 const GFXfont FreeSerifBoldItalic24pt7b PROGMEM = {
   (uint8_t  *)FreeSerifBoldItalic24pt7bBitmaps,
   (GFXglyph *)FreeSerifBoldItalic24pt7bGlyphs,
-  0x20, 0x7E, 56 };
+  0x20, 0x7E, 56, GFX_BITMAP_PLAIN,
+  NULL, NULL, 0 };
 
 // Approx. 8917 bytes
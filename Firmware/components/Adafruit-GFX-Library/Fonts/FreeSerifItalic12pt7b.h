@@ -266,6 +266,7 @@ const GFXglyph FreeSerifItalic12pt7bGlyphs[] PROGMEM = {
 const GFXfont FreeSerifItalic12pt7b PROGMEM = {
   (uint8_t  *)FreeSerifItalic12pt7bBitmaps,
   (GFXglyph *)FreeSerifItalic12pt7bGlyphs,
-  0x20, 0x7E, 29 };
+  0x20, 0x7E, 29, GFX_BITMAP_PLAIN,
+  NULL, NULL, 0 };
 
 // Approx. 2656 bytes
@@ -126,6 +126,7 @@ const GFXglyph Org_01Glyphs[] PROGMEM = {
 const GFXfont Org_01 PROGMEM = {
   (uint8_t  *)Org_01Bitmaps,
   (GFXglyph *)Org_01Glyphs,
-  0x20, 0x7E, 7 };
+  0x20, 0x7E, 7, GFX_BITMAP_PLAIN,
+  NULL, NULL, 0 };
 
 // Approx. 943 bytes
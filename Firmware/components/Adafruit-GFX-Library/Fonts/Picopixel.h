@@ -118,6 +118,7 @@ const GFXglyph PicopixelGlyphs[] PROGMEM = {
 const GFXfont Picopixel PROGMEM = {
   (uint8_t  *)PicopixelBitmaps,
   (GFXglyph *)PicopixelGlyphs,
-  0x20, 0x7E, 7 };
+  0x20, 0x7E, 7, GFX_BITMAP_PLAIN,
+  NULL, NULL, 0 };
 
 // Approx. 852 bytes
@@ -0,0 +1,211 @@
+/*
+Host benchmark of the rendering core (gfxcore.h) against Adafruit_GFX.
+
+Every case draws a fixed sequence of primitives (seeded generator, same on
+every run and platform) once through the virtual functions of a GFXcanvas1,
+8 and 16 and once through the GFXcore target of the same buffer layout.
+Both draw into a 128x64 buffer, the size of the SSD1306 panel.  The two
+are timed in turns, the best round of each counts, so a disturbance of
+the host hits both sides alike.  Afterwards the buffers are compared.
+
+Output is CSV on stdout, one line per case:
+  case,virtual_ns_per_op,core_ns_per_op,speedup,same
+'same' is 1 if both buffers are equal.  The exit code is 1 if any of them
+differs.
+
+usage: corebench [rounds]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define PROGMEM
+#include "../Adafruit_GFX.h"
+#include "../gfxcore.h"
+#include "../Fonts/FreeSans9pt7b.h"
+
+#define WIDTH  128
+#define HEIGHT 64
+#define OPS    256 // Operations per sequence
+#define PASSES 16  // Sequences per round
+
+// xorshift32, independent of the C library
+static uint32_t seed;
+static uint32_t rnd32(void) {
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+  return seed;
+}
+static int16_t rnd(int16_t lo, int16_t hi) {
+  return lo + (int16_t)(rnd32() % (uint32_t)(hi - lo + 1));
+}
+
+struct Args {
+  int16_t a, b, c, d, e, f;
+  uint16_t color, bg;
+};
+static Args args[OPS];
+
+// Mostly on screen, some primitives cross the edges. 'colors' is the
+// number of colors of the buffer, e.g. 2 for GFXcanvas1.
+static void makeArgs(uint32_t colors) {
+  seed = 0x1306;
+  for(int i=0; i<OPS; i++) {
+    Args &a = args[i];
+    a.a     = rnd(-8, WIDTH + 8);
+    a.b     = rnd(-8, HEIGHT + 8);
+    a.c     = rnd(-8, WIDTH + 8);
+    a.d     = rnd(-8, HEIGHT + 8);
+    a.e     = rnd(1, 30);
+    a.f     = rnd(1, 94);
+    a.color = rnd32() % colors;
+    a.bg    = (uint16_t)((a.color + colors / 2) % colors);
+  }
+}
+
+// The primitives are templates, G is Adafruit_GFX for the virtual calls or
+// one of the GFXcore targets
+template <class G> static void opLine(G &gfx, const Args &a) {
+  gfx.drawLine(a.a, a.b, a.c, a.d, a.color);
+}
+template <class G> static void opCircle(G &gfx, const Args &a) {
+  gfx.drawCircle(a.a, a.b, a.e, a.color);
+}
+template <class G> static void opFillCircle(G &gfx, const Args &a) {
+  gfx.fillCircle(a.a, a.b, a.e, a.color);
+}
+template <class G> static void opFillTriangle(G &gfx, const Args &a) {
+  gfx.fillTriangle(a.a, a.b, a.c, a.d, a.e, a.f, a.color);
+}
+// GFXcanvas8::writeFastHLine() doesn't take negative widths
+template <class G> static void opRoundRect(G &gfx, const Args &a) {
+  gfx.drawRoundRect(a.a, a.b, 2 * a.e + 8, a.e + 8, a.e / 2, a.color);
+}
+template <class G> static void opChar(G &gfx, const Args &a) {
+  gfx.drawChar(a.a, a.b, ' ' + a.f, a.color, a.color, 1);
+}
+template <class G> static void opCharBg(G &gfx, const Args &a) {
+  gfx.drawChar(a.a, a.b, ' ' + a.f, a.color, a.bg, 1);
+}
+template <class G> static void opCharSize2(G &gfx, const Args &a) {
+  gfx.drawChar(a.a, a.b, ' ' + a.f, a.color, a.color, 2);
+}
+
+// Buffers of both sides and the targets of the core on them
+static GFXcanvas1  canvas1(WIDTH, HEIGHT);
+static GFXcanvas8  canvas8(WIDTH, HEIGHT);
+static GFXcanvas16 canvas16(WIDTH, HEIGHT);
+static uint8_t     buffer1[(WIDTH + 7) / 8 * HEIGHT];
+static uint8_t     buffer8[WIDTH * HEIGHT];
+static uint16_t    buffer16[WIDTH * HEIGHT];
+static GFXcoreCanvas1  core1(buffer1, WIDTH, HEIGHT);
+static GFXcoreCanvas8  core8(buffer8, WIDTH, HEIGHT);
+static GFXcoreCanvas16 core16(buffer16, WIDTH, HEIGHT);
+
+struct Case {
+  const char    *name;
+  const GFXfont *font;
+  uint32_t       colors;
+  Adafruit_GFX  *canvas;
+  void         (*runVirtual)(Adafruit_GFX &gfx);
+  void         (*setupCore)(const GFXfont *font);
+  void         (*runCore)(void);
+  const void    *virtualBuffer;
+  const void    *coreBuffer;
+  size_t         size;
+};
+
+template <void (*Op)(Adafruit_GFX &, const Args &)>
+static void runVirtual(Adafruit_GFX &gfx) {
+  for(int i=0; i<OPS; i++) Op(gfx, args[i]);
+}
+
+template <class Core, Core *core, void (*Op)(Core &, const Args &)>
+static void runCore(void) {
+  for(int i=0; i<OPS; i++) Op(*core, args[i]);
+}
+
+template <class Core, Core *core>
+static void setupCore(const GFXfont *font) {
+  core->setFont(font);
+  core->fillScreen(0);
+}
+
+#define CASES(layout, colors, canvas, core, buffer, Core)                     \
+  { layout "_writeLine", NULL, colors, &canvas,                               \
+    runVirtual<opLine>, setupCore<Core, &core>,                               \
+    runCore<Core, &core, opLine>, canvas.getBuffer(), buffer, sizeof(buffer) }, \
+  { layout "_drawCircle", NULL, colors, &canvas,                              \
+    runVirtual<opCircle>, setupCore<Core, &core>,                             \
+    runCore<Core, &core, opCircle>, canvas.getBuffer(), buffer, sizeof(buffer) }, \
+  { layout "_fillCircle", NULL, colors, &canvas,                              \
+    runVirtual<opFillCircle>, setupCore<Core, &core>,                         \
+    runCore<Core, &core, opFillCircle>, canvas.getBuffer(), buffer, sizeof(buffer) }, \
+  { layout "_fillTriangle", NULL, colors, &canvas,                            \
+    runVirtual<opFillTriangle>, setupCore<Core, &core>,                       \
+    runCore<Core, &core, opFillTriangle>, canvas.getBuffer(), buffer, sizeof(buffer) }, \
+  { layout "_drawRoundRect", NULL, colors, &canvas,                           \
+    runVirtual<opRoundRect>, setupCore<Core, &core>,                          \
+    runCore<Core, &core, opRoundRect>, canvas.getBuffer(), buffer, sizeof(buffer) }, \
+  { layout "_drawChar_classic", NULL, colors, &canvas,                        \
+    runVirtual<opChar>, setupCore<Core, &core>,                               \
+    runCore<Core, &core, opChar>, canvas.getBuffer(), buffer, sizeof(buffer) }, \
+  { layout "_drawChar_classic_bg", NULL, colors, &canvas,                     \
+    runVirtual<opCharBg>, setupCore<Core, &core>,                             \
+    runCore<Core, &core, opCharBg>, canvas.getBuffer(), buffer, sizeof(buffer) }, \
+  { layout "_drawChar_classic_x2", NULL, colors, &canvas,                     \
+    runVirtual<opCharSize2>, setupCore<Core, &core>,                          \
+    runCore<Core, &core, opCharSize2>, canvas.getBuffer(), buffer, sizeof(buffer) }, \
+  { layout "_drawChar_FreeSans9", &FreeSans9pt7b, colors, &canvas,            \
+    runVirtual<opChar>, setupCore<Core, &core>,                               \
+    runCore<Core, &core, opChar>, canvas.getBuffer(), buffer, sizeof(buffer) }
+
+static const Case cases[] = {
+  CASES("canvas1",  2,       canvas1,  core1,  buffer1,  GFXcoreCanvas1),
+  CASES("canvas8",  256,     canvas8,  core8,  buffer8,  GFXcoreCanvas8),
+  CASES("canvas16", 65536,   canvas16, core16, buffer16, GFXcoreCanvas16),
+};
+
+static double now(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+int main(int argc, char *argv[]) {
+  int  rounds = (argc > 1) ? atoi(argv[1]) : 20;
+  bool failed = false;
+
+  printf("case,virtual_ns_per_op,core_ns_per_op,speedup,same\n");
+  for(size_t c=0; c<sizeof(cases)/sizeof(cases[0]); c++) {
+    const Case &tc = cases[c];
+    makeArgs(tc.colors);
+    tc.canvas->setFont(tc.font);
+    tc.canvas->fillScreen(0);
+    tc.setupCore(tc.font);
+
+    double bestVirtual = 1e30, bestCore = 1e30;
+    for(int r=0; r<rounds; r++) {
+      double start = now();
+      for(int p=0; p<PASSES; p++) tc.runVirtual(*tc.canvas);
+      double elapsed = now() - start;
+      if(elapsed < bestVirtual) bestVirtual = elapsed;
+
+      start = now();
+      for(int p=0; p<PASSES; p++) tc.runCore();
+      elapsed = now() - start;
+      if(elapsed < bestCore) bestCore = elapsed;
+    }
+
+    bool same = !memcmp(tc.virtualBuffer, tc.coreBuffer, tc.size);
+    failed |= !same;
+    double nsVirtual = bestVirtual / (PASSES * OPS);
+    double nsCore    = bestCore / (PASSES * OPS);
+    printf("%s,%.1f,%.1f,%.2f,%d\n", tc.name, nsVirtual, nsCore,
+      (nsCore > 0) ? nsVirtual / nsCore : 0.0, same);
+  }
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,386 @@
+/*
+Host benchmark for the Adafruit_GFX primitives.
+
+Every case draws a fixed sequence of primitives (seeded generator, same on
+every run and platform) into a 128x64 GFXcanvas1, the size of the SSD1306
+panel.  A first pass counts the pixels written per operation, then the
+sequence is repeated for at least the given time.  The bulk operations of
+GFXcanvas1 are paired with a '_pixels' case doing the same per pixel.
+
+Output is CSV on stdout, one line per case:
+  case,ops,ns_per_op,pixels_per_op,mpixels_per_s
+The first column is stable, so results of two builds can be joined on it.
+The flash size of FreeSans9pt7b and of its subset (the '_subset' cases)
+goes to stderr.  The '_utf8' cases print the text with a degree sign, for
+the custom font it is an extra code point (see gfxfont.h).  The '_packed'
+cases draw FreeSansPacked9pt7b, the glyphs of FreeSans9pt7b in the
+GFX_BITMAP_RLE format, the bitmap bytes of both go to stderr as well.  The '_cached'
+cases measure the text with a text cache attached, i.e. every call is a hit.
+
+usage: gfxbench [min_ms_per_case]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define PROGMEM
+#include "../Adafruit_GFX.h"
+#include "../Fonts/FreeSans9pt7b.h"
+#include "../Fonts/FreeSansPacked9pt7b.h"
+#include "../Fonts/FreeSansBold18pt7b.h"
+#include "../Fonts/TomThumb.h"
+
+#define WIDTH  128
+#define HEIGHT 64
+#define OPS    256 // Operations per sequence
+
+// Counts the pixels that reach the canvas, the generic primitives of
+// Adafruit_GFX end up in drawPixel. Only used for the counting pass.
+class CountingCanvas : public Adafruit_GFX {
+ public:
+  CountingCanvas(void) : Adafruit_GFX(WIDTH, HEIGHT), pixels(0) { }
+  void drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if((x >= 0) && (y >= 0) && (x < _width) && (y < _height)) pixels++;
+  }
+  uint32_t pixels;
+};
+
+// xorshift32, independent of the C library
+static uint32_t seed;
+static int16_t rnd(int16_t lo, int16_t hi) {
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+  return lo + (int16_t)(seed % (uint32_t)(hi - lo + 1));
+}
+
+struct Args {
+  int16_t a, b, c, d, e, f;
+  uint16_t color;
+};
+static Args args[OPS];
+
+static const uint8_t icon[] = { // 16x16
+  0x07, 0xE0, 0x18, 0x18, 0x20, 0x04, 0x40, 0x02, 0x4C, 0x32, 0x8C, 0x31,
+  0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x88, 0x11, 0x84, 0x21, 0x43, 0xC2,
+  0x40, 0x02, 0x20, 0x04, 0x18, 0x18, 0x07, 0xE0 };
+
+static uint8_t image[64 / 8 * 32]; // 64x32, random content
+
+static const char *text = "T = 21.5 C RH= 45.0 %";
+static const char *utf8Text = "T = 21.5 °C RH= 45.0 %";
+
+// Subset of FreeSans9pt7b with the characters of 'text', the layout of
+// fontconvert -s. Built at start, the bitmaps are shared with the full font.
+static GFXglyph sansSubGlyphs[96];
+static uint8_t  sansSubIndex[2 * 12];
+static GFXfont  sansSub;
+
+// Returns the approx. flash size of the subset, like fontconvert reports it
+static uint32_t makeSubset(const GFXfont &full, const char *chars) {
+  uint8_t  first = 0xFF, last = 0;
+  uint32_t size  = 0;
+  for(const char *c=chars; *c; c++) {
+    if((uint8_t)*c < first) first = *c;
+    if((uint8_t)*c > last)  last  = *c;
+  }
+  memset(sansSubIndex, 0, sizeof(sansSubIndex));
+  for(const char *c=chars; *c; c++) {
+    uint8_t k = *c - first;
+    sansSubIndex[(k >> 3) * 2 + 1] |= 1 << (k & 7);
+  }
+  uint16_t n = 0;
+  for(uint16_t g=0; g<=(uint16_t)(last - first) / 8; g++) {
+    sansSubIndex[g * 2] = n;
+    for(uint8_t b=0; b<8; b++) {
+      if(!(sansSubIndex[g * 2 + 1] & (1 << b))) continue;
+      const GFXglyph &glyph = full.glyph[g * 8 + b + first - full.first];
+      sansSubGlyphs[n++] = glyph;
+      size += (glyph.width * glyph.height + 7) / 8 + 7;
+    }
+  }
+  sansSub = full;
+  sansSub.glyph = sansSubGlyphs;
+  sansSub.first = first;
+  sansSub.last  = last;
+  sansSub.index = sansSubIndex;
+  return size + 7 + ((last - first) / 8 + 1) * 2;
+}
+
+// FreeSans9pt7b with U+00B0 as extra code point, a raised 'o' stands in
+// for the degree sign the font lacks
+static GFXglyph    sansDegGlyphs[96];
+static GFXcodePage sansDegPage = { 0x00, 0xB0, 0xB0, 95, NULL };
+static GFXfont     sansDeg;
+
+static void makeDegree(const GFXfont &full) {
+  memcpy(sansDegGlyphs, full.glyph, 95 * sizeof(GFXglyph));
+  sansDegGlyphs[95] = full.glyph['o' - full.first];
+  sansDegGlyphs[95].yOffset -= 6;
+  sansDeg = full;
+  sansDeg.glyph     = sansDegGlyphs;
+  sansDeg.pages     = &sansDegPage;
+  sansDeg.pageCount = 1;
+}
+
+static uint32_t fontSize(const GFXfont &font) {
+  uint32_t size = 7;
+  for(uint16_t g=0; g<gfxFontGlyphCount(&font); g++) {
+    size += (font.glyph[g].width * font.glyph[g].height + 7) / 8 + 7;
+  }
+  return size;
+}
+
+// Source of the copy cases and buffer of the timed canvas
+static GFXcanvas1 source(WIDTH, HEIGHT);
+static GFXcanvas1 target(WIDTH, HEIGHT);
+static uint8_t    pages[WIDTH * HEIGHT / 8];
+
+static inline uint8_t pixel(const uint8_t *buf, uint16_t bpl, int16_t x,
+  int16_t y) {
+  return (buf[y * bpl + x / 8] >> (7 - (x & 7))) & 1;
+}
+
+typedef void (*Op)(Adafruit_GFX &gfx, const Args &a);
+
+static void opLine(Adafruit_GFX &gfx, const Args &a) {
+  gfx.drawLine(a.a, a.b, a.c, a.d, a.color);
+}
+// Same lines stretched to 7 times their length, mostly off screen
+static void opLongLine(Adafruit_GFX &gfx, const Args &a) {
+  gfx.drawLine(a.a - 3 * (a.c - a.a), a.b - 3 * (a.d - a.b),
+               a.c + 3 * (a.c - a.a), a.d + 3 * (a.d - a.b), a.color);
+}
+static void opDiagonal(Adafruit_GFX &gfx, const Args &a) {
+  gfx.drawLine(a.a, a.b, a.a + a.f, a.b + ((a.e & 1) ? a.f : -a.f), a.color);
+}
+static void opCircle(Adafruit_GFX &gfx, const Args &a) {
+  gfx.drawCircle(a.a, a.b, a.e, a.color);
+}
+static void opFillCircle(Adafruit_GFX &gfx, const Args &a) {
+  gfx.fillCircle(a.a, a.b, a.e, a.color);
+}
+static void opFillTriangle(Adafruit_GFX &gfx, const Args &a) {
+  gfx.fillTriangle(a.a, a.b, a.c, a.d, a.e, a.f, a.color);
+}
+static void opFillRoundRect(Adafruit_GFX &gfx, const Args &a) {
+  gfx.fillRoundRect(a.a, a.b, a.c, a.d, a.e / 2, a.color);
+}
+static void opBitmap(Adafruit_GFX &gfx, const Args &a) {
+  gfx.drawBitmap(a.a, a.b, icon, 16, 16, a.color);
+}
+static void opBitmapBg(Adafruit_GFX &gfx, const Args &a) {
+  gfx.drawBitmap(a.a, a.b, icon, 16, 16, a.color, !a.color);
+}
+static void opChar(Adafruit_GFX &gfx, const Args &a) {
+  gfx.drawChar(a.a, a.b, ' ' + a.f, a.color, a.color, 1);
+}
+static void opCharBg(Adafruit_GFX &gfx, const Args &a) {
+  gfx.drawChar(a.a, a.b, ' ' + a.f, a.color, !a.color, 1);
+}
+static void opCharSize2(Adafruit_GFX &gfx, const Args &a) {
+  gfx.drawChar(a.a, a.b, ' ' + a.f, a.color, a.color, 2);
+}
+static void opPrint(Adafruit_GFX &gfx, const Args &a) {
+  gfx.setCursor(a.a, a.b);
+  gfx.setTextColor(a.color);
+  gfx.print(text);
+}
+static void opPrintUtf8(Adafruit_GFX &gfx, const Args &a) {
+  gfx.setCursor(a.a, a.b);
+  gfx.setTextColor(a.color);
+  gfx.utf8();
+  gfx.print(utf8Text);
+  gfx.utf8(false);
+}
+static void opPrintSize2(Adafruit_GFX &gfx, const Args &a) {
+  gfx.setTextSize(2);
+  opPrint(gfx, a);
+  gfx.setTextSize(1);
+}
+static void opTextBounds(Adafruit_GFX &gfx, const Args &a) {
+  int16_t  x1, y1;
+  uint16_t w, h;
+  gfx.getTextBounds(text, a.a, a.b, &x1, &y1, &w, &h);
+}
+static GFXtextBounds textCache[4];
+static void opTextBoundsCached(Adafruit_GFX &gfx, const Args &a) {
+  opTextBounds(gfx, a);
+}
+
+// Bulk operations of GFXcanvas1, always on the timed canvas, the counting
+// pass uses the per pixel variant. Rectangles are inside of the canvas.
+static void opFillRect(Adafruit_GFX &gfx, const Args &a) {
+  target.fillRect(a.a, a.b, a.c, a.d, a.color);
+}
+static void opFillRectPixels(Adafruit_GFX &gfx, const Args &a) {
+  for(int16_t y=a.b; y<a.b+a.d; y++)
+    for(int16_t x=a.a; x<a.a+a.c; x++) gfx.drawPixel(x, y, a.color);
+}
+static void opInvertRect(Adafruit_GFX &gfx, const Args &a) {
+  target.invertRect(a.a, a.b, a.c, a.d);
+}
+static void opInvertRectPixels(Adafruit_GFX &gfx, const Args &a) {
+  const uint8_t *buf = target.getBuffer();
+  for(int16_t y=a.b; y<a.b+a.d; y++)
+    for(int16_t x=a.a; x<a.a+a.c; x++)
+      gfx.drawPixel(x, y, !pixel(buf, WIDTH / 8, x, y));
+}
+static void opBlit(Adafruit_GFX &gfx, const Args &a) {
+  target.blit(a.a, a.b, image, 64, 32);
+}
+static void opBlitPixels(Adafruit_GFX &gfx, const Args &a) {
+  gfx.drawBitmap(a.a, a.b, image, 64, 32, 1, 0);
+}
+static void opCopyRect(Adafruit_GFX &gfx, const Args &a) {
+  target.copyRect(source, a.e, a.f % HEIGHT, a.c, a.d, a.a, a.b);
+}
+static void opCopyRectPixels(Adafruit_GFX &gfx, const Args &a) {
+  const uint8_t *buf = source.getBuffer();
+  for(int16_t y=0; y<a.d; y++)
+    for(int16_t x=0; x<a.c; x++) {
+      int16_t sx = a.e + x, sy = a.f % HEIGHT + y;
+      if((sx < WIDTH) && (sy < HEIGHT))
+        gfx.drawPixel(a.a + x, a.b + y, pixel(buf, WIDTH / 8, sx, sy));
+    }
+}
+static void opToPages(Adafruit_GFX &gfx, const Args &a) {
+  target.copyToPages(pages);
+}
+static void opToPagesPixels(Adafruit_GFX &gfx, const Args &a) {
+  const uint8_t *buf = target.getBuffer();
+  memset(pages, 0, sizeof(pages));
+  for(int16_t y=0; y<HEIGHT; y++)
+    for(int16_t x=0; x<WIDTH; x++)
+      if(pixel(buf, WIDTH / 8, x, y)) pages[(y / 8) * WIDTH + x] |= 1 << (y & 7);
+}
+static void opCountPage(Adafruit_GFX &gfx, const Args &a) {
+  gfx.fillRect(0, 0, WIDTH, HEIGHT, 1);
+}
+
+struct Case {
+  const char    *name;
+  Op             op;
+  const GFXfont *font;
+  Op             count;  // Counting pass, NULL: op
+  bool           inside; // Primitives don't cross the edges
+};
+
+static const Case cases[] = {
+  { "writeLine",                 opLine,             NULL,                NULL,               false },
+  { "writeLine_long",            opLongLine,         NULL,                NULL,               false },
+  { "writeLine_diagonal",        opDiagonal,         NULL,                NULL,               false },
+  { "drawCircle",                opCircle,           NULL,                NULL,               false },
+  { "fillCircle",                opFillCircle,       NULL,                NULL,               false },
+  { "fillTriangle",              opFillTriangle,     NULL,                NULL,               false },
+  { "fillRoundRect",             opFillRoundRect,    NULL,                NULL,               false },
+  { "drawBitmap",                opBitmap,           NULL,                NULL,               false },
+  { "drawBitmap_bg",             opBitmapBg,         NULL,                NULL,               false },
+  { "drawChar_classic",          opChar,             NULL,                NULL,               false },
+  { "drawChar_classic_bg",       opCharBg,           NULL,                NULL,               false },
+  { "drawChar_classic_x2",       opCharSize2,        NULL,                NULL,               false },
+  { "drawChar_TomThumb",         opChar,             &TomThumb,           NULL,               false },
+  { "drawChar_FreeSans9",        opChar,             &FreeSans9pt7b,      NULL,               false },
+  { "drawChar_FreeSans9_packed", opChar,            &FreeSansPacked9pt7b, NULL,             false },
+  { "drawChar_FreeSansB18",      opChar,             &FreeSansBold18pt7b, NULL,               false },
+  { "print_classic",             opPrint,            NULL,                NULL,               false },
+  { "print_classic_x2",          opPrintSize2,       NULL,                NULL,               false },
+  { "print_classic_utf8",        opPrintUtf8,        NULL,                NULL,               false },
+  { "print_FreeSans9",           opPrint,            &FreeSans9pt7b,      NULL,               false },
+  { "print_FreeSans9_packed",    opPrint,            &FreeSansPacked9pt7b, NULL,             false },
+  { "print_FreeSans9_subset",    opPrint,            &sansSub,            NULL,               false },
+  { "print_FreeSans9_utf8",      opPrintUtf8,        &sansDeg,            NULL,               false },
+  { "getTextBounds_classic",     opTextBounds,       NULL,                NULL,               false },
+  { "getTextBounds_Sans9",       opTextBounds,       &FreeSans9pt7b,      NULL,               false },
+  { "getTextBounds_Sans9_subset", opTextBounds,      &sansSub,            NULL,               false },
+  { "getTextBounds_classic_cached", opTextBoundsCached, NULL,             NULL,               false },
+  { "getTextBounds_Sans9_cached", opTextBoundsCached, &FreeSans9pt7b,     NULL,               false },
+  { "canvas1_fillRect",          opFillRect,         NULL,                opFillRectPixels,   true },
+  { "canvas1_fillRect_pixels",   opFillRectPixels,   NULL,                NULL,               true },
+  { "canvas1_invertRect",        opInvertRect,       NULL,                opInvertRectPixels, true },
+  { "canvas1_invertRect_pixels", opInvertRectPixels, NULL,                NULL,               true },
+  { "canvas1_blit",              opBlit,             NULL,                opBlitPixels,       true },
+  { "canvas1_blit_pixels",       opBlitPixels,       NULL,                NULL,               true },
+  { "canvas1_copyRect",          opCopyRect,         NULL,                opCopyRectPixels,   true },
+  { "canvas1_copyRect_pixels",   opCopyRectPixels,   NULL,                NULL,               true },
+  { "canvas1_toPages",           opToPages,          NULL,                opCountPage,        true },
+  { "canvas1_toPages_pixels",    opToPagesPixels,    NULL,                opCountPage,        true },
+};
+
+static double now(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+static void makeArgs(uint32_t s, bool inside) {
+  seed = s;
+  for(int i=0; i<OPS; i++) {
+    Args &a = args[i];
+    if(inside) {
+      a.a     = rnd(0, WIDTH - 64);
+      a.b     = rnd(0, HEIGHT - 32);
+      a.c     = rnd(1, 64);
+      a.d     = rnd(1, 32);
+      a.e     = rnd(0, WIDTH - 1);
+      a.f     = rnd(0, HEIGHT - 1);
+      a.color = rnd(0, 1);
+      continue;
+    }
+    // Mostly on screen, some primitives cross the edges
+    a.a     = rnd(-8, WIDTH + 8);
+    a.b     = rnd(-8, HEIGHT + 8);
+    a.c     = rnd(-8, WIDTH + 8);
+    a.d     = rnd(-8, HEIGHT + 8);
+    a.e     = rnd(1, 30);
+    a.f     = rnd(1, 94);
+    a.color = rnd(0, 1);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  double minNs = ((argc > 1) ? atof(argv[1]) : 200.0) * 1e6;
+  CountingCanvas canvas;
+
+  seed = 0x1306;
+  for(size_t i=0; i<sizeof(image); i++) image[i] = rnd(0, 255);
+  for(size_t i=0; i<WIDTH / 8 * HEIGHT; i++) source.getBuffer()[i] = rnd(0, 255);
+  uint32_t subSize = makeSubset(FreeSans9pt7b, " %.0123456789=CHRT");
+  makeDegree(FreeSans9pt7b);
+  fprintf(stderr, "FreeSans9pt7b approx. %u bytes, subset of %u glyphs %u bytes\n",
+    (unsigned)fontSize(FreeSans9pt7b), (unsigned)gfxFontGlyphCount(&sansSub),
+    (unsigned)subSize);
+  fprintf(stderr, "FreeSans9pt7b bitmaps %u bytes plain, %u bytes packed\n",
+    (unsigned)sizeof(FreeSans9pt7bBitmaps), (unsigned)sizeof(FreeSansPacked9pt7bBitmaps));
+
+  printf("case,ops,ns_per_op,pixels_per_op,mpixels_per_s\n");
+  for(size_t c=0; c<sizeof(cases)/sizeof(cases[0]); c++) {
+    const Case &tc = cases[c];
+    makeArgs(0x1306, tc.inside);
+    canvas.setFont(tc.font);
+    canvas.setTextWrap(false);
+    target.setFont(tc.font);
+    target.setTextWrap(false);
+    target.setTextCache((tc.op == opTextBoundsCached) ? textCache : NULL, 4);
+    target.fillScreen(0);
+
+    canvas.pixels = 0;
+    for(int i=0; i<OPS; i++) (tc.count ? tc.count : tc.op)(canvas, args[i]);
+    double pixels = (double)canvas.pixels / OPS;
+
+    uint32_t ops   = 0;
+    double   start = now(), elapsed;
+    do {
+      for(int i=0; i<OPS; i++) tc.op(target, args[i]);
+      ops    += OPS;
+      elapsed = now() - start;
+    } while(elapsed < minNs);
+
+    double ns = elapsed / ops;
+    printf("%s,%u,%.1f,%.1f,%.2f\n", tc.name, ops, ns, pixels,
+      (ns > 0) ? pixels * 1e3 / ns : 0.0);
+  }
+  return 0;
+}
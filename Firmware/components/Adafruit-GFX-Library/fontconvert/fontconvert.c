@@ -8,16 +8,35 @@ fonts to be used with the Adafruit_GFX Arduino library.
 For UNIX-like systems.  Outputs to stdout; redirect to header file, e.g.:
   ./fontconvert ~/Library/Fonts/FreeSans.ttf 18 > FreeSans18pt7b.h
 
+With -c as first argument the glyph bitmaps are emitted in the packed
+GFX_BITMAP_RLE format (see gfxglyphruns.h), which saves about a third of
+the bitmap flash at 18pt and close to half at 24pt.  Tiny fonts may grow,
+the size of both formats is reported at the end of the output.
+
+-s chars and -f file (both may be repeated) emit a subset font that has
+glyphs only for the given characters, or for the characters in the string
+and character literals of a source file.  Characters between 'first' and
+'last' without a glyph take no flash, the font gets a sparse index instead
+(see gfxfont.h).  Numbers printed at run time have to be added with -s,
+e.g. for the status screen:
+  ./fontconvert -f ../../Devices/MyDisplay.cpp -s "0123456789.-" \
+    FreeSans.ttf 9 > FreeSans9pt8bSub.h
+
+-u codes adds code points beyond 'first' and 'last', a comma separated
+list like 0xB0,0x2103.  Characters of -s and -f are read as UTF-8, so a
+"°C" in a source file adds the degree sign as well.  These extra glyphs
+follow the others and are found by page of 256 code points (see gfxfont.h).
+
 REQUIRES FREETYPE LIBRARY.  www.freetype.org
 
-Currently this only extracts the printable 7-bit ASCII chars of a font.
-Will eventually extend with some int'l chars a la ftGFX, not there yet.
-Keep 7-bit fonts around as an option in that case, more compact.
+By default this extracts the printable 7-bit ASCII chars of a font.
 
 See notes at end for glyph nomenclature & other tidbits.
 */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <ctype.h>
 #include <stdint.h>
 #include <ft2build.h>
@@ -46,6 +65,200 @@ void enbit(uint8_t value) {
 	}
 }
 
+// Bits of the glyph image, plain row-major as FreeType renders them
+static int pixel(FT_Bitmap *bitmap, int x, int y) {
+	return bitmap->buffer[y * bitmap->pitch + x / 8] & (0x80 >> (x & 7));
+}
+
+static int sameRow(FT_Bitmap *bitmap, int y0, int y1) {
+	int x;
+	for(x=0; x < bitmap->width; x++) {
+		if(!pixel(bitmap, x, y0) != !pixel(bitmap, x, y1)) return 0;
+	}
+	return 1;
+}
+
+// Emits a run length as 3-bit codes, returns the number of bits.
+// 'end' is set when the run completes the row (no terminating code then).
+static int enrun(int len, int end, int emit) {
+	int n = 0, i;
+	while(len >= 7) {
+		if(emit) for(i=2; i>=0; i--) enbit(7 & (1 << i));
+		n   += 3;
+		len -= 7;
+		if(!len && end) return n;
+	}
+	if(emit) for(i=2; i>=0; i--) enbit(len & (1 << i));
+	return n + 3;
+}
+
+// Encodes row y as alternating clear/set runs, returns the number of bits
+static int enrow(FT_Bitmap *bitmap, int y, int emit) {
+	int x = 0, n = 0, len, set = 0;
+	while(x < bitmap->width) {
+		for(len=0; (x < bitmap->width) && (!pixel(bitmap, x, y) == !set); x++)
+			len++;
+		n  += enrun(len, x == bitmap->width, emit);
+		set = !set;
+	}
+	return n;
+}
+
+// Writes one glyph in GFX_BITMAP_RLE format, returns the number of bits
+static int enpacked(FT_Bitmap *bitmap, int emit) {
+	int x, y, plain = 1, runs = 1, useRuns, bits;
+
+	// Literal rows are stored as plain bits or runs, whatever is shorter
+	for(y=0; y < bitmap->rows; y++) {
+		if(y && sameRow(bitmap, y, y - 1)) {
+			plain++;
+			runs++;
+			continue;
+		}
+		plain += bitmap->width + (y ? 1 : 0);
+		runs  += enrow(bitmap, y, 0) + (y ? 1 : 0);
+	}
+	useRuns = (runs < plain);
+	bits    = useRuns ? runs : plain;
+	if(!emit) return bits;
+
+	enbit(useRuns);
+	for(y=0; y < bitmap->rows; y++) {
+		if(y) {
+			if(sameRow(bitmap, y, y - 1)) {
+				enbit(1);
+				continue;
+			}
+			enbit(0);
+		}
+		if(useRuns) {
+			enrow(bitmap, y, 1);
+		} else {
+			for(x=0; x < bitmap->width; x++) enbit(pixel(bitmap, x, y));
+		}
+	}
+	return bits;
+}
+
+// Characters of the subset, one bit per code
+static uint8_t subset[256 / 8];
+static int     subsetting = 0;
+
+static void addChar(uint8_t c) {
+	subset[c / 8] |= 1 << (c & 7);
+	subsetting = 1;
+}
+
+static int inSubset(int c) {
+	return !subsetting || (subset[c / 8] & (1 << (c & 7)));
+}
+
+// Extra code points, one bit per code
+static uint8_t extra[0x10000 / 8];
+
+static void addCode(long c) {
+	if((c < 0) || (c > 0xFFFF)) {
+		fprintf(stderr, "U+%04lX skipped, only U+0000..U+FFFF supported\n", c);
+		return;
+	}
+	extra[c / 8] |= 1 << (c & 7);
+}
+
+static int isExtra(int c) {
+	return extra[c / 8] & (1 << (c & 7));
+}
+
+// Adds the next byte of UTF-8 text, ASCII to the subset and anything else
+// to the extra code points.  Malformed sequences are dropped.
+static void addUtf8(int c) {
+	static long code = 0;
+	static int  left = 0;
+
+	if((c & 0xC0) == 0x80) { // Continuation byte
+		if(!left) return;
+		code = (code << 6) | (c & 0x3F);
+		if(!--left) addCode(code);
+		return;
+	}
+	left = 0;
+	if(c < 0x80) {
+		addChar(c);
+	} else if(c < 0xE0) {
+		code = c & 0x1F;
+		left = 1;
+	} else if(c < 0xF0) {
+		code = c & 0x0F;
+		left = 2;
+	} else {
+		code = c & 0x07;
+		left = 3;
+	}
+}
+
+// Code point to process after c: first..last, then the extra code points
+static int nextCode(int c, int first, int last) {
+	if((c >= first) && (c < last)) return c + 1;
+	for(c = (c == last) ? 0 : c + 1; c <= 0xFFFF; c++) {
+		if(isExtra(c)) return c;
+	}
+	return -1;
+}
+
+// Writes the index of a subset range (see gfxfont.h)
+static void enindex(const char *name, int first, int last, int extras) {
+	int     i, x, n = 0;
+	uint8_t bits;
+
+	printf("const uint8_t %sIndex[] PROGMEM = {\n ", name);
+	for(i=first; i<=last; i+=8) {
+		for(bits=0, x=0; (x < 8) && (i + x <= last); x++) {
+			if(extras ? isExtra(i + x) : inSubset(i + x)) bits |= 1 << x;
+		}
+		printf(" %3d, 0x%02X%s", n, bits, (i + 8 <= last) ? "," : " };\n\n");
+		if(((i - first) % 48 == 40) && (i + 8 <= last)) printf("\n ");
+		n += __builtin_popcount(bits);
+	}
+}
+
+// Adds the characters of the string and character literals in a C/C++
+// source file, comments and preprocessor lines (#include paths) are skipped.
+static int addLiterals(const char *path) {
+	FILE *f = fopen(path, "r");
+	int   c, quote = 0, prev = 0;
+
+	if(!f) {
+		fprintf(stderr, "Can't read %s\n", path);
+		return 1;
+	}
+	subsetting = 1;
+	while((c = fgetc(f)) != EOF) {
+		if(quote) {
+			if(c == quote) {
+				quote = 0;
+			} else if(c == '\\') {
+				c = fgetc(f); // Other escapes aren't printable
+				if((c == '\\') || (c == '"') || (c == '\'')) addChar(c);
+			} else {
+				addUtf8(c);
+			}
+		} else if((c == '"') || (c == '\'')) {
+			quote = c;
+		} else if((c == '#') && ((prev == '\n') || (prev == 0))) {
+			while(((c = fgetc(f)) != EOF) && (c != '\n'));
+		} else if((prev == '/') && (c == '/')) {
+			while(((c = fgetc(f)) != EOF) && (c != '\n'));
+		} else if((prev == '/') && (c == '*')) {
+			for(prev = 0; (c = fgetc(f)) != EOF; prev = c) {
+				if((prev == '*') && (c == '/')) break;
+			}
+			c = 0;
+		}
+		prev = c;
+	}
+	fclose(f);
+	return 0;
+}
+
 int main(int argc, char *argv[]) {
 	int                i, j, err, size, first=' ', last='~',
 	                   bitmapOffset = 0, x, y, byte;
@@ -57,17 +270,52 @@ int main(int argc, char *argv[]) {
 	FT_BitmapGlyphRec *g;
 	GFXglyph          *table;
 	uint8_t            bit;
+	int                packed = 0, plainSize = 0, bits;
+	int                emit, glyphs, fullSize = 0, *codes;
+	int                total, extras = 0, pages = 0, pageSize = 0;
+	int                pageStart[256], k;
+	char              *pageName;
 
 	// Parse command line.  Valid syntaxes are:
 	//   fontconvert [filename] [size]
 	//   fontconvert [filename] [size] [last char]
 	//   fontconvert [filename] [size] [first char] [last char]
 	// Unless overridden, default first and last chars are
-	// ' ' (space) and '~', respectively
+	// ' ' (space) and '~', respectively.  Leading options:
+	//   -c         packed glyph bitmaps (GFX_BITMAP_RLE)
+	//   -s chars   subset font, adds the characters
+	//   -f file    subset font, adds the characters of the literals
+	//   -u codes   extra code points, e.g. 0xB0,0x2103
+
+	while((argc > 1) && (argv[1][0] == '-')) {
+		if(!strcmp(argv[1], "-c")) {
+			packed = 1;
+		} else if(!strcmp(argv[1], "-s") && (argc > 2)) {
+			subsetting = 1;
+			for(ptr=argv[2]; *ptr; ptr++) addUtf8((uint8_t)*ptr);
+			argv++;
+			argc--;
+		} else if(!strcmp(argv[1], "-f") && (argc > 2)) {
+			if(addLiterals(argv[2])) return 1;
+			argv++;
+			argc--;
+		} else if(!strcmp(argv[1], "-u") && (argc > 2)) {
+			for(ptr=argv[2]; *ptr; ptr++) {
+				addCode(strtol(ptr, &ptr, 0));
+				if(*ptr != ',') break;
+			}
+			argv++;
+			argc--;
+		} else {
+			break;
+		}
+		argv++;
+		argc--;
+	}
 
 	if(argc < 3) {
-		fprintf(stderr, "Usage: %s fontfile size [first] [last]\n",
-		  argv[0]);
+		fprintf(stderr, "Usage: %s [-c] [-s chars] [-f file] [-u codes] "
+		  "fontfile size [first] [last]\n", argv[0]);
 		return 1;
 	}
 
@@ -86,13 +334,26 @@ int main(int argc, char *argv[]) {
 		last  = i;
 	}
 
+	// Extra code points within first..last are regular characters
+	for(i=first; i<=last; i++) {
+		if(!isExtra(i)) continue;
+		extra[i / 8] &= ~(1 << (i & 7));
+		if(subsetting) addChar(i);
+	}
+	for(i=0; i<=0xFFFF; i++) {
+		if(isExtra(i)) extras++;
+	}
+
 	ptr = strrchr(argv[1], '/'); // Find last slash in filename
 	if(ptr) ptr++;         // First character of filename (path stripped)
 	else    ptr = argv[1]; // No path; font in local dir.
 
 	// Allocate space for font name and glyph table
 	if((!(fontName = malloc(strlen(ptr) + 20))) ||
-	   (!(table = (GFXglyph *)malloc((last - first + 1) *
+	   (!(pageName = malloc(strlen(ptr) + 30))) ||
+	   (!(codes = (int *)malloc((last - first + 1 + extras) *
+	    sizeof(int)))) ||
+	   (!(table = (GFXglyph *)malloc((last - first + 1 + extras) *
 	    sizeof(GFXglyph))))) {
 		fprintf(stderr, "Malloc error\n");
 		return 1;
@@ -105,7 +366,8 @@ int main(int argc, char *argv[]) {
 	if(!ptr) ptr = &fontName[strlen(fontName)]; // If none, append
 	// Insert font size and 7/8 bit.  fontName was alloc'd w/extra
 	// space to allow this, we're not sprintfing into Forbidden Zone.
-	sprintf(ptr, "%dpt%db", size, (last > 127) ? 8 : 7);
+	sprintf(ptr, "%dpt%db%s", size, ((last > 127) || extras) ? 8 : 7,
+	  subsetting ? "Sub" : "");
 	// Space and punctuation chars in name replaced w/ underscores.  
 	for(i=0; (c=fontName[i]); i++) {
 		if(isspace(c) || ispunct(c)) fontName[i] = '_';
@@ -133,25 +395,33 @@ int main(int argc, char *argv[]) {
 
 	printf("const uint8_t %sBitmaps[] PROGMEM = {\n  ", fontName);
 
-	// Process glyphs and output huge bitmap data array
-	for(i=first, j=0; i<=last; i++, j++) {
+	// Process glyphs and output huge bitmap data array.  Glyphs that
+	// aren't part of the subset are rendered for the size report only.
+	for(i=first, j=0; i>=0; i=nextCode(i, first, last)) {
+		emit = isExtra(i) || inSubset(i);
+		if(emit) { // Entry stays empty if the glyph can't be rendered
+			memset(&table[j], 0, sizeof(GFXglyph));
+			table[j].bitmapOffset = bitmapOffset;
+			codes[j++] = i;
+		}
+
 		// MONO renderer provides clean image with perfect crop
 		// (no wasted pixels) via bitmap struct.
 		if((err = FT_Load_Char(face, i, FT_LOAD_TARGET_MONO))) {
-			fprintf(stderr, "Error %d loading char '%c'\n",
+			fprintf(stderr, "Error %d loading char 0x%02X\n",
 			  err, i);
 			continue;
 		}
 
 		if((err = FT_Render_Glyph(face->glyph,
 		  FT_RENDER_MODE_MONO))) {
-			fprintf(stderr, "Error %d rendering char '%c'\n",
+			fprintf(stderr, "Error %d rendering char 0x%02X\n",
 			  err, i);
 			continue;
 		}
 
 		if((err = FT_Get_Glyph(face->glyph, &glyph))) {
-			fprintf(stderr, "Error %d getting glyph '%c'\n",
+			fprintf(stderr, "Error %d getting glyph 0x%02X\n",
 			  err, i);
 			continue;
 		}
@@ -167,38 +437,63 @@ int main(int argc, char *argv[]) {
 		// code currently doesn't check for overflow.  (Doesn't
 		// check that size & offsets are within bounds either for
 		// that matter...please convert fonts responsibly.)
-		table[j].bitmapOffset = bitmapOffset;
-		table[j].width        = bitmap->width;
-		table[j].height       = bitmap->rows;
-		table[j].xAdvance     = face->glyph->advance.x >> 6;
-		table[j].xOffset      = g->left;
-		table[j].yOffset      = 1 - g->top;
-
-		for(y=0; y < bitmap->rows; y++) {
-			for(x=0;x < bitmap->width; x++) {
-				byte = x / 8;
-				bit  = 0x80 >> (x & 7);
-				enbit(bitmap->buffer[
-				  y * bitmap->pitch + byte] & bit);
+		if(packed && bitmap->width && bitmap->rows) {
+			bits = enpacked(bitmap, emit);
+		} else {
+			bits = bitmap->width * bitmap->rows;
+		}
+		fullSize += (bits + 7) / 8;
+		if(!emit) {
+			FT_Done_Glyph(glyph);
+			continue;
+		}
+
+		table[j-1].width    = bitmap->width;
+		table[j-1].height   = bitmap->rows;
+		table[j-1].xAdvance = face->glyph->advance.x >> 6;
+		table[j-1].xOffset  = g->left;
+		table[j-1].yOffset  = 1 - g->top;
+
+		plainSize += (bitmap->width * bitmap->rows + 7) / 8;
+		if(!packed || !bitmap->width || !bitmap->rows) {
+			for(y=0; y < bitmap->rows; y++) {
+				for(x=0;x < bitmap->width; x++) {
+					byte = x / 8;
+					bit  = 0x80 >> (x & 7);
+					enbit(bitmap->buffer[
+					  y * bitmap->pitch + byte] & bit);
+				}
 			}
 		}
 
 		// Pad end of char bitmap to next byte boundary if needed
-		int n = (bitmap->width * bitmap->rows) & 7;
+		int n = bits & 7;
 		if(n) { // Pixel count not an even multiple of 8?
 			n = 8 - n; // # bits to next multiple
 			while(n--) enbit(0);
 		}
-		bitmapOffset += (bitmap->width * bitmap->rows + 7) / 8;
+		bitmapOffset += (bits + 7) / 8;
 
 		FT_Done_Glyph(glyph);
 	}
 
 	printf(" };\n\n"); // End bitmap array
 
+	total = j;
+	for(glyphs=0; (glyphs < total) && !isExtra(codes[glyphs]); glyphs++);
+	if(!glyphs) {
+		fprintf(stderr, "No characters of the subset in 0x%02X..0x%02X\n",
+		  first, last);
+		return 1;
+	}
+	fullSize += (last - first + 1) * 7 + 7;
+	first = codes[0];
+	last  = codes[glyphs - 1];
+
 	// Output glyph attributes table (one per character)
 	printf("const GFXglyph %sGlyphs[] PROGMEM = {\n", fontName);
-	for(i=first, j=0; i<=last; i++, j++) {
+	for(j=0; j<total; j++) {
+		i = codes[j];
 		printf("  { %5d, %3d, %3d, %3d, %4d, %4d }",
 		  table[j].bitmapOffset,
 		  table[j].width,
@@ -206,17 +501,45 @@ int main(int argc, char *argv[]) {
 		  table[j].xAdvance,
 		  table[j].xOffset,
 		  table[j].yOffset);
-		if(i < last) {
-			printf(",   // 0x%02X", i);
-			if((i >= ' ') && (i <= '~')) {
-				printf(" '%c'", i);
+		printf((j < total - 1) ? ",   " : " }; ");
+		printf(isExtra(i) ? "// U+%04X" : "// 0x%02X", i);
+		if((i >= ' ') && (i <= '~')) {
+			printf(" '%c'", i);
+		}
+		putchar('\n');
+	}
+	putchar('\n');
+
+	// Subset: glyphs before each group of 8 characters and their bits
+	if(subsetting) enindex(fontName, first, last, 0);
+
+	// Extra code points: the glyphs of a page follow each other, pages
+	// that don't have all characters in between get an index of their own
+	for(j=glyphs; j<total; j=k) {
+		for(k=j; (k < total) && ((codes[k] >> 8) == (codes[j] >> 8)); k++);
+		pageStart[pages++] = j;
+		pageSize += 7 + (k - j) * 7;
+		if(k - j < codes[k - 1] - codes[j] + 1) {
+			sprintf(pageName, "%sPage%02X", fontName, codes[j] >> 8);
+			enindex(pageName, codes[j], codes[k - 1], 1);
+			pageSize += ((codes[k - 1] - codes[j]) / 8 + 1) * 2;
+		}
+	}
+	if(pages) {
+		printf("const GFXcodePage %sPages[] PROGMEM = {\n", fontName);
+		for(i=0; i<pages; i++) {
+			j = pageStart[i];
+			k = (i < pages - 1) ? pageStart[i + 1] : total;
+			printf("  { 0x%02X, 0x%02X, 0x%02X, %4d, ", codes[j] >> 8,
+			  codes[j] & 0xFF, codes[k - 1] & 0xFF, j);
+			if(k - j < codes[k - 1] - codes[j] + 1) {
+				printf("(uint8_t *)%sPage%02XIndex }", fontName, codes[j] >> 8);
+			} else {
+				printf("NULL }");
 			}
-			putchar('\n');
+			printf((i < pages - 1) ? ",\n" : " };\n\n");
 		}
 	}
-	printf(" }; // 0x%02X", last);
-	if((last >= ' ') && (last <= '~')) printf(" '%c'", last);
-	printf("\n\n");
 
 	// Output font structure
 	printf("const GFXfont %s PROGMEM = {\n", fontName);
@@ -224,14 +547,27 @@ int main(int argc, char *argv[]) {
 	printf("  (GFXglyph *)%sGlyphs,\n", fontName);
 	if (face->size->metrics.height == 0) {
       // No face height info, assume fixed width and get from a glyph.
-		printf("  0x%02X, 0x%02X, %d };\n\n",
-			first, last, table[0].height);
+		printf("  0x%02X, 0x%02X, %d", first, last, table[0].height);
 	} else {
-		printf("  0x%02X, 0x%02X, %ld };\n\n",
+		printf("  0x%02X, 0x%02X, %ld",
 			first, last, face->size->metrics.height >> 6);
 	}
-	printf("// Approx. %d bytes\n",
-	  bitmapOffset + (last - first + 1) * 7 + 7);
+	// All fields initialized, compilers warn about missing ones with -Wextra
+	printf(", %s,\n  ", packed ? "GFX_BITMAP_RLE" : "GFX_BITMAP_PLAIN");
+	if(subsetting) printf("(uint8_t  *)%sIndex", fontName);
+	else           printf("NULL");
+	if(pages) printf(",\n  (GFXcodePage *)%sPages, %d };\n\n", fontName, pages);
+	else      printf(", NULL, 0 };\n\n");
+	printf("// Approx. %d bytes\n", bitmapOffset + glyphs * 7 + 7 + pageSize +
+	  (subsetting ? ((last - first) / 8 + 1) * 2 : 0));
+	if(packed) {
+		printf("// Bitmaps %d bytes packed, %d bytes plain\n",
+		  bitmapOffset, plainSize);
+	}
+	if(subsetting) {
+		printf("// Subset of %d glyphs, the full range takes approx. "
+		  "%d bytes\n", total, fullSize + pageSize);
+	}
 	// Size estimate is based on AVR struct and pointer sizes;
 	// actual size may vary.
 
@@ -0,0 +1,1047 @@
+// Rendering core of Adafruit_GFX with statically bound pixel writes.
+//
+// GFXcore<Target> holds the drawing primitives of Adafruit_GFX as templates.
+// Target is the class derived from it (CRTP).  The primitives call its pixel
+// and line functions without a virtual call, so a small drawPixel() is
+// inlined into the inner loops of writeLine(), drawCircle(), drawChar() etc.
+//
+// A target has to provide drawPixel(x, y, color), clipped to the rotated
+// size.  Like with Adafruit_GFX it may hide any of the other functions with
+// a faster version, e.g. drawFastHLine() or fillSpans(), or width(),
+// height(), getRotation(), getFont() and getCp437() to draw with the state
+// of another object.  The targets below draw into buffers of the
+// GFXcanvas1/8/16 layouts, SSD1306Core (see Display_SSD1306.h) into the
+// frame of the SSD1306 driver.
+//
+// Adafruit_GFX is a target as well.  Its pixel and line functions are
+// virtual, so the primitives call the overrides of the drivers as before.
+// Text layout stays in Adafruit_GFX: print(), UTF-8 and text bounds need its
+// state, the core draws single characters with drawChar() and drawGlyph().
+
+#ifndef _GFXCORE_H_
+#define _GFXCORE_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gfxfont.h"
+#include "gfxglyphruns.h"
+
+// Run of pixels in one row (horizontal) or one column (vertical), already
+// clipped to the display.  Filled primitives hand them over in batches.
+typedef struct {
+  int16_t x, y, len;
+} GFXspan;
+
+#ifndef pgm_read_byte
+ #define pgm_read_byte(addr) (*(const unsigned char *)(addr))
+#endif
+#ifndef pgm_read_word
+ #define pgm_read_word(addr) (*(const unsigned short *)(addr))
+#endif
+#ifndef pgm_read_dword
+ #define pgm_read_dword(addr) (*(const unsigned long *)(addr))
+#endif
+
+// Pointers are a peculiar case...typically 16-bit on AVR boards,
+// 32 bits elsewhere.  Try to accommodate both...
+
+#if !defined(__INT_MAX__) || (__INT_MAX__ > 0xFFFF)
+ #define pgm_read_pointer(addr) (*(void * const *)(addr))
+#else
+ #define pgm_read_pointer(addr) ((void *)pgm_read_word(addr))
+#endif
+
+#ifndef _swap_int16_t
+#define _swap_int16_t(a, b) { int16_t t = a; a = b; b = t; }
+#endif
+
+// Outcodes of a point relative to the visible area (Cohen-Sutherland)
+#define GFX_CLIP_LEFT   0x1
+#define GFX_CLIP_RIGHT  0x2
+#define GFX_CLIP_TOP    0x4
+#define GFX_CLIP_BOTTOM 0x8
+
+static inline uint8_t gfxClipCode(int16_t x, int16_t y, int16_t w, int16_t h) {
+    uint8_t code = 0;
+    if(x < 0)       code |= GFX_CLIP_LEFT;
+    else if(x >= w) code |= GFX_CLIP_RIGHT;
+    if(y < 0)       code |= GFX_CLIP_TOP;
+    else if(y >= h) code |= GFX_CLIP_BOTTOM;
+    return code;
+}
+
+// Number of Bresenham steps until the minor coordinate has moved n times.
+// After k steps it has moved ceil((k*dy - err0) / dx) times.
+static inline int32_t gfxLineSteps(int32_t n, int32_t dx, int32_t dy,
+        int32_t err0) {
+    if(n <= 0) return 0;
+    return ((n - 1) * dx + err0) / dy + 1;
+}
+
+// Spans per fillSpans() call, they are collected on the stack
+#define GFX_SPAN_BATCH 32
+
+// Clips the spans of a filled primitive and passes them on in batches
+template <class Target>
+class GFXspanWriter {
+ public:
+    GFXspanWriter(Target *gfx, bool vertical, uint16_t color) :
+      _gfx(gfx), _width(gfx->width()), _height(gfx->height()),
+      _vertical(vertical), _color(color), _count(0) { }
+    ~GFXspanWriter(void) { flush(); }
+
+    void add(int16_t x, int16_t y, int16_t len) {
+        // Spans of zero or negative length are dropped, as the fast
+        // line functions of the drivers do
+        if(_vertical) {
+            if((x < 0) || (x >= _width)) return;
+            if(y < 0) { len += y; y = 0; }
+            if(y + len > _height) len = _height - y;
+        } else {
+            if((y < 0) || (y >= _height)) return;
+            if(x < 0) { len += x; x = 0; }
+            if(x + len > _width) len = _width - x;
+        }
+        if(len <= 0) return;
+
+        if(_count == GFX_SPAN_BATCH) flush();
+        GFXspan &span = _spans[_count++];
+        span.x   = x;
+        span.y   = y;
+        span.len = len;
+    }
+
+    void flush(void) {
+        if(_count) _gfx->fillSpans(_spans, _count, _vertical, _color);
+        _count = 0;
+    }
+
+ private:
+    Target  *_gfx;
+    int16_t  _width, _height;
+    bool     _vertical;
+    uint16_t _color;
+    uint16_t _count;
+    GFXspan  _spans[GFX_SPAN_BATCH];
+};
+
+template <class Target>
+class GFXcore {
+
+ public:
+
+  GFXcore(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h), _width(w), _height(h),
+    rotation(0), _cp437(false), gfxFont(NULL) { }
+
+  // TRANSACTION API / CORE DRAW API, see Adafruit_GFX
+  void startWrite(void) { }
+  void writePixel(int16_t x, int16_t y, uint16_t color) {
+    self().drawPixel(x, y, color);
+  }
+  void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+          uint16_t color) {
+    self().fillRect(x, y, w, h, color);
+  }
+  // (x,y) is topmost point; if unsure, calling function
+  // should sort endpoints or call writeLine() instead
+  void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    self().drawFastVLine(x, y, h, color);
+  }
+  // (x,y) is leftmost point; if unsure, calling function
+  // should sort endpoints or call writeLine() instead
+  void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    self().drawFastHLine(x, y, w, color);
+  }
+  void writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+          uint16_t color);
+  void endWrite(void) { }
+
+  // CONTROL API
+  void setRotation(uint8_t r) {
+    rotation = (r & 3);
+    _width   = (rotation & 1) ? HEIGHT : WIDTH;
+    _height  = (rotation & 1) ? WIDTH  : HEIGHT;
+  }
+  uint8_t getRotation(void) const { return rotation; }
+  int16_t width(void) const { return _width; }
+  int16_t height(void) const { return _height; }
+  void setFont(const GFXfont *f = NULL) { gfxFont = (GFXfont *)f; }
+  const GFXfont *getFont(void) const { return gfxFont; }
+  void cp437(bool x = true) { _cp437 = x; }
+  bool getCp437(void) const { return _cp437; }
+
+  // BASIC DRAW API
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  void fillScreen(uint16_t color) {
+    self().fillRect(0, 0, self().width(), self().height(), color);
+  }
+  void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+          uint16_t color);
+  void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color,
+          uint16_t bg, uint8_t size);
+  void drawGlyph(int16_t x, int16_t y, uint16_t index, uint16_t color,
+          uint8_t size);
+  void fillSpans(const GFXspan *spans, uint16_t count, bool vertical,
+          uint16_t color);
+  // True if the target fills rows faster than columns, e.g. a buffer in rows.
+  // fillCircle() passes rows then, the pixels are the same.
+  bool rowSpans(void) const { return false; }
+
+  void drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+  void drawCircleHelper(int16_t x0, int16_t y0, int16_t r,
+          uint8_t cornername, uint16_t color);
+  void fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+  void fillCircleHelper(int16_t x0, int16_t y0, int16_t r,
+          uint8_t cornername, int16_t delta, uint16_t color);
+  void drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+          int16_t x2, int16_t y2, uint16_t color);
+  void fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+          int16_t x2, int16_t y2, uint16_t color);
+  void drawRoundRect(int16_t x0, int16_t y0, int16_t w, int16_t h,
+          int16_t radius, uint16_t color);
+  void fillRoundRect(int16_t x0, int16_t y0, int16_t w, int16_t h,
+          int16_t radius, uint16_t color);
+
+ protected:
+  Target &self(void) { return *static_cast<Target *>(this); }
+  const Target &self(void) const { return *static_cast<const Target *>(this); }
+
+  // For targets that fill lines of their buffer at once: clips a line and
+  // converts it to buffer coordinates, (x,y) is its top or left end then.
+  // Returns true if it is a row of the buffer after the rotation, false for
+  // a column.  'len' is <= 0 if nothing is visible.  bufferSpan() converts
+  // a line that is clipped already, bufferRect() clips and converts a
+  // rectangle and returns false if nothing of it is visible.
+  bool bufferLine(int16_t &x, int16_t &y, int16_t &len, bool vertical) const;
+  bool bufferSpan(int16_t &x, int16_t &y, int16_t len, bool vertical) const;
+  bool bufferRect(int16_t &x, int16_t &y, int16_t &w, int16_t &h) const;
+
+  const int16_t
+    WIDTH, HEIGHT;   // This is the 'raw' display w/h - never changes
+  int16_t
+    _width, _height; // Display w/h as modified by current rotation
+  uint8_t
+    rotation;
+  bool
+    _cp437;          // If set, use correct CP437 charset (default is off)
+  GFXfont
+    *gfxFont;
+
+ private:
+  void fillCircleSpans(GFXspanWriter<Target> &spans, int16_t x0, int16_t y0,
+          int16_t r, uint8_t cornername, int16_t delta, bool rows = false);
+};
+
+// Bresenham's algorithm - thx wikpedia
+// The line is clipped before the first step: the visible part is computed
+// from the outcodes of the ends and the intersections are found in steps of
+// the algorithm, so exactly the visible pixels of the unclipped line are
+// drawn. Horizontal, vertical and 45 degree lines take shortcuts.
+template <class Target>
+void GFXcore<Target>::writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+        uint16_t color) {
+    uint8_t code0 = gfxClipCode(x0, y0, self().width(), self().height());
+    uint8_t code1 = gfxClipCode(x1, y1, self().width(), self().height());
+    if(code0 & code1) return; // Both ends beyond the same edge
+
+    int16_t steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) {
+        _swap_int16_t(x0, y0);
+        _swap_int16_t(x1, y1);
+    }
+
+    if (x0 > x1) {
+        _swap_int16_t(x0, x1);
+        _swap_int16_t(y0, y1);
+    }
+
+    int32_t dx, dy;
+    dx = x1 - x0;
+    dy = abs(y1 - y0);
+
+    int32_t err0 = dx / 2;
+    int16_t ystep;
+
+    if (y0 < y1) {
+        ystep = 1;
+    } else {
+        ystep = -1;
+    }
+
+    // Steps first..last are drawn, step k is at x0+k
+    int32_t first = 0, last = dx;
+    if(code0 | code1) {
+        int16_t major = steep ? self().height() : self().width();
+        int16_t minor = steep ? self().width()  : self().height();
+        if(x0 < 0)      first = -x0;
+        if(x1 >= major) last  = major - 1 - x0;
+        if(dy) {
+            // Minor coordinate is y0 + ystep * moves
+            int32_t lo = (ystep > 0) ? -y0 : y0 - (minor - 1);
+            int32_t hi = (ystep > 0) ? minor - 1 - y0 : y0;
+            int32_t k  = gfxLineSteps(lo, dx, dy, err0);
+            if(k > first) first = k;
+            k = gfxLineSteps(hi + 1, dx, dy, err0) - 1;
+            if(k < last) last = k;
+        } else if((y0 < 0) || (y0 >= minor)) {
+            return;
+        }
+        if(first > last) return;
+    }
+
+    if(dy == 0) {
+        if(steep) self().writeFastVLine(y0, x0 + first, last - first + 1, color);
+        else      self().writeFastHLine(x0 + first, y0, last - first + 1, color);
+        return;
+    }
+
+    if(dy == dx) { // 45 degrees, one move per step
+        int16_t x = x0 + first;
+        int16_t y = y0 + ystep * first;
+        for(int32_t k=first; k<=last; k++, x++, y+=ystep) {
+            self().writePixel(x, y, color);
+        }
+        return;
+    }
+
+    // Continue at the first visible step
+    int32_t moves = (first * dy - err0 + dx - 1) / dx;
+    if(moves < 0) moves = 0;
+    int32_t err = err0 - first * dy + moves * dx;
+    x0 += first;
+    y0 += ystep * moves;
+    x1  = x0 + (last - first);
+
+    for (; x0<=x1; x0++) {
+        if (steep) {
+            self().writePixel(y0, x0, color);
+        } else {
+            self().writePixel(x0, y0, color);
+        }
+        err -= dy;
+        if (err < 0) {
+            y0 += ystep;
+            err += dx;
+        }
+    }
+}
+
+// (x,y) is topmost point; if unsure, calling function
+// should sort endpoints or call drawLine() instead
+template <class Target>
+void GFXcore<Target>::drawFastVLine(int16_t x, int16_t y,
+        int16_t h, uint16_t color) {
+    // Not by writeLine(), it passes vertical lines on to writeFastVLine().
+    // Same pixels as writeLine(x, y, x, y+h-1) though, i.e. for h < 1 the
+    // line runs from y+h-1 down to y.
+    if(h < 1) { y += h - 1; h = 2 - h; }
+    if((x < 0) || (x >= self().width())) return;
+    if(y < 0) { h += y; y = 0; }
+    if(y + h > self().height()) h = self().height() - y;
+    self().startWrite();
+    for(int16_t i=0; i<h; i++) {
+        self().writePixel(x, y+i, color);
+    }
+    self().endWrite();
+}
+
+// (x,y) is leftmost point; if unsure, calling function
+// should sort endpoints or call drawLine() instead
+template <class Target>
+void GFXcore<Target>::drawFastHLine(int16_t x, int16_t y,
+        int16_t w, uint16_t color) {
+    // Not by writeLine(), it passes horizontal lines on to writeFastHLine().
+    // Same pixels as writeLine(x, y, x+w-1, y) though, i.e. for w < 1 the
+    // line runs from x+w-1 to x.
+    if(w < 1) { x += w - 1; w = 2 - w; }
+    if((y < 0) || (y >= self().height())) return;
+    if(x < 0) { w += x; x = 0; }
+    if(x + w > self().width()) w = self().width() - x;
+    self().startWrite();
+    for(int16_t i=0; i<w; i++) {
+        self().writePixel(x+i, y, color);
+    }
+    self().endWrite();
+}
+
+template <class Target>
+bool GFXcore<Target>::bufferLine(int16_t &x, int16_t &y, int16_t &len,
+        bool vertical) const {
+    int16_t &pos = vertical ? y : x, size = vertical ? self().height() : self().width();
+    if(vertical ? ((x < 0) || (x >= self().width())) : ((y < 0) || (y >= self().height()))) {
+        len = 0;
+    }
+    if(pos < 0) { len += pos; pos = 0; }
+    if(pos + len > size) len = size - pos;
+    return bufferSpan(x, y, len, vertical);
+}
+
+template <class Target>
+bool GFXcore<Target>::bufferSpan(int16_t &x, int16_t &y, int16_t len,
+        bool vertical) const {
+    int16_t t;
+    switch(self().getRotation()) {
+        case 1:
+            t = x;
+            x = WIDTH - 1 - y - (vertical ? len - 1 : 0);
+            y = t;
+            break;
+        case 2:
+            x = WIDTH  - 1 - x - (vertical ? 0 : len - 1);
+            y = HEIGHT - 1 - y - (vertical ? len - 1 : 0);
+            break;
+        case 3:
+            t = x;
+            x = y;
+            y = HEIGHT - 1 - t - (vertical ? 0 : len - 1);
+            break;
+    }
+    return vertical == (bool)(self().getRotation() & 1);
+}
+
+template <class Target>
+bool GFXcore<Target>::bufferRect(int16_t &x, int16_t &y, int16_t &w,
+        int16_t &h) const {
+    if(x < 0) { w += x; x = 0; }
+    if(y < 0) { h += y; y = 0; }
+    if(x + w > self().width())  w = self().width()  - x;
+    if(y + h > self().height()) h = self().height() - y;
+    if((w <= 0) || (h <= 0)) return false;
+
+    int16_t t;
+    switch(self().getRotation()) {
+        case 1:
+            t = x;
+            x = WIDTH - y - h;
+            y = t;
+            t = w; w = h; h = t;
+            break;
+        case 2:
+            x = WIDTH  - x - w;
+            y = HEIGHT - y - h;
+            break;
+        case 3:
+            t = x;
+            x = y;
+            y = HEIGHT - t - w;
+            t = w; w = h; h = t;
+            break;
+    }
+    return true;
+}
+
+template <class Target>
+void GFXcore<Target>::fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+        uint16_t color) {
+    self().startWrite();
+    for (int16_t i=x; i<x+w; i++) {
+        self().writeFastVLine(i, y, h, color);
+    }
+    self().endWrite();
+}
+
+template <class Target>
+void GFXcore<Target>::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+        uint16_t color) {
+    // Straight lines are cut to the panel first, their length has to fit
+    // into int16_t
+    if(x0 == x1){
+        if(y0 > y1) _swap_int16_t(y0, y1);
+        if((y1 < 0) || (y0 >= self().height())) return;
+        if(y0 < 0) y0 = 0;
+        if(y1 >= self().height()) y1 = self().height() - 1;
+        self().drawFastVLine(x0, y0, y1 - y0 + 1, color);
+    } else if(y0 == y1){
+        if(x0 > x1) _swap_int16_t(x0, x1);
+        if((x1 < 0) || (x0 >= self().width())) return;
+        if(x0 < 0) x0 = 0;
+        if(x1 >= self().width()) x1 = self().width() - 1;
+        self().drawFastHLine(x0, y0, x1 - x0 + 1, color);
+    } else {
+        self().startWrite();
+        self().writeLine(x0, y0, x1, y1, color);
+        self().endWrite();
+    }
+}
+
+// Draw a circle outline
+template <class Target>
+void GFXcore<Target>::drawCircle(int16_t x0, int16_t y0, int16_t r,
+        uint16_t color) {
+    int16_t f = 1 - r;
+    int16_t ddF_x = 1;
+    int16_t ddF_y = -2 * r;
+    int16_t x = 0;
+    int16_t y = r;
+
+    self().startWrite();
+    self().writePixel(x0  , y0+r, color);
+    self().writePixel(x0  , y0-r, color);
+    self().writePixel(x0+r, y0  , color);
+    self().writePixel(x0-r, y0  , color);
+
+    while (x<y) {
+        if (f >= 0) {
+            y--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f += ddF_x;
+
+        self().writePixel(x0 + x, y0 + y, color);
+        self().writePixel(x0 - x, y0 + y, color);
+        self().writePixel(x0 + x, y0 - y, color);
+        self().writePixel(x0 - x, y0 - y, color);
+        self().writePixel(x0 + y, y0 + x, color);
+        self().writePixel(x0 - y, y0 + x, color);
+        self().writePixel(x0 + y, y0 - x, color);
+        self().writePixel(x0 - y, y0 - x, color);
+    }
+    self().endWrite();
+}
+
+template <class Target>
+void GFXcore<Target>::drawCircleHelper( int16_t x0, int16_t y0,
+        int16_t r, uint8_t cornername, uint16_t color) {
+    int16_t f     = 1 - r;
+    int16_t ddF_x = 1;
+    int16_t ddF_y = -2 * r;
+    int16_t x     = 0;
+    int16_t y     = r;
+
+    while (x<y) {
+        if (f >= 0) {
+            y--;
+            ddF_y += 2;
+            f     += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f     += ddF_x;
+        if (cornername & 0x4) {
+            self().writePixel(x0 + x, y0 + y, color);
+            self().writePixel(x0 + y, y0 + x, color);
+        }
+        if (cornername & 0x2) {
+            self().writePixel(x0 + x, y0 - y, color);
+            self().writePixel(x0 + y, y0 - x, color);
+        }
+        if (cornername & 0x8) {
+            self().writePixel(x0 - y, y0 + x, color);
+            self().writePixel(x0 - x, y0 + y, color);
+        }
+        if (cornername & 0x1) {
+            self().writePixel(x0 - y, y0 - x, color);
+            self().writePixel(x0 - x, y0 - y, color);
+        }
+    }
+}
+
+// Columns of circle quarters, used to do circles and roundrects.  With
+// 'rows' the columns are mirrored at the diagonal through (x0,y0), for a
+// full circle (cornername 3, delta 0) these rows are the same pixels.
+template <class Target>
+void GFXcore<Target>::fillCircleSpans(GFXspanWriter<Target> &spans,
+        int16_t x0, int16_t y0, int16_t r, uint8_t cornername, int16_t delta,
+        bool rows) {
+
+    int16_t f     = 1 - r;
+    int16_t ddF_x = 1;
+    int16_t ddF_y = -2 * r;
+    int16_t x     = 0;
+    int16_t y     = r;
+
+    while (x<y) {
+        if (f >= 0) {
+            y--;
+            ddF_y += 2;
+            f     += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f     += ddF_x;
+
+        if (rows) {
+            spans.add(x0-y, y0+x, 2*y+1);
+            spans.add(x0-x, y0+y, 2*x+1);
+            spans.add(x0-y, y0-x, 2*y+1);
+            spans.add(x0-x, y0-y, 2*x+1);
+            continue;
+        }
+        if (cornername & 0x1) {
+            spans.add(x0+x, y0-y, 2*y+1+delta);
+            spans.add(x0+y, y0-x, 2*x+1+delta);
+        }
+        if (cornername & 0x2) {
+            spans.add(x0-x, y0-y, 2*y+1+delta);
+            spans.add(x0-y, y0-x, 2*x+1+delta);
+        }
+    }
+}
+
+template <class Target>
+void GFXcore<Target>::fillCircle(int16_t x0, int16_t y0, int16_t r,
+        uint16_t color) {
+    bool rows = self().rowSpans();
+    self().startWrite();
+    {
+        GFXspanWriter<Target> spans(&self(), !rows, color);
+        if(rows) spans.add(x0-r, y0, 2*r+1);
+        else     spans.add(x0, y0-r, 2*r+1);
+        fillCircleSpans(spans, x0, y0, r, 3, 0, rows);
+    }
+    self().endWrite();
+}
+
+// Used to do circles and roundrects
+template <class Target>
+void GFXcore<Target>::fillCircleHelper(int16_t x0, int16_t y0, int16_t r,
+        uint8_t cornername, int16_t delta, uint16_t color) {
+    GFXspanWriter<Target> spans(&self(), true, color);
+    fillCircleSpans(spans, x0, y0, r, cornername, delta);
+}
+
+// Default for targets without a batch function, one line per span
+template <class Target>
+void GFXcore<Target>::fillSpans(const GFXspan *spans, uint16_t count,
+        bool vertical, uint16_t color) {
+    for(uint16_t i=0; i<count; i++) {
+        if(vertical) self().writeFastVLine(spans[i].x, spans[i].y, spans[i].len, color);
+        else         self().writeFastHLine(spans[i].x, spans[i].y, spans[i].len, color);
+    }
+}
+
+// Draw a rectangle
+template <class Target>
+void GFXcore<Target>::drawRect(int16_t x, int16_t y, int16_t w, int16_t h,
+        uint16_t color) {
+    self().startWrite();
+    self().writeFastHLine(x, y, w, color);
+    self().writeFastHLine(x, y+h-1, w, color);
+    self().writeFastVLine(x, y, h, color);
+    self().writeFastVLine(x+w-1, y, h, color);
+    self().endWrite();
+}
+
+// Draw a rounded rectangle
+template <class Target>
+void GFXcore<Target>::drawRoundRect(int16_t x, int16_t y, int16_t w,
+        int16_t h, int16_t r, uint16_t color) {
+    // smarter version
+    self().startWrite();
+    self().writeFastHLine(x+r  , y    , w-2*r, color); // Top
+    self().writeFastHLine(x+r  , y+h-1, w-2*r, color); // Bottom
+    self().writeFastVLine(x    , y+r  , h-2*r, color); // Left
+    self().writeFastVLine(x+w-1, y+r  , h-2*r, color); // Right
+    // draw four corners
+    self().drawCircleHelper(x+r    , y+r    , r, 1, color);
+    self().drawCircleHelper(x+w-r-1, y+r    , r, 2, color);
+    self().drawCircleHelper(x+w-r-1, y+h-r-1, r, 4, color);
+    self().drawCircleHelper(x+r    , y+h-r-1, r, 8, color);
+    self().endWrite();
+}
+
+// Fill a rounded rectangle
+template <class Target>
+void GFXcore<Target>::fillRoundRect(int16_t x, int16_t y, int16_t w,
+        int16_t h, int16_t r, uint16_t color) {
+    // smarter version
+    self().startWrite();
+    self().writeFillRect(x+r, y, w-2*r, h, color);
+
+    // draw four corners
+    {
+        GFXspanWriter<Target> spans(&self(), true, color);
+        fillCircleSpans(spans, x+w-r-1, y+r, r, 1, h-2*r-1);
+        fillCircleSpans(spans, x+r    , y+r, r, 2, h-2*r-1);
+    }
+    self().endWrite();
+}
+
+// Draw a triangle
+template <class Target>
+void GFXcore<Target>::drawTriangle(int16_t x0, int16_t y0,
+        int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color) {
+    self().drawLine(x0, y0, x1, y1, color);
+    self().drawLine(x1, y1, x2, y2, color);
+    self().drawLine(x2, y2, x0, y0, color);
+}
+
+// Fill a triangle
+template <class Target>
+void GFXcore<Target>::fillTriangle(int16_t x0, int16_t y0,
+        int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color) {
+
+    int16_t a, b, y, last;
+
+    // Sort coordinates by Y order (y2 >= y1 >= y0)
+    if (y0 > y1) {
+        _swap_int16_t(y0, y1); _swap_int16_t(x0, x1);
+    }
+    if (y1 > y2) {
+        _swap_int16_t(y2, y1); _swap_int16_t(x2, x1);
+    }
+    if (y0 > y1) {
+        _swap_int16_t(y0, y1); _swap_int16_t(x0, x1);
+    }
+
+    self().startWrite();
+    GFXspanWriter<Target> spans(&self(), false, color);
+    if(y0 == y2) { // Handle awkward all-on-same-line case as its own thing
+        a = b = x0;
+        if(x1 < a)      a = x1;
+        else if(x1 > b) b = x1;
+        if(x2 < a)      a = x2;
+        else if(x2 > b) b = x2;
+        spans.add(a, y0, b-a+1);
+        spans.flush();
+        self().endWrite();
+        return;
+    }
+
+    int16_t
+    dx01 = x1 - x0,
+    dy01 = y1 - y0,
+    dx02 = x2 - x0,
+    dy02 = y2 - y0,
+    dx12 = x2 - x1,
+    dy12 = y2 - y1;
+    int32_t
+    sa   = 0,
+    sb   = 0;
+
+    // For upper part of triangle, find scanline crossings for segments
+    // 0-1 and 0-2.  If y1=y2 (flat-bottomed triangle), the scanline y1
+    // is included here (and second loop will be skipped, avoiding a /0
+    // error there), otherwise scanline y1 is skipped here and handled
+    // in the second loop...which also avoids a /0 error here if y0=y1
+    // (flat-topped triangle).
+    if(y1 == y2) last = y1;   // Include y1 scanline
+    else         last = y1-1; // Skip it
+
+    for(y=y0; y<=last; y++) {
+        a   = x0 + sa / dy01;
+        b   = x0 + sb / dy02;
+        sa += dx01;
+        sb += dx02;
+        /* longhand:
+        a = x0 + (x1 - x0) * (y - y0) / (y1 - y0);
+        b = x0 + (x2 - x0) * (y - y0) / (y2 - y0);
+        */
+        if(a > b) _swap_int16_t(a,b);
+        spans.add(a, y, b-a+1);
+    }
+
+    // For lower part of triangle, find scanline crossings for segments
+    // 0-2 and 1-2.  This loop is skipped if y1=y2.
+    sa = dx12 * (y - y1);
+    sb = dx02 * (y - y0);
+    for(; y<=y2; y++) {
+        a   = x1 + sa / dy12;
+        b   = x0 + sb / dy02;
+        sa += dx12;
+        sb += dx02;
+        /* longhand:
+        a = x1 + (x2 - x1) * (y - y1) / (y2 - y1);
+        b = x0 + (x2 - x0) * (y - y0) / (y2 - y0);
+        */
+        if(a > b) _swap_int16_t(a,b);
+        spans.add(a, y, b-a+1);
+    }
+    spans.flush();
+    self().endWrite();
+}
+
+// Draw a character
+template <class Target>
+void GFXcore<Target>::drawChar(int16_t x, int16_t y, unsigned char c,
+  uint16_t color, uint16_t bg, uint8_t size) {
+
+    if(!self().getFont()) { // 'Classic' built-in font
+
+        if((x >= self().width())            || // Clip right
+           (y >= self().height())           || // Clip bottom
+           ((x + 6 * size - 1) < 0) || // Clip left
+           ((y + 8 * size - 1) < 0))   // Clip top
+            return;
+
+        if(!self().getCp437() && (c >= 176)) c++; // Handle 'classic' charset behavior
+
+        self().startWrite();
+        for(int8_t i=0; i<5; i++ ) { // Char bitmap = 5 columns
+            uint8_t line = pgm_read_byte(&font[c * 5 + i]);
+            if(size == 1) {
+                for(int8_t j=0; j<8; j++, line >>= 1) {
+                    if(line & 1) {
+                        self().writePixel(x+i, y+j, color);
+                    } else if(bg != color) {
+                        self().writePixel(x+i, y+j, bg);
+                    }
+                }
+                continue;
+            }
+            // Scaled: each run of equal pixels in the column is one rectangle
+            for(int8_t j=0, n; j<8; j+=n) {
+                uint8_t set = line & 1;
+                for(n=0; (j+n < 8) && ((line & 1) == set); n++) line >>= 1;
+                if(set) {
+                    self().writeFillRect(x+i*size, y+j*size, size, n*size, color);
+                } else if(bg != color) {
+                    self().writeFillRect(x+i*size, y+j*size, size, n*size, bg);
+                }
+            }
+        }
+        if(bg != color) { // If opaque, draw vertical line for last column
+            if(size == 1) self().writeFastVLine(x+5, y, 8, bg);
+            else          self().writeFillRect(x+5*size, y, size, 8*size, bg);
+        }
+        self().endWrite();
+
+    } else { // Custom font
+
+        // Character is assumed previously filtered by write() to eliminate
+        // newlines, returns, etc.  Characters without a glyph in the font
+        // (outside of first..last or missing in a subset) are skipped.
+
+        int16_t index = gfxFontGlyphIndex(self().getFont(), c);
+        if(index >= 0) self().drawGlyph(x, y, index, color, size);
+
+    } // End classic vs custom font
+}
+
+// Draw glyph 'index' of the current GFX font
+template <class Target>
+void GFXcore<Target>::drawGlyph(int16_t x, int16_t y, uint16_t index,
+  uint16_t color, uint8_t size) {
+
+    const GFXfont *f = self().getFont();
+    GFXglyph *glyph  = &(((GFXglyph *)pgm_read_pointer(&f->glyph))[index]);
+    uint8_t  *bitmap = (uint8_t *)pgm_read_pointer(&f->bitmap);
+
+    uint16_t bo = pgm_read_word(&glyph->bitmapOffset);
+    uint8_t  w  = pgm_read_byte(&glyph->width),
+             h  = pgm_read_byte(&glyph->height);
+    int8_t   xo = pgm_read_byte(&glyph->xOffset),
+             yo = pgm_read_byte(&glyph->yOffset);
+    uint8_t  xx, yy, bits = 0, bit = 0;
+    int16_t  xo16 = 0, yo16 = 0;
+
+    if(size > 1) {
+        xo16 = xo;
+        yo16 = yo;
+    }
+
+    // Todo: Add character clipping here
+
+    // NOTE: THERE IS NO 'BACKGROUND' COLOR OPTION ON CUSTOM FONTS.
+    // THIS IS ON PURPOSE AND BY DESIGN.  The background color feature
+    // has typically been used with the 'classic' font to overwrite old
+    // screen contents with new data.  This ONLY works because the
+    // characters are a uniform size; it's not a sensible thing to do with
+    // proportionally-spaced fonts with glyphs of varying sizes (and that
+    // may overlap).  To replace previously-drawn text when using a custom
+    // font, use the getTextBounds() function to determine the smallest
+    // rectangle encompassing a string, erase the area with fillRect(),
+    // then draw new text.  This WILL infortunately 'blink' the text, but
+    // is unavoidable.  Drawing 'background' pixels will NOT fix this,
+    // only creates a new set of problems.  Have an idea to work around
+    // this (a canvas object type for MCUs that can afford the RAM and
+    // displays supporting setAddrWindow() and pushColors()), but haven't
+    // implemented this yet.
+
+    self().startWrite();
+    if(pgm_read_byte(&f->encoding) != GFX_BITMAP_PLAIN) {
+        // Packed glyph: each run of set pixels over a band of identical
+        // rows is one rectangle, decoded straight from flash
+        GFXglyphRuns runs(&bitmap[bo], w, h,
+          pgm_read_byte(&f->encoding));
+        uint8_t rows, len;
+        for(yy=0; (rows = runs.nextBand()); yy+=rows) {
+            while(runs.nextRun(xx, len)) {
+                self().writeFillRect(x+(xo+xx)*size, y+(yo+yy)*size,
+                  len*size, rows*size, color);
+            }
+        }
+        self().endWrite();
+        return;
+    }
+    for(yy=0; yy<h; yy++) {
+        uint8_t run = 0; // Set pixels left of xx, scaled rows only
+        for(xx=0; xx<w; xx++) {
+            if(!(bit++ & 7)) {
+                bits = pgm_read_byte(&bitmap[bo++]);
+            }
+            if(bits & 0x80) {
+                if(size == 1) {
+                    self().writePixel(x+xo+xx, y+yo+yy, color);
+                } else {
+                    run++;
+                }
+            } else if(run) {
+                self().writeFillRect(x+(xo16+xx-run)*size, y+(yo16+yy)*size,
+                  run*size, size, color);
+                run = 0;
+            }
+            bits <<= 1;
+        }
+        if(run) {
+            self().writeFillRect(x+(xo16+xx-run)*size, y+(yo16+yy)*size,
+              run*size, size, color);
+        }
+    }
+    self().endWrite();
+}
+
+// TARGETS ------------------------------------------------------------------
+// Draw into a buffer of the layout of GFXcanvas1/8/16, e.g. the one returned
+// by getBuffer().  The buffer is owned by the caller.
+
+// Rotated coordinates to the ones of the buffer
+#define GFX_CORE_ROTATE(x, y) {                 \
+    int16_t t;                                  \
+    switch(rotation) {                          \
+        case 1:                                 \
+            t = x;                              \
+            x = WIDTH  - 1 - y;                 \
+            y = t;                              \
+            break;                              \
+        case 2:                                 \
+            x = WIDTH  - 1 - x;                 \
+            y = HEIGHT - 1 - y;                 \
+            break;                              \
+        case 3:                                 \
+            t = x;                              \
+            x = y;                              \
+            y = HEIGHT - 1 - t;                 \
+            break;                              \
+    }                                           \
+}
+
+// Lines, rectangles and spans by fillRow(x, y, w, color) and fillColumn(x,
+// y, h, color) of the target, they get buffer coordinates of the visible
+// part.  Lines and rectangles of zero or negative size are dropped, like
+// GFXcanvas1 and the SSD1306 driver do.
+#define GFX_CORE_LINE_FUNCTIONS()                                           \
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {     \
+    if(bufferLine(x, y, h, true)) fillRow(x, y, h, color);                  \
+    else                          fillColumn(x, y, h, color);               \
+  }                                                                         \
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {     \
+    if(bufferLine(x, y, w, false)) fillRow(x, y, w, color);                 \
+    else                           fillColumn(x, y, w, color);              \
+  }                                                                         \
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h,                 \
+          uint16_t color) {                                                 \
+    if(!bufferRect(x, y, w, h)) return;                                     \
+    for(int16_t j=0; j<h; j++) fillRow(x, y+j, w, color);                   \
+  }                                                                         \
+  void fillSpans(const GFXspan *spans, uint16_t count, bool vertical,       \
+          uint16_t color) {                                                 \
+    for(uint16_t i=0; i<count; i++) {                                       \
+      int16_t x = spans[i].x, y = spans[i].y, len = spans[i].len;           \
+      if(bufferSpan(x, y, len, vertical)) fillRow(x, y, len, color);        \
+      else                                fillColumn(x, y, len, color);     \
+    }                                                                       \
+  }                                                                         \
+  bool rowSpans(void) const { return !(rotation & 1); }
+
+// 1 bit per pixel, rows padded to whole bytes, MSB = left pixel
+class GFXcoreCanvas1 : public GFXcore<GFXcoreCanvas1> {
+ public:
+  GFXcoreCanvas1(uint8_t *buffer, uint16_t w, uint16_t h) :
+    GFXcore<GFXcoreCanvas1>(w, h), buffer(buffer) { }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if((x < 0) || (y < 0) || (x >= _width) || (y >= _height)) return;
+    GFX_CORE_ROTATE(x, y);
+    uint8_t *ptr = &buffer[(x / 8) + y * ((WIDTH + 7) / 8)];
+    if(color) *ptr |=   0x80 >> (x & 7);
+    else      *ptr &= ~(0x80 >> (x & 7));
+  }
+  GFX_CORE_LINE_FUNCTIONS()
+
+ private:
+  void fillRow(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    if(w <= 0) return;
+    int16_t  x1   = x + w - 1;
+    uint8_t *row  = &buffer[y * ((WIDTH + 7) / 8)];
+    uint8_t *ptr  = &row[x / 8], *end = &row[x1 / 8];
+    uint8_t  head = 0xFF >> (x & 7), tail = 0xFF << (7 - (x1 & 7));
+    if(ptr == end) head &= tail;
+    uint8_t  fill = color ? 0xFF : 0x00;
+    *ptr = (*ptr & ~head) | (fill & head);
+    if(ptr == end) return;
+    memset(ptr + 1, fill, end - ptr - 1);
+    *end = (*end & ~tail) | (fill & tail);
+  }
+  void fillColumn(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    uint16_t bpl = (WIDTH + 7) / 8;
+    uint8_t *ptr = &buffer[(x / 8) + y * bpl], mask = 0x80 >> (x & 7);
+    if(color) {
+        for(int16_t i=0; i<h; i++, ptr += bpl) *ptr |= mask;
+    } else {
+        for(int16_t i=0; i<h; i++, ptr += bpl) *ptr &= ~mask;
+    }
+  }
+
+  uint8_t *buffer;
+};
+
+// 1 byte per pixel
+class GFXcoreCanvas8 : public GFXcore<GFXcoreCanvas8> {
+ public:
+  GFXcoreCanvas8(uint8_t *buffer, uint16_t w, uint16_t h) :
+    GFXcore<GFXcoreCanvas8>(w, h), buffer(buffer) { }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if((x < 0) || (y < 0) || (x >= _width) || (y >= _height)) return;
+    GFX_CORE_ROTATE(x, y);
+    buffer[x + y * WIDTH] = color;
+  }
+  GFX_CORE_LINE_FUNCTIONS()
+
+ private:
+  void fillRow(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    if(w > 0) memset(&buffer[x + y * WIDTH], color, w);
+  }
+  void fillColumn(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    uint8_t *ptr = &buffer[x + y * WIDTH];
+    for(int16_t i=0; i<h; i++, ptr += WIDTH) *ptr = color;
+  }
+
+  uint8_t *buffer;
+};
+
+// 2 bytes per pixel
+class GFXcoreCanvas16 : public GFXcore<GFXcoreCanvas16> {
+ public:
+  GFXcoreCanvas16(uint16_t *buffer, uint16_t w, uint16_t h) :
+    GFXcore<GFXcoreCanvas16>(w, h), buffer(buffer) { }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if((x < 0) || (y < 0) || (x >= _width) || (y >= _height)) return;
+    GFX_CORE_ROTATE(x, y);
+    buffer[x + y * WIDTH] = color;
+  }
+  GFX_CORE_LINE_FUNCTIONS()
+
+ private:
+  void fillRow(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    uint16_t *ptr = &buffer[x + y * WIDTH];
+    for(int16_t i=0; i<w; i++) ptr[i] = color;
+  }
+  void fillColumn(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    uint16_t *ptr = &buffer[x + y * WIDTH];
+    for(int16_t i=0; i<h; i++, ptr += WIDTH) *ptr = color;
+  }
+
+  uint16_t *buffer;
+};
+
+#endif // _GFXCORE_H_
@@ -8,6 +8,11 @@
 #define _GFXFONT_H_
 
 #include "stdint.h"
+#include "stddef.h"
+
+// Glyph bitmap encodings (GFXfont->encoding)
+#define GFX_BITMAP_PLAIN 0 // Rows bit-packed, MSB first (fonts without the field)
+#define GFX_BITMAP_RLE   1 // Row repeats and pixel runs, see gfxglyphruns.h
 
 typedef struct { // Data stored PER GLYPH
 	uint16_t bitmapOffset;     // Pointer into GFXfont->bitmap
@@ -16,13 +21,92 @@ typedef struct { // Data stored PER GLYPH
 	int8_t   xOffset, yOffset; // Dist from cursor pos to UL corner
 } GFXglyph;
 
+typedef struct { // Extra glyphs of one page of 256 code points
+	uint8_t   page;        // Code point >> 8
+	uint8_t   first, last; // Low byte extents
+	uint16_t  glyph;       // Position of the first glyph in GFXfont->glyph
+	uint8_t  *index;       // Like GFXfont->index, NULL = all
+} GFXcodePage;
+
 typedef struct { // Data stored for FONT AS A WHOLE:
-	uint8_t  *bitmap;      // Glyph bitmaps, concatenated
-	GFXglyph *glyph;       // Glyph array
-	uint8_t   first, last; // ASCII extents
-	uint8_t   yAdvance;    // Newline distance (y axis)
+	uint8_t     *bitmap;      // Glyph bitmaps, concatenated
+	GFXglyph    *glyph;       // Glyph array
+	uint8_t      first, last; // ASCII extents
+	uint8_t      yAdvance;    // Newline distance (y axis)
+	uint8_t      encoding;    // GFX_BITMAP_PLAIN or GFX_BITMAP_RLE
+	uint8_t     *index;       // Subset fonts: glyphs present, NULL = all
+	GFXcodePage *pages;       // Code points beyond first..last, NULL = none
+	uint8_t      pageCount;
 } GFXfont;
 
+// Subset fonts (fontconvert -s/-f) have glyphs for some of the characters
+// between first and last only.  'index' holds two bytes per group of 8
+// characters, starting at 'first': the number of glyphs before the group
+// and one bit per character (LSB = lowest) that has a glyph.
+//
+// Extra code points (fontconvert -u, or UTF-8 in -s/-f), e.g. the degree
+// sign, follow the glyphs of first..last.  They are found in two levels:
+// the page of the code point, then its low byte like a subset character.
+// Characters with a glyph in first..last are found without the pages.
+
+// Set bits of a byte, without a library call on MCUs lacking an instruction
+static inline uint8_t gfxFontBits(uint8_t x) {
+	x = x - ((x >> 1) & 0x55);
+	x = (x & 0x33) + ((x >> 2) & 0x33);
+	return (x + (x >> 4)) & 0x0F;
+}
+
+// Position of c among the glyphs of a range, -1 if it has none
+static inline int16_t gfxFontRangeIndex(const uint8_t *index, uint8_t first,
+  uint8_t last, uint8_t c) {
+	if((c < first) || (c > last)) return -1;
+	uint8_t k = c - first;
+	if(!index) return k;
+
+	const uint8_t *group = &index[(k >> 3) * 2];
+	uint8_t bit = 1 << (k & 7);
+	if(!(group[1] & bit)) return -1;
+	return group[0] + gfxFontBits(group[1] & (bit - 1));
+}
+
+// Number of glyphs of a range
+static inline uint16_t gfxFontRangeCount(const uint8_t *index, uint8_t first,
+  uint8_t last) {
+	if(!index) return last - first + 1;
+
+	const uint8_t *group = &index[((last - first) >> 3) * 2];
+	return group[0] + gfxFontBits(group[1]);
+}
+
+// Position of code point c among the extra glyphs, -1 if the font has none.
+// Not inlined, so gfxFontGlyphIndex() stays small enough to be.
+static __attribute__((noinline, unused))
+int16_t gfxFontPageIndex(const GFXfont *font, uint16_t c) {
+	for(uint8_t p=0; p<font->pageCount; p++) {
+		const GFXcodePage *page = &font->pages[p];
+		if(page->page != (c >> 8)) continue;
+		int16_t i = gfxFontRangeIndex(page->index, page->first, page->last, c & 0xFF);
+		return (i >= 0) ? page->glyph + i : -1;
+	}
+	return -1;
+}
+
+// Position of code point c in GFXfont->glyph, -1 if the font has no glyph
+static inline int16_t gfxFontGlyphIndex(const GFXfont *font, uint16_t c) {
+	int16_t i = (c <= 0xFF) ?
+	  gfxFontRangeIndex(font->index, font->first, font->last, c) : -1;
+	return ((i >= 0) || !font->pages) ? i : gfxFontPageIndex(font, c);
+}
+
+// Number of entries in GFXfont->glyph
+static inline uint16_t gfxFontGlyphCount(const GFXfont *font) {
+	if(!font->pages || !font->pageCount) {
+		return gfxFontRangeCount(font->index, font->first, font->last);
+	}
+	const GFXcodePage *page = &font->pages[font->pageCount - 1];
+	return page->glyph + gfxFontRangeCount(page->index, page->first, page->last);
+}
+
 extern const unsigned char font[];
 
 #endif // _GFXFONT_H_
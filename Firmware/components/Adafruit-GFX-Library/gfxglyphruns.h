@@ -0,0 +1,116 @@
+// Streaming reader for GFXfont glyph bitmaps.
+//
+// A glyph is delivered as bands of identical rows, each band as runs of set
+// pixels.  Both encodings are read in place, there is no glyph sized buffer:
+//
+// GFX_BITMAP_PLAIN: rows of 'width' bits, MSB first, continuous over the
+// glyph (classic fontconvert output).  Every band is a single row.
+//
+// GFX_BITMAP_RLE (fontconvert -c): bit stream, MSB first, starting at the
+// glyph's bitmapOffset and padded to the next byte at its end.
+//   1 bit   literal row format of this glyph: 0 = plain bits, 1 = runs
+//   row 0   literal row
+//   row n   1 bit: 1 = same as the row above, 0 = literal row follows
+// A literal row in 'runs' format is a sequence of 3-bit run lengths,
+// alternating between clear and set pixels and starting with clear (which
+// may be 0).  A length of 7 continues the same run with the next code unless
+// the row is complete.  The row ends as soon as 'width' pixels are covered.
+
+#ifndef _GFXGLYPHRUNS_H_
+#define _GFXGLYPHRUNS_H_
+
+#include "gfxfont.h"
+
+class GFXglyphRuns {
+
+ public:
+
+  GFXglyphRuns(const uint8_t *bitmap, uint8_t width, uint8_t height,
+    uint8_t encoding) : _bits(bitmap), _w(width), _h(height),
+    _packed(encoding == GFX_BITMAP_RLE), _runs(false),
+    _pos(0), _rowPos(0), _nextPos(0), _row(0), _x(0) {
+    if(_packed && _w && _h) _runs = readBit(_nextPos++);
+  }
+
+  // Starts the next band of identical rows, returns its height or 0 at the
+  // end of the glyph.
+  uint8_t nextBand(void) {
+    if((_row >= _h) || !_w) return 0;
+
+    _pos = _nextPos;
+    if(_packed && _row) _pos++; // 'literal row follows' flag
+    _rowPos = _pos;
+    _x      = 0;
+
+    uint8_t rows = 1;
+    if(_packed) {
+      skipRow();
+      while((_row + rows < _h) && readBit(_pos)) {
+        _pos++;
+        rows++;
+      }
+      _nextPos = _pos;
+      _pos     = _rowPos;
+    } else {
+      _nextPos = _pos + _w;
+    }
+    _row += rows;
+    return rows;
+  }
+
+  // Fetches the next run of set pixels of the current band, returns false at
+  // the end of the row.
+  bool nextRun(uint8_t &x, uint8_t &len) {
+    if(_runs) {
+      if(_x >= _w) return false;
+      _x += readRun();        // Clear pixels
+      if(_x >= _w) return false;
+      x    = _x;
+      len  = readRun();       // Set pixels
+      _x  += len;
+      return true;
+    }
+
+    while((_x < _w) && !readBit(_rowPos + _x)) _x++;
+    if(_x >= _w) return false;
+    x = _x;
+    while((_x < _w) && readBit(_rowPos + _x)) _x++;
+    len = _x - x;
+    return true;
+  }
+
+ private:
+
+  inline bool readBit(uint32_t pos) const {
+    return _bits[pos >> 3] & (0x80 >> (pos & 7));
+  }
+
+  uint8_t readRun(void) {
+    uint8_t len = 0, code;
+    do {
+      code = 0;
+      for(uint8_t i=0; i<3; i++, _pos++) {
+        code = (code << 1) | readBit(_pos);
+      }
+      len += code;
+    } while((code == 7) && (_x + len < _w));
+    return len;
+  }
+
+  void skipRow(void) {
+    if(!_runs) {
+      _pos += _w;
+      return;
+    }
+    while(_x < _w) _x += readRun();
+    _x = 0;
+  }
+
+  const uint8_t *_bits;
+  uint8_t  _w, _h;
+  bool     _packed, _runs;
+  uint32_t _pos, _rowPos, _nextPos;
+  uint8_t  _row, _x;
+};
+
+#endif // _GFXGLYPHRUNS_H_
@@ -0,0 +1,23 @@
+// Icon structures for precompiled icon sets, see 'iconconvert' folder.
+// Icons are stored in page order, the native layout of SSD1306-like
+// controllers: (height + 7) / 8 rows of 'width' bytes, each byte is a
+// column of 8 pixels with the LSB on top.  A display with this layout
+// copies an icon that starts on a page boundary byte by byte.
+
+#ifndef _GFXICON_H_
+#define _GFXICON_H_
+
+#include "stdint.h"
+
+typedef struct { // Data stored PER ICON
+	uint16_t bitmapOffset;  // Pointer into GFXiconSet->bitmap
+	uint8_t  width, height; // Bitmap dimensions in pixels
+} GFXicon;
+
+typedef struct { // Data stored for ICON SET AS A WHOLE:
+	uint8_t  *bitmap; // Icon bitmaps, concatenated
+	GFXicon  *icon;   // Icon array
+	uint8_t   count;  // Number of icons
+} GFXiconSet;
+
+#endif // _GFXICON_H_
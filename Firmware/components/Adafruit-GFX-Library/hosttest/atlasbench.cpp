@@ -0,0 +1,121 @@
+/*
+Redraw of the full text area (all 8 pages of the 128x64 frame) by the
+SSD1306 driver against the generic path of Adafruit_GFX (reference.h).
+
+The classic font is blitted from its column layout, the GFX font from a
+GlyphAtlas attached to the driver.  Each case fills every text row of its
+size with characters, the rows are 8 pixels times the size for the classic
+font and yAdvance times the size for the GFX font, the last row may be
+clipped at the bottom.  As the widgets of UiWidgets do, each row is
+cleared first and the text is drawn white without background.  The two are timed in
+turns and the best round of each counts.  Only the frame is written,
+nothing is transmitted.
+
+Output is CSV on stdout, one line per case:
+  case,chars_per_redraw,generic_us,ssd1306_us,speedup,same
+'same' is 1 if both frames are equal.  The exit code is 1 if any of the
+frames differ or the atlas could not be built.
+
+usage: atlasbench [rounds]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#define PROGMEM
+#include "Display_SSD1306.h"
+#include "Fonts/FreeSans9pt7b.h"
+#include "GlyphAtlas.h"
+#include "host.h"
+#include "reference.h"
+
+#define FRAME_SIZE (SSD1306_LCDWIDTH * SSD1306_LCDHEIGHT / 8)
+
+static SpiPort     spi(mode0);
+static OutputPort  dc(HostDcPin);
+static OutputPort  rst(HostResetPin);
+static SSD1306_128x64 display(&spi, &dc, &rst);
+static ReferenceDisplay reference;
+
+static const char Text[] = "T = 23.4 C RH= 45.6 % -0123456789 ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+// Clears each row and fills it with text up to the right edge, returns the number
+// of characters
+template <class G> static int redraw(G & g, const GFXfont * font, uint8_t size) {
+  int16_t advance = font ? font->yAdvance * size : 8 * size;
+  int16_t baseline = font ? advance * 2 / 3 : 0; // Cursor y of GFX fonts is the baseline
+  int chars = 0;
+
+  g.setFont(font);
+  g.setTextSize(size);
+  g.setTextColor(WHITE);
+  g.setTextWrap(false);
+  for (int16_t top = 0; top < g.height(); top += advance) {
+    g.fillRect(0, top, g.width(), advance, BLACK);
+    g.setCursor(0, top + baseline);
+    for (const char * c = Text; *c && (g.getCursorX() < g.width()); c++, chars++)
+      g.write(*c);
+  }
+  return chars;
+}
+
+struct Case {
+  const char * name;
+  const GFXfont * font;
+  uint8_t size;
+};
+
+static const Case cases[] = {
+  { "classic_x1", nullptr, 1 },
+  { "classic_x2", nullptr, 2 },
+  { "classic_x3", nullptr, 3 },
+  { "FreeSans9pt7b_x1", &FreeSans9pt7b, 1 },
+  { "FreeSans9pt7b_x2", &FreeSans9pt7b, 2 },
+  { "FreeSans9pt7b_x3", &FreeSans9pt7b, 3 },
+};
+
+static double now(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+int main(int argc, char * argv[]) {
+  int rounds = (argc > 1) ? atoi(argv[1]) : 20;
+  bool failed = false;
+
+  GlyphAtlas atlas(&FreeSans9pt7b);
+  if (!atlas.IsValid()) {
+    fprintf(stderr, "atlas of FreeSans9pt7b not built\n");
+    return 1;
+  }
+  display.setGlyphAtlas(&atlas);
+
+  printf("case,chars_per_redraw,generic_us,ssd1306_us,speedup,same\n");
+  for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+    const Case & tc = cases[c];
+    display.fillScreen(BLACK);
+    reference.fillScreen(BLACK);
+
+    double bestGeneric = 1e30, bestDriver = 1e30;
+    int chars = 0;
+    for (int r = 0; r < rounds; r++) {
+      double start = now();
+      chars = redraw(reference, tc.font, tc.size);
+      double elapsed = now() - start;
+      if (elapsed < bestGeneric) bestGeneric = elapsed;
+
+      start = now();
+      redraw<SSD1306>(display, tc.font, tc.size);
+      elapsed = now() - start;
+      if (elapsed < bestDriver) bestDriver = elapsed;
+    }
+
+    bool same = !memcmp(display.getBuffer(), reference.getBuffer(), FRAME_SIZE);
+    failed |= !same;
+    printf("%s,%d,%.2f,%.2f,%.1f,%d\n", tc.name, chars, bestGeneric / 1e3, bestDriver / 1e3,
+      bestGeneric / bestDriver, same);
+  }
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,80 @@
+/*
+Bus transactions per operation of the SSD1306 driver.
+
+The driver sends a command sequence as one batch (beginCommands(), cmd(),
+commit()), one transaction with DC low.  Before, every command byte was a
+transaction of its own, as ssd1306_command() still does.  Each operation
+runs on the recording SpiPort of hosttest/, the transactions are counted
+and compared with what one transaction per command byte would have cost.
+
+Output is CSV on stdout, one line per operation:
+  operation,transactions,command_bytes,data_bytes,unbatched_transactions
+*/
+
+#include <stdio.h>
+#include "Display_SSD1306.h"
+#include "host.h"
+#include "panel.h"
+
+static SpiPort     spi(mode0);
+static OutputPort  dc(HostDcPin);
+static OutputPort  rst(HostResetPin);
+static PanelModel  panel;
+static SSD1306_128x64 display(&spi, &dc, &rst);
+
+static uint32_t dataTransactions;
+
+static void countData(bool data, const uint8_t * /*src*/, size_t /*len*/) {
+  dataTransactions += data;
+}
+
+struct Operation {
+  const char * name;
+  void (*run)(void);
+};
+
+static void opInit(void)        { display.Init(); }
+static void opFullFrame(void)   { display.fillScreen(WHITE); display.display(); }
+static void opTwoFields(void) {
+  display.fillRect(24, 16, 24, 16, BLACK);
+  display.fillRect(90, 40, 30, 8, BLACK);
+  display.display();
+}
+static void opNoChange(void)    { display.display(); }
+static void opScrollRight(void) { display.startscrollright(0x00, 0x0F); }
+static void opStopScroll(void)  { display.stopscroll(); }
+static void opDim(void)         { display.dim(true); }
+static void opInvert(void)      { display.invertDisplay(true); }
+static void opScrollArea(void)  { display.setScrollArea(32, 32); }
+static void opStartLine(void)   { display.setStartLine(8); }
+
+static const Operation operations[] = {
+  {"Init",             opInit},
+  {"display_full",     opFullFrame},
+  {"display_2_fields", opTwoFields},
+  {"display_clean",    opNoChange},
+  {"startscrollright", opScrollRight},
+  {"stopscroll",       opStopScroll},
+  {"dim",              opDim},
+  {"invertDisplay",    opInvert},
+  {"setScrollArea",    opScrollArea},
+  {"setStartLine",     opStartLine},
+};
+
+int main(void) {
+  hostPanel = &panel;
+  hostSpiHook = countData;
+
+  printf("operation,transactions,command_bytes,data_bytes,unbatched_transactions\n");
+  for (size_t i = 0; i < sizeof(operations) / sizeof(operations[0]); i++) {
+    display.resetTxStats();
+    dataTransactions = 0;
+    operations[i].run();
+
+    const SSD1306::TxStats & tx = display.txStats();
+    printf("%s,%u,%u,%u,%u\n", operations[i].name, (unsigned)tx.transactions,
+      (unsigned)tx.commandBytes, (unsigned)tx.dataBytes,
+      (unsigned)(tx.commandBytes + dataTransactions));
+  }
+  return (panel.UnknownCommands() == 0) ? 0 : 1;
+}
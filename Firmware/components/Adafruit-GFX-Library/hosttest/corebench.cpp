@@ -0,0 +1,138 @@
+/*
+Line, shape and text throughput of SSD1306Core (rendering core, see
+gfxcore.h) against the virtual functions of SSD1306.
+
+Every case draws a fixed sequence (seeded generator) on two displays, one
+through SSD1306 (virtual), the other through a SSD1306Core on it.  The core
+is created once at startup, rotation and font are set on the displays
+afterwards, for each case.  The two are timed in turns, the best round of
+each counts.  Only the frame is written, nothing is transmitted.
+Afterwards the frames are compared.
+
+Output is CSV on stdout, one line per case and rotation:
+  case,virtual_ns_per_op,core_ns_per_op,speedup,same
+The exit code is 1 if any of the frames differ.
+
+usage: corebench [rounds]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#define PROGMEM
+#include "Display_SSD1306.h"
+#include "Fonts/FreeSans9pt7b.h"
+#include "host.h"
+
+#define OPS        256 // Operations per sequence
+#define FRAME_SIZE (SSD1306_LCDWIDTH * SSD1306_LCDHEIGHT / 8)
+
+static SpiPort     spi(mode0);
+static OutputPort  dc(HostDcPin);
+static OutputPort  rst(HostResetPin);
+
+static SSD1306_128x64 display(&spi, &dc, &rst);
+static SSD1306_128x64 coreDisplay(&spi, &dc, &rst);
+static SSD1306Core    core(&coreDisplay);
+
+struct Args {
+  int16_t x0, y0, x1, y1, r;
+  uint8_t c;
+  uint16_t color;
+};
+static Args args[OPS];
+
+// Mostly on screen, some primitives cross the edges
+static void makeArgs(void) {
+  srand(1306);
+  for (int i = 0; i < OPS; i++) {
+    args[i].x0 = rand() % 144 - 8;
+    args[i].y0 = rand() % 144 - 8;
+    args[i].x1 = rand() % 144 - 8;
+    args[i].y1 = rand() % 144 - 8;
+    args[i].r = rand() % 30 + 1;
+    args[i].c = 'A' + rand() % 26;
+    args[i].color = rand() % 3;
+  }
+}
+
+// G is SSD1306 for the virtual calls or SSD1306Core
+template <class G> static void opLine(G & g, const Args & a) { g.drawLine(a.x0, a.y0, a.x1, a.y1, a.color); }
+template <class G> static void opCircle(G & g, const Args & a) { g.drawCircle(a.x0, a.y0, a.r, a.color); }
+template <class G> static void opFillCircle(G & g, const Args & a) { g.fillCircle(a.x0, a.y0, a.r, a.color); }
+template <class G> static void opFillTriangle(G & g, const Args & a) {
+  g.fillTriangle(a.x0, a.y0, a.x1, a.y1, a.x0 + a.r, a.y1 - a.r, a.color);
+}
+template <class G> static void opChar(G & g, const Args & a) { g.drawChar(a.x0, a.y0, a.c, WHITE, BLACK, 1); }
+template <class G> static void opCharFont(G & g, const Args & a) { g.drawChar(a.x0, a.y0, a.c, a.color, a.color, 1); }
+
+template <class G> static void run(G & gfx, void (*op)(G &, const Args &)) {
+  for (int i = 0; i < OPS; i++) op(gfx, args[i]);
+}
+
+struct Case {
+  const char * name;
+  const GFXfont * font;
+  void (*runVirtual)(void);
+  void (*runCore)(void);
+};
+
+#define CASE(name, font, op)                                \
+  { name, font,                                             \
+    [] { run<SSD1306>(display, op<SSD1306>); },             \
+    [] { run<SSD1306Core>(core, op<SSD1306Core>); } }
+
+static const Case cases[] = {
+  CASE("drawLine",           nullptr,        opLine),
+  CASE("drawCircle",         nullptr,        opCircle),
+  CASE("fillCircle",         nullptr,        opFillCircle),
+  CASE("fillTriangle",       nullptr,        opFillTriangle),
+  CASE("drawChar_classic",   nullptr,        opChar),
+  CASE("drawChar_FreeSans9", &FreeSans9pt7b, opCharFont),
+};
+
+static double now(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+int main(int argc, char * argv[]) {
+  int rounds = (argc > 1) ? atoi(argv[1]) : 20;
+  bool failed = false;
+
+  makeArgs();
+
+  printf("case,virtual_ns_per_op,core_ns_per_op,speedup,same\n");
+  for (uint8_t rotation = 0; rotation < 4; rotation++) {
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+      const Case & tc = cases[c];
+      display.setRotation(rotation);
+      coreDisplay.setRotation(rotation);
+      display.setFont(tc.font);
+      coreDisplay.setFont(tc.font);
+      display.fillScreen(BLACK);
+      coreDisplay.fillScreen(BLACK);
+
+      double bestVirtual = 1e30, bestCore = 1e30;
+      for (int r = 0; r < rounds; r++) {
+        double start = now();
+        tc.runVirtual();
+        double elapsed = now() - start;
+        if (elapsed < bestVirtual) bestVirtual = elapsed;
+
+        start = now();
+        tc.runCore();
+        elapsed = now() - start;
+        if (elapsed < bestCore) bestCore = elapsed;
+      }
+
+      bool same = !memcmp(display.getBuffer(), coreDisplay.getBuffer(), FRAME_SIZE);
+      failed |= !same;
+      printf("%s_rot%d,%.1f,%.1f,%.2f,%d\n", tc.name, rotation, bestVirtual / OPS, bestCore / OPS,
+        bestVirtual / bestCore, same);
+    }
+  }
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,119 @@
+/*
+Test of the dirty region tracking of the SSD1306 driver.
+
+display() has to transmit exactly the regions that were modified since
+the last call: a COLUMNADDR/PAGEADDR window per run of pages with the same
+column range, nothing if nothing changed.  The SPI transactions are
+recorded (hal.cpp) and decoded by the panel model, after every display()
+the RAM of the panel has to equal the frame buffer.
+
+Prints one line per check and the traffic of a few typical updates, the
+exit code is 1 if a check fails.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Display_SSD1306.h"
+#include "host.h"
+#include "panel.h"
+
+static SpiPort     spi(mode0);
+static OutputPort  dc(HostDcPin);
+static OutputPort  rst(HostResetPin);
+static PanelModel  panel;
+static SSD1306_128x64 display(&spi, &dc, &rst);
+
+static bool failed = false;
+
+static void check(bool ok, const char * what) {
+  printf("%s: %s\n", ok ? "ok  " : "FAIL", what);
+  failed |= !ok;
+}
+
+static bool ramSame(void) {
+  return !memcmp(panel.Ram(), display.getBuffer(), PanelModel::Pages * PanelModel::Width);
+}
+
+// Data bytes of the next display()
+static uint32_t flush(void) {
+  display.resetTxStats();
+  display.display();
+  return display.txStats().dataBytes;
+}
+
+// Windows of the last display(): COLUMNADDR and PAGEADDR commands
+struct Window { uint8_t col0, col1, page0, page1; };
+static Window windows[64];
+static int    windowCount;
+
+static void recordWindows(bool data, const uint8_t * src, size_t len) {
+  if (data || (len != 6) || (src[0] != SSD1306_COLUMNADDR) || (src[3] != SSD1306_PAGEADDR))
+    return;
+  if (windowCount < (int)(sizeof(windows) / sizeof(windows[0])))
+    windows[windowCount] = {src[1], src[2], src[4], src[5]};
+  windowCount++;
+}
+
+int main(void) {
+  hostPanel = &panel;
+  hostSpiHook = recordWindows;
+  display.Init();
+
+  check(flush() == 1024, "first display() sends the whole frame");
+  check(ramSame(), "panel RAM equals the frame buffer");
+  check(flush() == 0 && display.txStats().transactions == 0, "display() without changes sends nothing");
+
+  windowCount = 0;
+  display.drawPixel(37, 21, WHITE);
+  check(flush() == 1, "a pixel sends one byte");
+  check((windowCount == 1) && (windows[0].col0 == 37) && (windows[0].col1 == 37) &&
+        (windows[0].page0 == 2) && (windows[0].page1 == 2), "in a window of its column and page");
+
+  // Two numeric fields of the status screen, 6 pixels per character
+  display.setTextColor(WHITE, BLACK);
+  display.setCursor(24, 16);
+  display.print("21.5");
+  display.setCursor(24, 24);
+  display.print("45.0");
+  windowCount = 0;
+  uint32_t bytes = flush();
+  printf("two numeric fields: %u data bytes, %d windows\n", (unsigned)bytes, windowCount);
+  check(bytes == 2 * 4 * 6, "two fields send their columns of two pages");
+  check(windowCount == 1, "pages with the same columns share a window");
+  check(ramSame(), "panel RAM equals the frame buffer");
+
+  windowCount = 0;
+  display.drawFastHLine(0, 3, 10, WHITE);
+  display.drawFastHLine(100, 60, 28, WHITE);
+  bytes = flush();
+  check((bytes == 38) && (windowCount == 2), "separate regions get a window each");
+
+  // Random primitives in all rotations, the panel has to follow the buffer
+  srand(1306);
+  bool same = true;
+  uint32_t total = 0;
+  for (int round = 0; round < 400; round++) {
+    display.setRotation(round & 3);
+    for (int i = 0; i < 3; i++) {
+      int16_t x = rand() % 160 - 16, y = rand() % 96 - 16;
+      int16_t w = rand() % 40, h = rand() % 30;
+      uint16_t color = rand() % 3;
+      switch (rand() % 5) {
+        case 0: display.drawPixel(x, y, color); break;
+        case 1: display.drawLine(x, y, x + w, y + h, color); break;
+        case 2: display.fillRect(x, y, w, h, color); break;
+        case 3: display.drawCircle(x, y, h / 2, color); break;
+        case 4: display.setCursor(x, y); display.print("Ab3"); break;
+      }
+    }
+    total += flush();
+    same &= ramSame();
+  }
+  display.setRotation(0);
+  printf("400 random updates: %u data bytes, %u per update\n", (unsigned)total, (unsigned)(total / 400));
+  check(same, "panel RAM equals the frame buffer after random updates in all rotations");
+  check(panel.UnknownCommands() == 0, "only known commands were sent");
+
+  return failed ? 1 : 0;
+}
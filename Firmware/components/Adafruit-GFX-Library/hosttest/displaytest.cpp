@@ -0,0 +1,167 @@
+/*
+Golden image test of the display stack on the host.
+
+MyDisplay runs on a SSD1306_128x64 whose SPI port is a recording fake
+(hal.cpp).  The transmitted commands and data are decoded by a model of
+the panel (panel.h), after every step of the scenario below the image on
+the model is written to out/<step>.pbm and compared with
+golden/<step>.pbm.  A difference is written to out/<step>.diff.pbm, 1 =
+pixel differs.
+
+Besides the image each step checks that the RAM of the panel equals the
+frame buffer of the driver, i.e. no modified region was left out, and
+reports the traffic of the update.
+
+Output is CSV on stdout, one line per step:
+  step,transactions,command_bytes,data_bytes,diff_pixels,ram_same
+The exit code is 1 if any image differs or a golden image is missing.
+
+usage: displaytest [-u]
+  -u  writes the images as new golden images instead of comparing them
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "Display_SSD1306.h"
+#include "MyDisplay.h"
+#include "host.h"
+#include "panel.h"
+
+#define GOLDEN_DIR "golden"
+#define OUT_DIR    "out"
+
+static SpiPort     spi(mode0);
+static OutputPort  dc(HostDcPin);
+static OutputPort  rst(HostResetPin);
+static PanelModel  panel;
+static SSD1306_128x64 display(&spi, &dc, &rst);
+
+// Steps work on the UI, the image is taken afterwards
+struct Step {
+  const char * name;
+  void (*run)(MyDisplay & ui);
+};
+
+static void stepFrame(MyDisplay & ui) {
+  ui.PrintInitFrame(true, true, 0.8f);
+}
+
+static void stepValues(MyDisplay & ui) {
+  ui.SetValues(21.5f, 45.0f);
+  ui.Update();
+}
+
+// One sample per minute, a slow rise and a dip of the humidity
+static void stepTrend(MyDisplay & ui) {
+  for (int i = 0; i < 60; i++) {
+    hostTicks += 60000 / portTICK_PERIOD_MS;
+    ui.SetValues(21.5f + i * 0.05f, 45.0f - ((i > 20) && (i < 35) ? 8.0f : 0.0f));
+    ui.Update();
+  }
+}
+
+static void stepLog(MyDisplay & ui) {
+  ui.PrintLogLine("Boot ok");
+  ui.PrintLogLine("WiFi connected");
+}
+
+// More lines than the log area holds, the panel scrolls by the start line
+static void stepLogScroll(MyDisplay & ui) {
+  static const char * lines[] = {"MQTT connected", "SNTP synced", "Door open", "Door closed",
+                                 "Supply lost"};
+  for (size_t i = 0; i < sizeof(lines) / sizeof(lines[0]); i++)
+    ui.PrintLogLine(lines[i]);
+}
+
+static void stepStatus(MyDisplay & ui) {
+  ui.SetStatus(true, false, 0.3f);
+  ui.SetSignal(-72);
+  ui.Update();
+}
+
+static void stepRange(MyDisplay & ui) {
+  ui.ShowScreen(MyDisplay::ScreenRange);
+}
+
+static void stepNetwork(MyDisplay & ui) {
+  ui.SetAddress("192.168.1.17");
+  ui.NextScreen();
+}
+
+static void stepOffline(MyDisplay & ui) {
+  ui.SetStatus(false, false, 0.05f);
+  ui.Update();
+}
+
+static void stepValuesAgain(MyDisplay & ui) {
+  ui.NextScreen();
+}
+
+static const Step steps[] = {
+  {"frame",       stepFrame},
+  {"values",      stepValues},
+  {"trend",       stepTrend},
+  {"log",         stepLog},
+  {"log_scroll",  stepLogScroll},
+  {"status",      stepStatus},
+  {"range",       stepRange},
+  {"network",     stepNetwork},
+  {"offline",     stepOffline},
+  {"values_back", stepValuesAgain},
+};
+
+int main(int argc, char * argv[]) {
+  bool update = (argc > 1) && !strcmp(argv[1], "-u");
+  bool failed = false;
+  char path[256];
+
+  mkdir(OUT_DIR, 0755);
+  hostPanel = &panel;
+  MyDisplay ui(&display);
+
+  printf("step,transactions,command_bytes,data_bytes,diff_pixels,ram_same\n");
+  for (size_t s = 0; s < sizeof(steps) / sizeof(steps[0]); s++) {
+    const Step & step = steps[s];
+    static uint8_t image[PanelModel::Width * PanelModel::Height];
+    static uint8_t golden[PanelModel::Width * PanelModel::Height];
+
+    display.resetTxStats();
+    step.run(ui);
+    panel.Image(image);
+
+    snprintf(path, sizeof(path), "%s/%s.pbm", OUT_DIR, step.name);
+    writePbm(path, image, PanelModel::Width, PanelModel::Height);
+
+    int diff = 0;
+    snprintf(path, sizeof(path), "%s/%s.pbm", GOLDEN_DIR, step.name);
+    if (update) {
+      if (!writePbm(path, image, PanelModel::Width, PanelModel::Height)) {
+        fprintf(stderr, "%s: can't write\n", path);
+        failed = true;
+      }
+    } else if (!readPbm(path, golden, PanelModel::Width, PanelModel::Height)) {
+      fprintf(stderr, "%s: missing or not a %dx%d PBM image\n", path,
+        PanelModel::Width, PanelModel::Height);
+      diff = -1;
+    } else {
+      diff = diffImages(image, golden, PanelModel::Width, PanelModel::Height, golden);
+      if (diff) {
+        snprintf(path, sizeof(path), "%s/%s.diff.pbm", OUT_DIR, step.name);
+        writePbm(path, golden, PanelModel::Width, PanelModel::Height);
+      }
+    }
+
+    bool ramSame = !memcmp(panel.Ram(), display.getBuffer(), PanelModel::Pages * PanelModel::Width);
+    const SSD1306::TxStats & tx = display.txStats();
+    printf("%s,%u,%u,%u,%d,%d\n", step.name, (unsigned)tx.transactions, (unsigned)tx.commandBytes,
+      (unsigned)tx.dataBytes, diff, ramSame);
+    failed |= (diff != 0) || !ramSame;
+  }
+
+  if (panel.UnknownCommands()) {
+    fprintf(stderr, "%u unknown command bytes\n", (unsigned)panel.UnknownCommands());
+    failed = true;
+  }
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,169 @@
+/*
+Pixels per second of the fill, shape, blit, dither and text functions of
+the SSD1306 driver against the generic path of Adafruit_GFX (reference.h).
+
+Every case draws a fixed sequence (seeded generator) into the frame of
+both, the two are timed in turns and the best round of each counts.
+Only the frame is written, nothing is transmitted.  The pixels of a case
+are the ones covered by the primitives, e.g. w*h of a rectangle or the
+cell of a character.  The generic path of the gray images is the pixel by
+pixel dithering of the reference, one case per dither mode.  Cases ending
+in _rot1 draw in rotation 1 (64x128), where rows of the panel are columns.
+
+Output is CSV on stdout, one line per case:
+  case,pixels_per_op,generic_mpixel_s,ssd1306_mpixel_s,speedup,same
+'same' is 1 if both frames are equal.
+
+usage: fillbench [rounds]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Display_SSD1306.h"
+#include "host.h"
+#include "reference.h"
+
+#define OPS        256 // Operations per sequence
+#define FRAME_SIZE (SSD1306_LCDWIDTH * SSD1306_LCDHEIGHT / 8)
+
+static SpiPort     spi(mode0);
+static OutputPort  dc(HostDcPin);
+static OutputPort  rst(HostResetPin);
+static SSD1306_128x64 display(&spi, &dc, &rst);
+static ReferenceDisplay reference;
+
+static uint8_t bitmap[4 * 16]; // 32x16 pixels, drawBitmap() layout
+static uint8_t gray[32 * 16];  // 32x16 pixels, one byte per pixel
+
+struct Args {
+  int16_t x, y;
+  uint8_t c;
+  uint16_t color;
+};
+static Args args[OPS];
+static Args rotatedArgs[OPS];
+static const Args * current = args;
+
+// On screen in rotation 0 and 1 (64x128), y not page aligned
+static void makeArgs(void) {
+  srand(1306);
+  for (int i = 0; i < OPS; i++) {
+    args[i].x = rand() % 96;
+    args[i].y = rand() % 48;
+    args[i].c = 'A' + rand() % 26;
+    args[i].color = rand() % 2;
+    rotatedArgs[i] = args[i];
+    rotatedArgs[i].x = args[i].x / 3;
+    rotatedArgs[i].y = args[i].y * 2 + args[i].x % 17;
+  }
+  for (size_t i = 0; i < sizeof(bitmap); i++)
+    bitmap[i] = rand();
+  for (size_t i = 0; i < sizeof(gray); i++)
+    gray[i] = (i % 32) * 8 + rand() % 16;
+}
+
+// G is the driver or the reference, the calls are virtual on both
+template <class G> static void opFillRect(G & g, const Args & a)  { g.fillRect(a.x, a.y, 30, 13, a.color); }
+template <class G> static void opFillScreen(G & g, const Args & a) { g.fillScreen(a.color); }
+template <class G> static void opFillCircle(G & g, const Args & a) { g.fillCircle(a.x + 8, a.y + 8, 8, a.color); }
+template <class G> static void opFillTriangle(G & g, const Args & a) {
+  g.fillTriangle(a.x, a.y + 15, a.x + 15, a.y, a.x + 31, a.y + 11, a.color);
+}
+template <class G> static void opFillRoundRect(G & g, const Args & a) { g.fillRoundRect(a.x, a.y, 32, 16, 5, a.color); }
+template <class G> static void opHLine(G & g, const Args & a)     { g.drawFastHLine(a.x, a.y, 32, a.color); }
+template <class G> static void opBitmap(G & g, const Args & a) {
+  g.drawBitmap(a.x, a.y, (const uint8_t *)bitmap, 32, 16, WHITE, BLACK);
+}
+template <class G> static void opBitmapTransparent(G & g, const Args & a) {
+  g.drawBitmap(a.x, a.y, (const uint8_t *)bitmap, 32, 16, a.color);
+}
+template <SSD1306::GrayDither Dither, class G> static void opGray(G & g, const Args & a) {
+  g.setGrayDither(Dither);
+  g.drawGrayscaleBitmap(a.x, a.y, gray, 32, 16);
+}
+template <class G> static void opGrayBayer4(G & g, const Args & a)    { opGray<SSD1306::DitherBayer4>(g, a); }
+template <class G> static void opGrayBayer8(G & g, const Args & a)    { opGray<SSD1306::DitherBayer8>(g, a); }
+template <class G> static void opGrayDiffusion(G & g, const Args & a) { opGray<SSD1306::DitherDiffusion>(g, a); }
+template <class G> static void opChar(G & g, const Args & a)  { g.drawChar(a.x, a.y, a.c, WHITE, BLACK, 1); }
+template <class G> static void opChar2(G & g, const Args & a) { g.drawChar(a.x, a.y, a.c, WHITE, BLACK, 2); }
+
+struct Case {
+  const char * name;
+  int pixels;
+  uint8_t rotation;
+  void (*runGeneric)(void);
+  void (*runDriver)(void);
+};
+
+template <void (*Op)(ReferenceDisplay &, const Args &)> static void runGeneric(void) {
+  for (int i = 0; i < OPS; i++) Op(reference, current[i]);
+}
+template <void (*Op)(SSD1306 &, const Args &)> static void runDriver(void) {
+  for (int i = 0; i < OPS; i++) Op(display, current[i]);
+}
+
+#define CASE(name, pixels, op) { name, pixels, 0, runGeneric<op<ReferenceDisplay>>, runDriver<op<SSD1306>> }
+#define ROTATED(name, pixels, op) { name, pixels, 1, runGeneric<op<ReferenceDisplay>>, runDriver<op<SSD1306>> }
+
+static const Case cases[] = {
+  CASE("fillRect_30x13",               30 * 13,   opFillRect),
+  CASE("fillScreen",                   128 * 64,  opFillScreen),
+  CASE("fillCircle_r8",                221,       opFillCircle),
+  ROTATED("fillCircle_r8_rot1",        221,       opFillCircle),
+  CASE("fillTriangle_32x16",           215,       opFillTriangle),
+  ROTATED("fillTriangle_32x16_rot1",   215,       opFillTriangle),
+  CASE("fillRoundRect_32x16",          488,       opFillRoundRect),
+  ROTATED("fillRoundRect_32x16_rot1",  488,       opFillRoundRect),
+  CASE("drawFastHLine_32",             32,        opHLine),
+  CASE("drawBitmap_32x16",             32 * 16,   opBitmap),
+  CASE("drawBitmap_32x16_transp",      32 * 16,   opBitmapTransparent),
+  CASE("drawGray_32x16_bayer4",        32 * 16,   opGrayBayer4),
+  CASE("drawGray_32x16_bayer8",        32 * 16,   opGrayBayer8),
+  CASE("drawGray_32x16_diffusion",     32 * 16,   opGrayDiffusion),
+  CASE("drawChar_classic",             6 * 8,     opChar),
+  CASE("drawChar_classic_x2",          12 * 16,   opChar2),
+};
+
+static double now(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+int main(int argc, char * argv[]) {
+  int rounds = (argc > 1) ? atoi(argv[1]) : 20;
+  bool failed = false;
+
+  makeArgs();
+  printf("case,pixels_per_op,generic_mpixel_s,ssd1306_mpixel_s,speedup,same\n");
+  for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+    const Case & tc = cases[c];
+    current = tc.rotation ? rotatedArgs : args;
+    display.setRotation(tc.rotation);
+    reference.setRotation(tc.rotation);
+    display.fillScreen(BLACK);
+    reference.fillScreen(BLACK);
+
+    double bestGeneric = 1e30, bestDriver = 1e30;
+    for (int r = 0; r < rounds; r++) {
+      double start = now();
+      tc.runGeneric();
+      double elapsed = now() - start;
+      if (elapsed < bestGeneric) bestGeneric = elapsed;
+
+      start = now();
+      tc.runDriver();
+      elapsed = now() - start;
+      if (elapsed < bestDriver) bestDriver = elapsed;
+    }
+
+    bool same = !memcmp(display.getBuffer(), reference.getBuffer(), FRAME_SIZE);
+    failed |= !same;
+    double pixels = (double)tc.pixels * OPS * 1e3; // Per ns -> Mpixel/s
+    printf("%s,%d,%.1f,%.1f,%.1f,%d\n", tc.name, tc.pixels, pixels / bestGeneric,
+      pixels / bestDriver, bestGeneric / bestDriver, same);
+  }
+  return failed ? 1 : 0;
+}
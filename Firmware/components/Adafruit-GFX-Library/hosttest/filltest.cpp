@@ -0,0 +1,214 @@
+/*
+Golden image test of the fill, blit and text functions of the SSD1306
+driver.
+
+The driver works on whole page bytes where it can.  Its output has to be
+pixel identical to the generic path of Adafruit_GFX (reference.h):
+random fillRect(), fillScreen(), fast lines, drawBitmap(), drawChar(),
+fillCircle(), fillRoundRect() and fillTriangle() calls, partly off
+screen, are drawn on both in all rotations and the frames are compared.
+So are random gray images, dithered with each mode (Bayer 4x4, Bayer 8x8,
+Floyd-Steinberg), with and without a mask.  A fixed scene is then
+transmitted to the panel model and compared with golden/primitives.pbm.
+
+Prints one line per check, the exit code is 1 if one fails.
+
+usage: filltest [-u]
+  -u  writes the image of the scene as new golden image
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#define PROGMEM
+#include "Display_SSD1306.h"
+#include "Fonts/FreeSans9pt7b.h"
+#include "host.h"
+#include "panel.h"
+#include "reference.h"
+
+#define FRAME_SIZE (PanelModel::Pages * PanelModel::Width)
+#define GOLDEN     "golden/primitives.pbm"
+
+static SpiPort     spi(mode0);
+static OutputPort  dc(HostDcPin);
+static OutputPort  rst(HostResetPin);
+static PanelModel  panel;
+static SSD1306_128x64 display(&spi, &dc, &rst);
+static ReferenceDisplay reference;
+
+static uint8_t bitmap[8 * 40]; // Up to 64x40 pixels, drawBitmap() layout
+static uint8_t gray[64 * 40];  // Up to 64x40 pixels, one byte per pixel
+static uint8_t mask[8 * 40];   // Mask of the gray image, drawBitmap() layout
+
+static bool failed = false;
+
+static void check(bool ok, const char * what) {
+  printf("%s: %s\n", ok ? "ok  " : "FAIL", what);
+  failed |= !ok;
+}
+
+// Random triangle from the primitive arguments, a[5] picks the kind:
+// general, flat top or bottom, or degenerate (one row, a line or a point)
+template <class G> static void triangle(G & gfx, const int16_t * a, uint16_t color) {
+  int16_t x0 = a[0], y0 = a[1];
+  int16_t x1 = a[0] + a[2] - 32, y1 = a[1] + a[3];
+  int16_t x2 = a[0] + a[4] - 47, y2 = a[1] + a[3] / 2 - 10;
+  if (a[5] == 1) {
+    y1 = (a[4] & 1) ? y0 : y2;
+  } else if (a[5] == 2) {
+    switch (a[4] & 3) {
+      case 0: y1 = y2 = y0; break;                       // One row
+      case 1: x2 = 2 * x1 - x0; y2 = 2 * y1 - y0; break; // Collinear
+      case 2: x1 = x2 = x0; break;                       // One column
+      case 3: x1 = x2 = x0; y1 = y2 = y0; break;         // One point
+    }
+  }
+  gfx.fillTriangle(x0, y0, x1, y1, x2, y2, color);
+}
+
+// One random primitive on both, G is the driver or the reference
+template <class G> static void draw(G & gfx, int op, const int16_t * a, uint16_t color, uint16_t bg) {
+  switch (op) {
+    case 0: gfx.fillRect(a[0], a[1], a[2], a[3], color); break;
+    case 1: gfx.drawFastHLine(a[0], a[1], a[2], color); break;
+    case 2: gfx.drawFastVLine(a[0], a[1], a[3], color); break;
+    case 3: gfx.drawBitmap(a[0], a[1], (const uint8_t *)bitmap, a[2], a[3], color); break;
+    case 4: gfx.drawBitmap(a[0], a[1], (const uint8_t *)bitmap, a[2], a[3], color, bg); break;
+    case 5: gfx.drawBitmap(a[0], a[1], bitmap, a[2], a[3], color, bg); break;
+    case 6: gfx.drawChar(a[0], a[1], ' ' + a[4], color, bg, 1 + a[5]); break;
+    case 7: gfx.drawChar(a[0], a[1], ' ' + a[4], color, color, 1 + a[5]); break;
+    case 8: gfx.fillCircle(a[0], a[1], a[3] / 2, color); break;
+    case 9: gfx.fillRoundRect(a[0], a[1], a[2], a[3], a[3] / 4, color); break;
+    case 10: triangle(gfx, a, color); break;
+  }
+}
+
+static bool compareRandom(int rounds) {
+  bool same = true;
+
+  srand(4);
+  for (size_t i = 0; i < sizeof(bitmap); i++)
+    bitmap[i] = rand();
+
+  for (int r = 0; r < rounds; r++) {
+    uint8_t rotation = r & 3;
+    display.setRotation(rotation);
+    reference.setRotation(rotation);
+    if ((r % 50) == 0) {
+      display.fillScreen(r & 1);
+      reference.fillScreen(r & 1);
+    }
+
+    for (int i = 0; i < 20; i++) {
+      int16_t a[6] = {(int16_t)(rand() % 150 - 11), (int16_t)(rand() % 150 - 11),
+                      (int16_t)(rand() % 64 + 1),   (int16_t)(rand() % 40 + 1),
+                      (int16_t)(rand() % 95),       (int16_t)(rand() % 3)};
+      int op = rand() % 11;
+      uint16_t color = rand() % 3;
+      uint16_t bg = rand() % 2;
+      if (color == INVERSE)
+        bg = INVERSE; // An opaque inverse glyph inverts every pixel once
+      draw(display, op, a, color, bg);
+      draw(reference, op, a, color, bg);
+    }
+    same &= !memcmp(display.getBuffer(), reference.getBuffer(), FRAME_SIZE);
+  }
+  display.setRotation(0);
+  reference.setRotation(0);
+  return same;
+}
+
+// Gradients with noise, so every threshold and error is met
+static bool compareDithered(int rounds) {
+  static const SSD1306::GrayDither Modes[] = {SSD1306::DitherBayer4, SSD1306::DitherBayer8, SSD1306::DitherDiffusion};
+  bool same = true;
+
+  srand(20);
+  for (size_t i = 0; i < sizeof(gray); i++)
+    gray[i] = ((i % 64) * 4 + (i / 64) * 3 + rand() % 48) & 0xFF;
+
+  for (int r = 0; r < rounds; r++) {
+    uint8_t rotation = r & 3;
+    display.setRotation(rotation);
+    reference.setRotation(rotation);
+    display.setGrayDither(Modes[(r / 4) % 3]);
+    reference.setGrayDither(Modes[(r / 4) % 3]);
+    display.fillScreen(r & 1);
+    reference.fillScreen(r & 1);
+
+    for (int i = 0; i < 8; i++) {
+      int16_t x = rand() % 150 - 11, y = rand() % 150 - 11;
+      int16_t w = rand() % 64 + 1, h = rand() % 40 + 1;
+      if (rand() & 1) {
+        for (size_t k = 0; k < sizeof(mask); k++)
+          mask[k] = rand();
+        display.drawGrayscaleBitmap(x, y, gray, mask, w, h);
+        reference.drawGrayscaleBitmap(x, y, gray, mask, w, h);
+      } else {
+        display.drawGrayscaleBitmap(x, y, gray, w, h);
+        reference.drawGrayscaleBitmap(x, y, gray, w, h);
+      }
+    }
+    same &= !memcmp(display.getBuffer(), reference.getBuffer(), FRAME_SIZE);
+  }
+  display.setRotation(0);
+  reference.setRotation(0);
+  display.setGrayDither(SSD1306::DitherBayer8);
+  return same;
+}
+
+static void drawScene(void) {
+  display.fillScreen(BLACK);
+  display.fillRect(0, 0, 128, 13, WHITE);
+  display.setTextColor(BLACK);
+  display.setTextSize(1);
+  display.setCursor(3, 3);
+  display.print("fillRect/drawChar");
+  display.fillRect(3, 17, 20, 27, WHITE);
+  display.fillRect(7, 21, 12, 19, INVERSE);
+  display.drawBitmap(27, 19, (const uint8_t *)bitmap, 27, 14, WHITE, BLACK);
+  display.drawBitmap(58, 21, (const uint8_t *)bitmap, 19, 11, WHITE);
+  display.setTextColor(WHITE, BLACK);
+  display.setTextSize(2);
+  display.setCursor(80, 17);
+  display.print("x2");
+  display.setTextSize(3);
+  display.setCursor(27, 38);
+  display.print("x3");
+  display.setTextSize(1);
+  display.setFont(&FreeSans9pt7b);
+  display.setCursor(66, 58);
+  display.print("Sans");
+  display.setFont(nullptr);
+  display.drawFastHLine(0, 63, 128, WHITE);
+  display.drawFastVLine(127, 14, 49, INVERSE);
+}
+
+int main(int argc, char * argv[]) {
+  bool update = (argc > 1) && !strcmp(argv[1], "-u");
+  static uint8_t image[PanelModel::Width * PanelModel::Height];
+  static uint8_t golden[PanelModel::Width * PanelModel::Height];
+
+  check(compareRandom(2000), "2000 rounds of random fills, shapes, blits and characters equal the generic path");
+  check(compareDithered(1200), "dithered gray images equal the pixel by pixel dithering in all modes and rotations");
+
+  hostPanel = &panel;
+  display.Init();
+  drawScene();
+  display.display();
+  panel.Image(image);
+  check(!memcmp(panel.Ram(), display.getBuffer(), FRAME_SIZE), "panel RAM equals the frame buffer");
+
+  if (update) {
+    check(writePbm(GOLDEN, image, PanelModel::Width, PanelModel::Height), "golden image written");
+  } else if (!readPbm(GOLDEN, golden, PanelModel::Width, PanelModel::Height)) {
+    check(false, GOLDEN " is readable");
+  } else {
+    int diff = diffImages(image, golden, PanelModel::Width, PanelModel::Height, nullptr);
+    if (diff)
+      writePbm("out/primitives.pbm", image, PanelModel::Width, PanelModel::Height);
+    check(diff == 0, "scene equals " GOLDEN);
+  }
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,128 @@
+/*
+Line, circle and text throughput of SSD1306Fixed (rotation fixed at
+compile time) against SSD1306 with the same rotation set at runtime.
+
+Every case draws a fixed sequence (seeded generator) on both, the runtime
+display is called through SSD1306 (virtual), the fixed one through its
+own type.  The two are timed in turns, the best round of each counts.
+Only the frame is written, nothing is transmitted.  Afterwards the frames
+are compared.
+
+Output is CSV on stdout, one line per case:
+  case,runtime_ns_per_op,fixed_ns_per_op,speedup,same
+The exit code is 1 if any of the frames differ.
+
+usage: fixedbench [rounds]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Display_SSD1306Fixed.h"
+#include "host.h"
+
+#define OPS        256 // Operations per sequence
+#define FRAME_SIZE (SSD1306_LCDWIDTH * SSD1306_LCDHEIGHT / 8)
+
+static SpiPort     spi(mode0);
+static OutputPort  dc(HostDcPin);
+static OutputPort  rst(HostResetPin);
+
+static SSD1306_128x64  runtime0(&spi, &dc, &rst);
+static SSD1306_128x64  runtime1(&spi, &dc, &rst);
+static SSD1306Fixed<0> fixed0(&spi, &dc, &rst);
+static SSD1306Fixed<1> fixed1(&spi, &dc, &rst);
+
+struct Args {
+  int16_t x0, y0, x1, y1, r;
+  uint8_t c;
+  uint16_t color;
+};
+static Args args[OPS];
+
+// Mostly on screen, some lines and circles cross the edges, chars stay on it
+static void makeArgs(void) {
+  srand(1306);
+  for (int i = 0; i < OPS; i++) {
+    args[i].x0 = rand() % 144 - 8;
+    args[i].y0 = rand() % 144 - 8;
+    args[i].x1 = rand() % 144 - 8;
+    args[i].y1 = rand() % 144 - 8;
+    args[i].r = rand() % 30 + 1;
+    args[i].c = 'A' + rand() % 26;
+    args[i].color = rand() % 3;
+  }
+}
+
+template <class G> static void opLine(G & g, const Args & a) { g.drawLine(a.x0, a.y0, a.x1, a.y1, a.color); }
+template <class G> static void opCircle(G & g, const Args & a) { g.drawCircle(a.x0, a.y0, a.r, a.color); }
+template <class G> static void opChar(G & g, const Args & a) { g.drawChar(a.x0 & 63, a.y0 & 63, a.c, WHITE, BLACK, 1); }
+
+template <class G> static void run(G & gfx, void (*op)(G &, const Args &)) {
+  for (int i = 0; i < OPS; i++) op(gfx, args[i]);
+}
+
+struct Case {
+  const char * name;
+  SSD1306 * runtime;
+  SSD1306 * fixed;
+  void (*runRuntime)(void);
+  void (*runFixed)(void);
+};
+
+#define CASES(rot, runtime, fixed, Fixed)                                          \
+  { "drawLine_rot" #rot, &runtime, &fixed,                                         \
+    [] { run<SSD1306>(runtime, opLine<SSD1306>); },                               \
+    [] { run<Fixed>(fixed, opLine<Fixed>); } },                                    \
+  { "drawCircle_rot" #rot, &runtime, &fixed,                                       \
+    [] { run<SSD1306>(runtime, opCircle<SSD1306>); },                             \
+    [] { run<Fixed>(fixed, opCircle<Fixed>); } },                                  \
+  { "drawChar_rot" #rot, &runtime, &fixed,                                         \
+    [] { run<SSD1306>(runtime, opChar<SSD1306>); },                               \
+    [] { run<Fixed>(fixed, opChar<Fixed>); } }
+
+static const Case cases[] = {
+  CASES(0, runtime0, fixed0, SSD1306Fixed<0>),
+  CASES(1, runtime1, fixed1, SSD1306Fixed<1>),
+};
+
+static double now(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+int main(int argc, char * argv[]) {
+  int rounds = (argc > 1) ? atoi(argv[1]) : 20;
+  bool failed = false;
+
+  makeArgs();
+  runtime1.setRotation(1);
+
+  printf("case,runtime_ns_per_op,fixed_ns_per_op,speedup,same\n");
+  for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+    const Case & tc = cases[c];
+    tc.runtime->fillScreen(BLACK);
+    tc.fixed->fillScreen(BLACK);
+
+    double bestRuntime = 1e30, bestFixed = 1e30;
+    for (int r = 0; r < rounds; r++) {
+      double start = now();
+      tc.runRuntime();
+      double elapsed = now() - start;
+      if (elapsed < bestRuntime) bestRuntime = elapsed;
+
+      start = now();
+      tc.runFixed();
+      elapsed = now() - start;
+      if (elapsed < bestFixed) bestFixed = elapsed;
+    }
+
+    bool same = !memcmp(tc.runtime->getBuffer(), tc.fixed->getBuffer(), FRAME_SIZE);
+    failed |= !same;
+    printf("%s,%.1f,%.1f,%.2f,%d\n", tc.name, bestRuntime / OPS, bestFixed / OPS,
+      bestRuntime / bestFixed, same);
+  }
+  return failed ? 1 : 0;
+}
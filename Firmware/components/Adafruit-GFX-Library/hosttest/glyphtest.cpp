@@ -0,0 +1,160 @@
+/*
+Test of the packed glyph bitmaps (GFX_BITMAP_RLE, see gfxglyphruns.h).
+
+Fonts/FreeSansPacked9pt7b.h is fontconvert -c output of the glyphs of
+Fonts/FreeSans9pt7b.h, fontconvert read them as a BDF strike (FreeType
+loads it like a TrueType font, without -c the output equals the shipped
+header).  Every glyph of the packed font has to give the same pixels as
+the plain one:
+- on GFXcanvas1, decoded by Adafruit_GFX in all rotations,
+- in a GlyphAtlas, built from the packed bitmaps,
+- on the SSD1306 with the atlas of the packed font (rotation 0) and on its
+  generic path (other rotations), compared with the reference (reference.h)
+  drawing the plain font.
+Sizes 1 to 3, all colors, at random positions, partly off screen.
+
+Prints one line per check, the exit code is 1 if one fails.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#define PROGMEM
+#include "Display_SSD1306.h"
+#include "Fonts/FreeSans9pt7b.h"
+#include "Fonts/FreeSansPacked9pt7b.h"
+#include "GlyphAtlas.h"
+#include "host.h"
+#include "reference.h"
+
+#define FRAME_SIZE (SSD1306_LCDWIDTH * SSD1306_LCDHEIGHT / 8)
+
+static const GFXfont & Plain  = FreeSans9pt7b;
+static const GFXfont & Packed = FreeSansPacked9pt7b;
+
+static SpiPort     spi(mode0);
+static OutputPort  dc(HostDcPin);
+static OutputPort  rst(HostResetPin);
+static SSD1306_128x64 display(&spi, &dc, &rst);
+static ReferenceDisplay reference;
+static GFXcanvas1  plainCanvas(SSD1306_LCDWIDTH, SSD1306_LCDHEIGHT);
+static GFXcanvas1  packedCanvas(SSD1306_LCDWIDTH, SSD1306_LCDHEIGHT);
+
+static bool failed = false;
+
+static void check(bool ok, const char * what) {
+  printf("%s: %s\n", ok ? "ok  " : "FAIL", what);
+  failed |= !ok;
+}
+
+// Same glyphs, only the bitmaps differ
+static bool sameGlyphTable(void) {
+  if ((Plain.first != Packed.first) || (Plain.last != Packed.last) || (Plain.yAdvance != Packed.yAdvance) ||
+      (Plain.encoding != GFX_BITMAP_PLAIN) || (Packed.encoding != GFX_BITMAP_RLE))
+    return false;
+
+  for (uint16_t g = 0; g < gfxFontGlyphCount(&Plain); g++) {
+    const GFXglyph & a = Plain.glyph[g];
+    const GFXglyph & b = Packed.glyph[g];
+    if ((a.width != b.width) || (a.height != b.height) || (a.xAdvance != b.xAdvance) ||
+        (a.xOffset != b.xOffset) || (a.yOffset != b.yOffset))
+      return false;
+  }
+  return true;
+}
+
+// Every glyph, sizes 1 to 3, in all rotations. Each glyph is drawn on its own
+// so the canvases show one glyph at a time.
+static bool compareCanvas(void) {
+  bool same = true;
+
+  srand(7);
+  plainCanvas.setFont(&Plain);
+  packedCanvas.setFont(&Packed);
+  for (uint8_t rotation = 0; rotation < 4; rotation++) {
+    plainCanvas.setRotation(rotation);
+    packedCanvas.setRotation(rotation);
+    for (uint8_t size = 1; size <= 3; size++) {
+      for (uint16_t c = Plain.first; c <= Plain.last; c++) {
+        int16_t x = rand() % 140 - 12, y = rand() % 100 - 6;
+        uint16_t color = rand() % 2;
+        plainCanvas.fillScreen(!color);
+        packedCanvas.fillScreen(!color);
+        plainCanvas.drawChar(x, y, c, color, color, size);
+        packedCanvas.drawChar(x, y, c, color, color, size);
+        same &= !memcmp(plainCanvas.getBuffer(), packedCanvas.getBuffer(), FRAME_SIZE);
+      }
+    }
+  }
+  return same;
+}
+
+static bool compareAtlas(const GlyphAtlas & plain, const GlyphAtlas & packed) {
+  for (uint16_t g = 0; g < gfxFontGlyphCount(&Plain); g++) {
+    const GFXglyph & glyph = Plain.glyph[g];
+    size_t size = glyph.width * ((glyph.height + 7) / 8);
+    if (size && memcmp(plain.Columns(g), packed.Columns(g), size))
+      return false;
+  }
+  return true;
+}
+
+// Random text on the driver with the packed font and on the reference with
+// the plain one, 'rounds' frames per rotation
+static bool compareDisplay(int rounds) {
+  bool same = true;
+
+  srand(9);
+  display.setFont(&Packed);
+  reference.setFont(&Plain);
+  display.setTextWrap(false);
+  reference.setTextWrap(false);
+  for (int r = 0; r < 4 * rounds; r++) {
+    uint8_t rotation = r / rounds;
+    display.setRotation(rotation);
+    reference.setRotation(rotation);
+    display.fillScreen(r & 1);
+    reference.fillScreen(r & 1);
+
+    for (int i = 0; i < 8; i++) {
+      int16_t x = rand() % 150 - 11, y = rand() % 150 - 11;
+      uint8_t size = rand() % 3 + 1;
+      uint16_t color = rand() % 3;
+      char text[6];
+      for (size_t k = 0; k < sizeof(text) - 1; k++)
+        text[k] = Plain.first + rand() % (Plain.last - Plain.first + 1);
+      text[sizeof(text) - 1] = 0;
+
+      display.setTextSize(size);
+      reference.setTextSize(size);
+      display.setTextColor(color);
+      reference.setTextColor(color);
+      display.setCursor(x, y);
+      reference.setCursor(x, y);
+      display.print(text);
+      reference.print(text);
+    }
+    same &= !memcmp(display.getBuffer(), reference.getBuffer(), FRAME_SIZE);
+  }
+  display.setRotation(0);
+  return same;
+}
+
+int main(void) {
+  check(sameGlyphTable(), "packed font has the glyph table of the plain one");
+  uint32_t plainSize = sizeof(FreeSans9pt7bBitmaps), packedSize = sizeof(FreeSansPacked9pt7bBitmaps);
+  printf("bitmaps: %u bytes plain, %u bytes packed\n", (unsigned)plainSize, (unsigned)packedSize);
+  check(packedSize < plainSize, "packed bitmaps are smaller");
+
+  check(compareCanvas(), "GFXcanvas1 draws the same glyphs in all rotations, sizes 1 to 3");
+
+  GlyphAtlas plainAtlas(&Plain);
+  GlyphAtlas packedAtlas(&Packed);
+  check(plainAtlas.IsValid() && packedAtlas.IsValid(), "atlases built");
+  check(compareAtlas(plainAtlas, packedAtlas), "atlas of the packed font equals the one of the plain font");
+
+  display.setGlyphAtlas(&packedAtlas);
+  check(compareDisplay(100), "SSD1306 with the packed font equals the generic path with the plain one");
+
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,140 @@
+/*
+Recording fakes of the MyHal ports, see host.h.
+*/
+
+#include <string.h>
+#include <unistd.h>
+#include <mutex>
+#include <vector>
+#include "GpioPort.h"
+#include "I2cPort.h"
+#include "SpiPort.h"
+#include "host.h"
+#include "panel.h"
+
+PanelModel * hostPanel = nullptr;
+uint8_t      hostPanelAddress = 0x3C;
+HostBus      hostBus = {};
+unsigned     hostTransferUs = 0;
+int          hostGpio[GPIO_NUM_MAX] = {};
+
+void (*hostSpiHook)(bool data, const uint8_t * src, size_t len) = nullptr;
+esp_err_t (*hostI2cDevice)(uint16_t address, bool read, uint8_t * data, size_t size) = nullptr;
+
+uint64_t GpioPort::_Reserved = 0;
+
+GpioPort::GpioPort(gpio_num_t port) : PortBase("GPIO"), _port(port) {
+  _Reserved |= 1ULL << port;
+  InitOk = true;
+}
+
+GpioPort::~GpioPort() {
+  _Reserved &= ~(1ULL << _port);
+}
+
+InputPort::InputPort(gpio_num_t port, GpioPort::PullResistor resistor) : GpioPort(port) {
+  hostGpio[port] = (resistor == PullUp) ? 1 : 0;
+}
+
+int InputPort::ReadPort(void) {
+  return hostGpio[_port];
+}
+
+OutputPort::OutputPort(gpio_num_t port, GpioPort::OutputLogic mode) : GpioPort(port), _mode(mode) {
+}
+
+void OutputPort::WritePort(int active) {
+  int level = (_mode == Inverted) ? !active : !!active;
+  if ((_port == HostResetPin) && hostGpio[_port] && !level && hostPanel)
+    hostPanel->Reset();
+  hostGpio[_port] = level;
+}
+
+SpiPort::SpiPort(spi_tMmode_t /*mode*/) : PortBase("SPI") {
+  InitOk = true;
+}
+
+esp_err_t SpiPort::TransmitSync(const uint8_t * txData, size_t len) {
+  bool data = hostGpio[HostDcPin];
+
+  if (hostTransferUs)
+    usleep(hostTransferUs);
+  hostBus.transactions++;
+  hostBus.bytes += len;
+  if (hostPanel)
+    hostPanel->Write(data, txData, len);
+  if (hostSpiHook)
+    hostSpiHook(data, txData, len);
+  return ESP_OK;
+}
+
+// The ESP driver runs one command link at a time, a transaction is never
+// interleaved with one of another task
+static std::mutex i2cBus;
+
+I2cPort::I2cPort() : PortBase("I2C") {
+  InitOk = true;
+}
+
+// Transactions as the ESP driver does them, with its checks of the arguments.
+// Returns the answer of the addressed device.
+static esp_err_t i2cWrite(uint16_t slaveAdd, const uint8_t * cmd, size_t cmdSize,
+                          const uint8_t * data, size_t size) {
+  std::vector<uint8_t> bytes;
+  if (cmd)
+    bytes.insert(bytes.end(), cmd, cmd + cmdSize);
+  if (data)
+    bytes.insert(bytes.end(), data, data + size);
+
+  if (hostTransferUs)
+    usleep(hostTransferUs);
+  hostBus.transactions++;
+  hostBus.bytes += 1 + bytes.size();
+  if (hostPanel && (slaveAdd == hostPanelAddress))
+    return hostPanel->I2cWrite(bytes.data(), bytes.size()) ? ESP_OK : ESP_FAIL;
+  if (hostI2cDevice)
+    return hostI2cDevice(slaveAdd, false, bytes.data(), bytes.size());
+  return ESP_FAIL;
+}
+
+static esp_err_t i2cRead(uint16_t slaveAdd, uint8_t * data, size_t size) {
+  if (hostPanel && (slaveAdd == hostPanelAddress))
+    return ESP_FAIL; // Not readable on the serial interfaces
+  if (hostI2cDevice)
+    return hostI2cDevice(slaveAdd, true, data, size);
+  return ESP_FAIL;
+}
+
+esp_err_t I2cPort::WriteData(uint16_t slaveAdd, uint8_t * data, size_t size) {
+  if ((size == 0) || (data == nullptr))
+    return ESP_FAIL;
+  std::lock_guard<std::mutex> lock(i2cBus);
+  return i2cWrite(slaveAdd, data, size, nullptr, 0);
+}
+
+esp_err_t I2cPort::ReadData(uint16_t slaveAdd, uint8_t * data, size_t size) {
+  if ((size == 0) || (data == nullptr))
+    return ESP_FAIL;
+  std::lock_guard<std::mutex> lock(i2cBus);
+  hostBus.transactions++;
+  hostBus.bytes += 1 + size;
+  return i2cRead(slaveAdd, data, size);
+}
+
+esp_err_t I2cPort::WriteData(uint16_t slaveAdd, uint8_t * cmd, size_t cmdSize, uint8_t * data, size_t size) {
+  if ((cmdSize == 0) || (size == 0) || ((cmd == nullptr) && (data == nullptr)))
+    return ESP_FAIL;
+  std::lock_guard<std::mutex> lock(i2cBus);
+  return i2cWrite(slaveAdd, cmd, cmdSize, data, size);
+}
+
+// Write and read with a repeated start, one transaction
+esp_err_t I2cPort::ReadData(uint16_t slaveAdd, uint8_t * cmd, size_t cmdSize, uint8_t * data, size_t size) {
+  if ((cmdSize == 0) || (size == 0) || ((cmd == nullptr) && (data == nullptr)))
+    return ESP_FAIL;
+  std::lock_guard<std::mutex> lock(i2cBus);
+  esp_err_t result = i2cWrite(slaveAdd, cmd, cmdSize, nullptr, 0);
+  hostBus.transactions--;
+  hostBus.bytes += 1 + size;
+  return (result == ESP_OK) ? i2cRead(slaveAdd, data, size) : result;
+}
@@ -0,0 +1,40 @@
+/*
+Host stand-ins of MyHal and FreeRTOS for the tests of the display stack.
+
+The ports are recording fakes: SpiPort passes every transaction to the
+panel model (panel.h) and counts it.  The DC line is the OutputPort on
+HostDcPin, a low level on HostResetPin resets the panel, the pins are the
+ones of the station.  An I2C write to hostPanelAddress goes to the panel,
+transfers to other addresses to hostI2cDevice, e.g. a simulated sensor.
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "driver/gpio.h"
+#include "freertos/FreeRTOS.h"
+
+class PanelModel;
+
+#define HostDcPin    GPIO_NUM_2 // D4
+#define HostResetPin GPIO_NUM_0 // D3
+
+// Traffic on SPI and I2C since the last reset by the test
+struct HostBus {
+  uint32_t transactions;
+  uint32_t bytes;  // On I2C incl. the address and control bytes
+};
+
+extern PanelModel * hostPanel;     // Receives the panel traffic, may be null
+extern uint8_t      hostPanelAddress;
+extern HostBus      hostBus;
+extern unsigned     hostTransferUs; // Duration of a transaction, 0 = none
+extern TickType_t   hostTicks;      // Returned by xTaskGetTickCount()
+extern int          hostGpio[GPIO_NUM_MAX]; // Output levels
+
+// Called for every SPI transaction after the panel got it, may be null
+extern void (*hostSpiHook)(bool data, const uint8_t * src, size_t len);
+// Device on the I2C bus besides the panel, may be null (no acknowledge then).
+// A write passes the bytes in 'data', a read fills them.
+extern esp_err_t (*hostI2cDevice)(uint16_t address, bool read, uint8_t * data, size_t size);
@@ -0,0 +1,222 @@
+/*
+Test of the I2C transport of the SSD1306 driver.
+
+The panel is on the I2C bus at hostPanelAddress, every write is decoded by
+the panel model (control byte and payload).  A full frame has to be sent
+in a few large bursts, the image on the panel has to be the same as with
+the panel on SPI.  A simulated SHTC3 at SHTC3_DEFAULT_ADDR shares the bus:
+Shtc3_Sensor polls it from its own thread while the flush task sends
+frames, both have to keep working.
+
+Prints one line per check and the traffic of a full frame, the exit code
+is 1 if a check fails.
+
+usage: i2ctest [frames]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include "Display_SSD1306.h"
+#include "Shtc3_Sensor.h"
+#include "host.h"
+#include "panel.h"
+
+#define FRAME_SIZE (PanelModel::Pages * PanelModel::Width)
+#define IMAGE_SIZE (PanelModel::Width * PanelModel::Height)
+
+static I2cPort     i2c;
+static SpiPort     spi(mode0);
+static OutputPort  dc(HostDcPin);
+static OutputPort  rst(HostResetPin);
+static PanelModel  panel;
+static PanelModel  spiPanel;
+static SSD1306_128x64 display(&i2c, SSD1306_I2C_ADDRESS, &rst);
+static SSD1306_128x64 spiDisplay(&spi, &dc, &rst);
+
+static bool failed = false;
+
+static void check(bool ok, const char * what) {
+  printf("%s: %s\n", ok ? "ok  " : "FAIL", what);
+  failed |= !ok;
+}
+
+static bool ramSame(void) {
+  return !memcmp(panel.Ram(), display.getBuffer(), FRAME_SIZE);
+}
+
+static void drawScene(SSD1306 & d) {
+  d.fillRect(0, 0, 128, 16, WHITE);
+  d.setTextColor(BLACK, WHITE);
+  d.setTextSize(2);
+  d.setCursor(2, 1);
+  d.print("I2C panel");
+  d.setTextColor(WHITE, BLACK);
+  d.setTextSize(1);
+  d.setCursor(0, 20);
+  d.print("T = 24.9 C");
+  d.drawCircle(100, 44, 15, WHITE);
+  d.drawLine(0, 63, 127, 32, INVERSE);
+}
+
+// SHTC3 on the bus, answers with 24.99 degC and 50.00 %RH
+#define SHTC3_WAKEUP    0x3517
+#define SHTC3_SLEEP     0xB098
+#define SHTC3_SOFTRESET 0x805D
+#define SHTC3_READID    0xEFC8
+#define SHTC3_MEASURE   0x7866
+#define SHTC3_MEASURE_LP 0x609C
+#define SHTC3_ID        0x0887
+
+static uint16_t sensorCommand;
+static bool     sensorAwake;
+static std::atomic<int> sensorTransactions(0), sensorDuringFlush(0), sensorBadCommands(0);
+
+static uint8_t crc8(const uint8_t * data, int len) {
+  uint8_t crc = 0xFF;
+  for (int i = 0; i < len; i++) {
+    crc ^= data[i];
+    for (int b = 0; b < 8; b++)
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x31 : (crc << 1);
+  }
+  return crc;
+}
+
+static void putWord(uint8_t * dst, uint16_t value) {
+  dst[0] = value >> 8;
+  dst[1] = value & 0xFF;
+  dst[2] = crc8(dst, 2);
+}
+
+static esp_err_t shtc3(uint16_t address, bool read, uint8_t * data, size_t size) {
+  if (address != SHTC3_DEFAULT_ADDR)
+    return ESP_FAIL; // No acknowledge
+
+  sensorTransactions++;
+  if (display.isFlushing())
+    sensorDuringFlush++;
+
+  if (!read) {
+    uint16_t command = (size == 2) ? ((data[0] << 8) | data[1]) : 0;
+    if (!sensorAwake && (command != SHTC3_WAKEUP))
+      return ESP_FAIL; // Asleep, only the wakeup is acknowledged
+    switch (command) {
+      case SHTC3_WAKEUP:    sensorAwake = true;  break;
+      case SHTC3_SLEEP:     sensorAwake = false; break;
+      case SHTC3_SOFTRESET:
+      case SHTC3_READID:
+      case SHTC3_MEASURE:
+      case SHTC3_MEASURE_LP: break;
+      default:
+        sensorBadCommands++;
+        return ESP_FAIL;
+    }
+    sensorCommand = command;
+    return ESP_OK;
+  }
+
+  uint8_t answer[6];
+  if (sensorCommand == SHTC3_READID) {
+    putWord(answer, SHTC3_ID);
+  } else if ((sensorCommand == SHTC3_MEASURE) || (sensorCommand == SHTC3_MEASURE_LP)) {
+    putWord(&answer[0], 0x6666); // T  = -45 + 175 * x / 2^16
+    putWord(&answer[3], 0x8000); // RH = 100 * x / 2^16
+  } else {
+    return ESP_FAIL; // Nothing to read
+  }
+  if (size > sizeof(answer))
+    return ESP_FAIL;
+  memcpy(data, answer, size);
+  return ESP_OK;
+}
+
+// Every frame changes other regions, some of them cover several pages
+static void drawFrame(int frame) {
+  srand(frame);
+  for (int i = 0; i < 4; i++)
+    display.fillRect(rand() % 128, rand() % 64, rand() % 40 + 1, rand() % 20 + 1, rand() % 3);
+  char text[16];
+  snprintf(text, sizeof(text), "%d", frame);
+  display.setTextColor(WHITE, BLACK);
+  display.setCursor(rand() % 100, rand() % 56);
+  display.print(text);
+}
+
+int main(int argc, char * argv[]) {
+  int frames = (argc > 1) ? atoi(argv[1]) : 100;
+
+  hostPanel = &panel;
+  hostI2cDevice = shtc3;
+  display.Init();
+  display.display();
+  check(panel.IsOn() && (panel.UnknownCommands() == 0), "Init() over I2C turns the panel on");
+
+  // Full frame: one window command batch and one burst of 1024 bytes
+  display.fillScreen(WHITE);
+  drawScene(display);
+  hostBus = {};
+  display.resetTxStats();
+  display.display();
+  uint32_t transactions = hostBus.transactions, bytes = hostBus.bytes;
+  printf("full frame: %u transactions, %u bytes on the bus (%u data, %u command)\n",
+         (unsigned)transactions, (unsigned)bytes, (unsigned)display.txStats().dataBytes,
+         (unsigned)display.txStats().commandBytes);
+  check(display.txStats().dataBytes == 1024, "the whole frame is sent");
+  check(transactions <= 3, "in a few large bursts");
+  check(bytes == 2 * transactions + display.txStats().dataBytes + display.txStats().commandBytes,
+        "an address and a control byte per transaction");
+  check(ramSame(), "panel RAM equals the frame buffer");
+
+  // Same scene on SPI
+  static uint8_t image[IMAGE_SIZE], spiImage[IMAGE_SIZE];
+  hostPanel = &spiPanel;
+  spiDisplay.Init();
+  spiDisplay.fillScreen(WHITE);
+  drawScene(spiDisplay);
+  spiDisplay.display();
+  hostPanel = &panel;
+  panel.Image(image);
+  spiPanel.Image(spiImage);
+  check(!memcmp(image, spiImage, IMAGE_SIZE), "the panel shows the same image as on SPI");
+
+  // Sensor polled from another task while the flush task sends frames
+  Shtc3_Sensor sensor(&i2c);
+  uint16_t id = 0;
+  check((sensor.ReadID(&id) == ESP_OK) && (id == SHTC3_ID), "sensor ID read on the shared bus");
+
+  if (!display.StartFlushTask()) {
+    check(false, "flush task started");
+    return 1;
+  }
+  hostTransferUs = 50;
+  std::atomic<bool> stop(false);
+  std::atomic<int> reads(0), wrong(0);
+  std::thread poll([&] {
+    while (!stop) {
+      float temperature = 0, humidity = 0;
+      if ((sensor.ReadSensor(&temperature, &humidity) != ESP_OK) ||
+          (temperature != 24.99f) || (humidity != 50.0f))
+        wrong++;
+      reads++;
+    }
+  });
+  for (int f = 0; f < frames; f++) {
+    drawFrame(f);
+    display.present();
+  }
+  while (reads < 3)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  stop = true;
+  poll.join();
+  display.display(); // Waits for the flush task, sends the rest
+  hostTransferUs = 0;
+
+  printf("shared bus: %d frames, %d sensor reads, %d of %d sensor transactions during a flush\n",
+         frames, (int)reads, (int)sensorDuringFlush, (int)sensorTransactions);
+  check((wrong == 0) && (sensorBadCommands == 0), "sensor reads are correct while frames are sent");
+  check(ramSame() && (panel.UnknownCommands() == 0), "panel RAM equals the frame buffer afterwards");
+
+  return failed ? 1 : 0;
+}
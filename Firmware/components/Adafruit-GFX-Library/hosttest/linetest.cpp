@@ -0,0 +1,178 @@
+/*
+Test of the line clipping of Adafruit_GFX::writeLine().
+
+writeLine() clips the line before the first step (see gfxcore.h), it has
+to draw exactly the visible pixels of the unclipped Bresenham line, each
+of them once.  Random lines, many of them reaching far past every edge up
+to the int16_t range, are drawn
+- on a canvas counting the hits per pixel, for several panel sizes, and
+  compared with the hit counts of the unclipped line below,
+- with INVERSE on the SSD1306 in all rotations, where a pixel hit twice
+  would vanish, and compared with the reference (reference.h) inverting
+  the pixels of the unclipped line one by one.
+
+Prints one line per check, the exit code is 1 if one fails.
+
+usage: linetest [lines]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "Display_SSD1306.h"
+#include "host.h"
+#include "reference.h"
+
+#define FRAME_SIZE (SSD1306_LCDWIDTH * SSD1306_LCDHEIGHT / 8)
+
+static SpiPort     spi(mode0);
+static OutputPort  dc(HostDcPin);
+static OutputPort  rst(HostResetPin);
+static SSD1306_128x64 display(&spi, &dc, &rst);
+static ReferenceDisplay reference;
+
+static bool failed = false;
+
+static void check(bool ok, const char * what) {
+  printf("%s: %s\n", ok ? "ok  " : "FAIL", what);
+  failed |= !ok;
+}
+
+// Counts the hits per pixel and the pixels written beyond the canvas
+class HitCanvas : public Adafruit_GFX {
+ public:
+  HitCanvas(int16_t w, int16_t h) : Adafruit_GFX(w, h), hits(w * h), outside(0) { }
+  void drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if ((x < 0) || (y < 0) || (x >= _width) || (y >= _height))
+      outside++;
+    else
+      hits[y * _width + x]++;
+  }
+  std::vector<uint32_t> hits;
+  uint32_t outside;
+};
+
+// Unclipped Bresenham as Adafruit_GFX had it, with 32 bit arithmetic, every
+// step is passed to 'plot'
+template <class Plot> static void bresenham(int32_t x0, int32_t y0, int32_t x1, int32_t y1, Plot plot) {
+  bool steep = abs(y1 - y0) > abs(x1 - x0);
+  if (steep) {
+    std::swap(x0, y0);
+    std::swap(x1, y1);
+  }
+  if (x0 > x1) {
+    std::swap(x0, x1);
+    std::swap(y0, y1);
+  }
+
+  int32_t dx = x1 - x0;
+  int32_t dy = abs(y1 - y0);
+  int32_t err = dx / 2;
+  int32_t ystep = (y0 < y1) ? 1 : -1;
+
+  for (; x0 <= x1; x0++) {
+    if (steep)
+      plot(y0, x0);
+    else
+      plot(x0, y0);
+    err -= dy;
+    if (err < 0) {
+      y0 += ystep;
+      err += dx;
+    }
+  }
+}
+
+static int16_t coordinate(int16_t size) {
+  switch (rand() % 8) {
+    case 0:  return rand() % 65536 - 32768;           // Anywhere in int16_t
+    case 1:
+    case 2:  return rand() % 4001 - 2000;             // Far past the edges
+    default: return rand() % (size + 80) - 40;        // Around the panel
+  }
+}
+
+// Random line, some are horizontal, vertical, 45 degrees or a single point
+static void randomLine(int16_t w, int16_t h, int16_t * a) {
+  a[0] = coordinate(w);
+  a[1] = coordinate(h);
+  a[2] = coordinate(w);
+  a[3] = coordinate(h);
+  switch (rand() % 10) {
+    case 0: a[3] = a[1]; break;
+    case 1: a[2] = a[0]; break;
+    case 2: a[3] = a[1] + ((rand() & 1) ? 1 : -1) * (a[2] - a[0]); break;
+    case 3: a[2] = a[0]; a[3] = a[1]; break;
+  }
+}
+
+// Hit counts of 'lines' lines per canvas size, each line on a cleared canvas
+static bool compareHits(int lines, uint32_t & outside) {
+  static const int16_t Sizes[][2] = { {128, 64}, {128, 32}, {64, 128}, {17, 5}, {1, 1} };
+  bool same = true;
+
+  outside = 0;
+  srand(17);
+  for (size_t s = 0; s < sizeof(Sizes) / sizeof(Sizes[0]); s++) {
+    int16_t w = Sizes[s][0], h = Sizes[s][1];
+    HitCanvas canvas(w, h);
+    std::vector<uint32_t> expected(w * h);
+
+    for (int i = 0; i < lines; i++) {
+      int16_t a[4];
+      randomLine(w, h, a);
+
+      std::fill(canvas.hits.begin(), canvas.hits.end(), 0);
+      std::fill(expected.begin(), expected.end(), 0);
+      canvas.drawLine(a[0], a[1], a[2], a[3], WHITE);
+      bresenham(a[0], a[1], a[2], a[3], [&](int32_t x, int32_t y) {
+        if ((x >= 0) && (y >= 0) && (x < w) && (y < h))
+          expected[y * w + x]++;
+      });
+      same &= (canvas.hits == expected);
+    }
+    outside += canvas.outside;
+  }
+  return same;
+}
+
+// INVERSE lines on the driver in all rotations, 20 lines per frame
+static bool compareInverse(int frames) {
+  bool same = true;
+
+  srand(71);
+  for (int f = 0; f < frames; f++) {
+    uint8_t rotation = f & 3;
+    display.setRotation(rotation);
+    reference.setRotation(rotation);
+    display.fillScreen(f & 1);
+    reference.fillScreen(f & 1);
+
+    for (int i = 0; i < 20; i++) {
+      int16_t a[4];
+      randomLine(display.width(), display.height(), a);
+      display.drawLine(a[0], a[1], a[2], a[3], INVERSE);
+      bresenham(a[0], a[1], a[2], a[3], [](int32_t x, int32_t y) {
+        if ((x >= 0) && (y >= 0) && (x < reference.width()) && (y < reference.height()))
+          reference.drawPixel(x, y, INVERSE);
+      });
+    }
+    same &= !memcmp(display.getBuffer(), reference.getBuffer(), FRAME_SIZE);
+  }
+  display.setRotation(0);
+  reference.setRotation(0);
+  return same;
+}
+
+int main(int argc, char * argv[]) {
+  int lines = (argc > 1) ? atoi(argv[1]) : 40000;
+  uint32_t outside;
+
+  check(compareHits(lines, outside), "hits per pixel equal the unclipped line on 5 panel sizes");
+  check(outside == 0, "no pixel is written beyond the canvas");
+  check(compareInverse(lines / 20), "INVERSE lines on the SSD1306 equal the unclipped line in all rotations");
+
+  return failed ? 1 : 0;
+}
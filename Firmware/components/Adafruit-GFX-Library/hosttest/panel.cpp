@@ -0,0 +1,256 @@
+/*
+Model of a SSD1306 panel and PBM files, see panel.h.
+*/
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include "panel.h"
+
+void PanelModel::Reset(void) {
+  _cmdLen  = 0;
+  _cmdNeed = 0;
+
+  _mode  = 2; // Page addressing after reset
+  _col0  = 0;
+  _col1  = Width - 1;
+  _page0 = 0;
+  _page1 = Pages - 1;
+  _col   = 0;
+  _page  = 0;
+  _pageCol = 0;
+
+  _startLine  = 0;
+  _fixedRows  = 0;
+  _scrollRows = Height;
+  _multiplex  = Height - 1;
+  _offset     = 0;
+  _contrast   = 0x7F;
+  _segRemap   = false;
+  _comRemap   = false;
+  _inverse    = false;
+  _allOn      = false;
+  _on         = false;
+}
+
+void PanelModel::Write(bool data, const uint8_t * src, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    if (data)
+      this->data(src[i]);
+    else
+      command(src[i]);
+  }
+}
+
+// Control byte: Co (bit 7) = only one byte follows before the next control
+// byte, D/C (bit 6) = data
+bool PanelModel::I2cWrite(const uint8_t * src, size_t len) {
+  size_t i = 0;
+  while (i < len) {
+    uint8_t control = src[i++];
+    if ((control & 0x3F) || (i == len))
+      return false;
+
+    bool data = control & 0x40;
+    size_t end = (control & 0x80) ? i + 1 : len;
+    Write(data, &src[i], end - i);
+    i = end;
+  }
+  return len > 0;
+}
+
+// Length of a command incl. its arguments by its first byte
+static uint8_t commandLength(uint8_t c) {
+  switch (c) {
+    case 0x81: case 0x8D: case 0x20: case 0xA8: case 0xD3:
+    case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+      return 2;
+    case 0x21: case 0x22: case 0xA3:
+      return 3;
+    case 0x29: case 0x2A:
+      return 6;
+    case 0x26: case 0x27:
+      return 7;
+  }
+  return 1;
+}
+
+void PanelModel::command(uint8_t c) {
+  if (_cmdLen == 0)
+    _cmdNeed = commandLength(c);
+  _cmd[_cmdLen++] = c;
+  if (_cmdLen < _cmdNeed)
+    return;
+
+  execute();
+  _cmdLen = 0;
+}
+
+void PanelModel::execute(void) {
+  uint8_t c = _cmd[0];
+
+  if (c <= 0x0F) {                    // Lower column nibble, page addressing
+    _pageCol = (_pageCol & 0xF0) | c;
+    _col = _pageCol;
+  } else if (c <= 0x1F) {             // Upper column nibble, page addressing
+    _pageCol = (_pageCol & 0x0F) | ((c & 0x07) << 4);
+    _col = _pageCol;
+  } else if ((c >= 0x40) && (c <= 0x7F)) {
+    _startLine = c & 0x3F;
+  } else if ((c >= 0xB0) && (c <= 0xB7)) {
+    _page = c & 0x07;                 // Page start, page addressing
+  } else {
+    switch (c) {
+      case 0x20: _mode = _cmd[1] & 0x03; break;
+      case 0x21:
+        _col0 = _cmd[1] & 0x7F;
+        _col1 = _cmd[2] & 0x7F;
+        _col  = _col0;
+        break;
+      case 0x22:
+        _page0 = _cmd[1] & 0x07;
+        _page1 = _cmd[2] & 0x07;
+        _page  = _page0;
+        break;
+      case 0xA3:
+        _fixedRows  = _cmd[1] & 0x3F;
+        _scrollRows = _cmd[2] & 0x7F;
+        break;
+      case 0x81: _contrast = _cmd[1]; break;
+      case 0xA8: _multiplex = _cmd[1] & 0x3F; break;
+      case 0xD3: _offset = _cmd[1] & 0x3F; break;
+      case 0xA0: case 0xA1: _segRemap = c & 1; break;
+      case 0xC0: case 0xC8: _comRemap = c & 8; break;
+      case 0xA4: case 0xA5: _allOn = c & 1; break;
+      case 0xA6: case 0xA7: _inverse = c & 1; break;
+      case 0xAE: case 0xAF: _on = c & 1; break;
+      case 0x8D: case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+      case 0x26: case 0x27: case 0x29: case 0x2A: case 0x2E: case 0x2F:
+      case 0xE3:
+        break; // Analog settings, continuous scrolls and NOP
+      default:
+        _unknown++;
+        break;
+    }
+  }
+}
+
+void PanelModel::data(uint8_t d) {
+  _ram[_page * Width + _col] = d;
+
+  switch (_mode) {
+    case 0: // Horizontal, the window wraps to its next page
+      if (_col < _col1) {
+        _col++;
+      } else {
+        _col  = _col0;
+        _page = (_page < _page1) ? _page + 1 : _page0;
+      }
+      break;
+    case 1: // Vertical, the window wraps to its next column
+      if (_page < _page1) {
+        _page++;
+      } else {
+        _page = _page0;
+        _col  = (_col < _col1) ? _col + 1 : _col0;
+      }
+      break;
+    default: // Page addressing, the page is kept
+      _col = (_col < Width - 1) ? _col + 1 : _pageCol;
+      break;
+  }
+}
+
+void PanelModel::Image(uint8_t * pixels) const {
+  for (int y = 0; y < Height; y++) {
+    // Row of the glass -> display line -> RAM row
+    int line = _comRemap ? y : _multiplex - y;
+    bool active = _on && (line >= 0) && (line <= _multiplex);
+    line = (line + _offset) & (Height - 1);
+
+    int row = line;
+    if ((line >= _fixedRows) && (line < _fixedRows + _scrollRows))
+      row = _fixedRows + (line - _fixedRows + _startLine) % _scrollRows;
+
+    for (int x = 0; x < Width; x++) {
+      int col = _segRemap ? x : Width - 1 - x;
+      bool lit = (_ram[(row / 8) * Width + col] >> (row & 7)) & 1;
+      if (_allOn)
+        lit = true;
+      if (_inverse)
+        lit = !lit;
+      pixels[y * Width + x] = active && lit;
+    }
+  }
+}
+
+bool writePbm(const char * path, const uint8_t * pixels, int width, int height) {
+  FILE * fp = fopen(path, "w");
+  if (!fp)
+    return false;
+
+  fprintf(fp, "P1\n%d %d\n", width, height);
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++)
+      fputc(pixels[y * width + x] ? '1' : '0', fp);
+    fputc('\n', fp);
+  }
+  return fclose(fp) == 0;
+}
+
+// Next header number of a PBM file, skips white space and comments
+static int pbmNumber(FILE * fp) {
+  int c, n = 0;
+  do {
+    c = fgetc(fp);
+    if (c == '#')
+      while ((c != '\n') && (c != EOF)) c = fgetc(fp);
+  } while (isspace(c));
+  if (!isdigit(c))
+    return -1;
+  while (isdigit(c)) {
+    n = n * 10 + (c - '0');
+    c = fgetc(fp);
+  }
+  return n; // The single white space behind the number is consumed
+}
+
+bool readPbm(const char * path, uint8_t * pixels, int width, int height) {
+  FILE * fp = fopen(path, "rb");
+  if (!fp)
+    return false;
+
+  int magic = (fgetc(fp) == 'P') ? fgetc(fp) : 0;
+  bool ok = ((magic == '1') || (magic == '4')) &&
+            (pbmNumber(fp) == width) && (pbmNumber(fp) == height);
+  for (int y = 0; ok && (y < height); y++) {
+    if (magic == '4') {
+      // Rows padded to whole bytes, MSB = left pixel
+      uint8_t row[(PanelModel::Width + 7) / 8];
+      int bytes = (width + 7) / 8;
+      ok = (bytes <= (int)sizeof(row)) && (fread(row, 1, bytes, fp) == (size_t)bytes);
+      for (int x = 0; ok && (x < width); x++)
+        pixels[y * width + x] = (row[x / 8] >> (7 - (x & 7))) & 1;
+      continue;
+    }
+    for (int x = 0; ok && (x < width); x++) {
+      int c;
+      do { c = fgetc(fp); } while (isspace(c));
+      ok = (c == '0') || (c == '1');
+      pixels[y * width + x] = (c == '1');
+    }
+  }
+  fclose(fp);
+  return ok;
+}
+
+int diffImages(const uint8_t * a, const uint8_t * b, int width, int height, uint8_t * diff) {
+  int count = 0;
+  for (int i = 0; i < width * height; i++) {
+    bool differs = (a[i] != 0) != (b[i] != 0);
+    count += differs;
+    if (diff)
+      diff[i] = differs;
+  }
+  return count;
+}
@@ -0,0 +1,84 @@
+/*
+Model of a 128x64 SSD1306 panel for the host tests.
+
+The commands and data that the driver transmits are decoded the way the
+controller does it: RAM window (COLUMNADDR/PAGEADDR, page start and column
+of the page addressing mode), the three addressing modes, start line and
+vertical scroll area, segment and COM remap, inverse, entire display on
+and display on/off.  Image() is what the glass shows then, oriented like
+the frame buffer of the driver on a module that is mounted for SEGREMAP|1
+and COMSCANDEC (the init sequence of SSD1306::Init()).  The rows of the
+vertical scroll area show the RAM rows of the same area rotated by the
+start line, as SSD1306::setScrollArea() uses it.  Contrast, timing and the
+continuous scrolls are accepted but not shown.
+
+Commands may be split across transactions, e.g. a batch that was sent in
+two parts, the parser keeps its state in between.
+
+Images are one byte per pixel, row-major, 1 = lit, the layout of the PBM
+functions below.
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+class PanelModel {
+ public:
+  static const int Width  = 128;
+  static const int Height = 64;
+  static const int Pages  = Height / 8;
+
+  PanelModel(void) { Reset(); }
+
+  // State after the reset line, the RAM is kept like on the controller
+  void Reset(void);
+  // One transaction on SPI, 'data' is the level of the DC line
+  void Write(bool data, const uint8_t * src, size_t len);
+  // One I2C write to the panel: control byte(s) and payload. Returns false
+  // for a malformed transfer.
+  bool I2cWrite(const uint8_t * src, size_t len);
+
+  void Image(uint8_t * pixels) const;
+  const uint8_t * Ram(void) const { return _ram; }
+
+  bool    IsOn(void) const { return _on; }
+  uint8_t Contrast(void) const { return _contrast; }
+  uint8_t StartLine(void) const { return _startLine; }
+  // Command bytes that are no SSD1306 command, should stay 0
+  uint32_t UnknownCommands(void) const { return _unknown; }
+
+ private:
+  void command(uint8_t c);
+  void execute(void);
+  void data(uint8_t d);
+
+  uint8_t _ram[Pages * Width];
+
+  uint8_t _cmd[8];      // Command being received and its arguments
+  uint8_t _cmdLen;
+  uint8_t _cmdNeed;     // Total length of the command in _cmd
+
+  uint8_t _mode;        // 0 horizontal, 1 vertical, 2 page addressing
+  uint8_t _col0, _col1, _page0, _page1;
+  uint8_t _col, _page;
+  uint8_t _pageCol;     // Column start of the page addressing mode
+
+  uint8_t _startLine;
+  uint8_t _fixedRows, _scrollRows;
+  uint8_t _multiplex;
+  uint8_t _offset;
+  uint8_t _contrast;
+  bool    _segRemap, _comRemap;
+  bool    _inverse, _allOn, _on;
+  uint32_t _unknown;
+};
+
+// PBM images (P1 is written, P1 and P4 are read). Return false on errors.
+bool writePbm(const char * path, const uint8_t * pixels, int width, int height);
+bool readPbm(const char * path, uint8_t * pixels, int width, int height);
+
+// Number of different pixels, the differences are marked in 'diff' if it is
+// not null
+int diffImages(const uint8_t * a, const uint8_t * b, int width, int height, uint8_t * diff);
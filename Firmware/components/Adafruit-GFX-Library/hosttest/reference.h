@@ -0,0 +1,103 @@
+/*
+Reference of the SSD1306 driver for the host tests.
+
+Adafruit_GFX with nothing but drawPixel() on a frame in the page layout of
+the SSD1306: every primitive takes the generic pixel by pixel path of
+Adafruit_GFX, as the driver did before it got its own fill, blit and text
+functions.  The output of the driver has to be the same.
+*/
+
+#pragma once
+
+#include <string.h>
+#include "Display_SSD1306.h"
+
+class ReferenceDisplay : public Adafruit_GFX {
+ public:
+  ReferenceDisplay(void) : Adafruit_GFX(SSD1306_LCDWIDTH, SSD1306_LCDHEIGHT) {
+    memset(_frame, 0, sizeof(_frame));
+  }
+
+  // Same transformation as SSD1306::drawPixel()
+  void drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if ((x < 0) || (x >= width()) || (y < 0) || (y >= height()))
+      return;
+
+    int16_t t;
+    switch (getRotation()) {
+      case 1: t = x; x = WIDTH - 1 - y; y = t;  break;
+      case 2: x = WIDTH - 1 - x; y = HEIGHT - 1 - y; break;
+      case 3: t = x; x = y; y = HEIGHT - 1 - t; break;
+    }
+
+    uint8_t * ptr = &_frame[x + (y / 8) * WIDTH];
+    switch (color) {
+      case WHITE:   *ptr |=  (1 << (y & 7)); break;
+      case BLACK:   *ptr &= ~(1 << (y & 7)); break;
+      case INVERSE: *ptr ^=  (1 << (y & 7)); break;
+    }
+  }
+
+  const uint8_t * getBuffer(void) const { return _frame; }
+
+  // Gray bitmaps are dithered pixel by pixel: the Bayer thresholds come from
+  // the recursive matrix, Floyd-Steinberg diffuses the error over the whole
+  // visible part, which is all the driver dithers.
+  void setGrayDither(SSD1306::GrayDither dither) { _dither = dither; }
+  void drawGrayscaleBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h) {
+    dither(x, y, bitmap, nullptr, w, h);
+  }
+  void drawGrayscaleBitmap(int16_t x, int16_t y, uint8_t * bitmap, int16_t w, int16_t h) {
+    dither(x, y, bitmap, nullptr, w, h);
+  }
+  void drawGrayscaleBitmap(int16_t x, int16_t y, const uint8_t bitmap[], const uint8_t mask[], int16_t w, int16_t h) {
+    dither(x, y, bitmap, mask, w, h);
+  }
+  void drawGrayscaleBitmap(int16_t x, int16_t y, uint8_t * bitmap, uint8_t * mask, int16_t w, int16_t h) {
+    dither(x, y, bitmap, mask, w, h);
+  }
+
+ private:
+  // Threshold of pixel (i, j) of the image, n x n Bayer matrix
+  static uint8_t bayerThreshold(int16_t i, int16_t j, int n) {
+    static const uint8_t M2[2][2] = { {0, 2}, {3, 1} };
+    int index = 0;
+    for (int s = 1; s < n; s <<= 1)
+      index = index * 4 + M2[(j / s) & 1][(i / s) & 1];
+    return (2 * index + 1) * 128 / (n * n);
+  }
+
+  void dither(int16_t x, int16_t y, const uint8_t * bitmap, const uint8_t * mask, int16_t w, int16_t h) {
+    static int16_t error[SSD1306_LCDWIDTH * SSD1306_LCDWIDTH];
+    int16_t i0 = (x < 0) ? -x : 0, i1 = (x + w > width()) ? width() - x : w;
+    int16_t j0 = (y < 0) ? -y : 0, j1 = (y + h > height()) ? height() - y : h;
+    int16_t n = i1 - i0;
+    if ((i0 >= i1) || (j0 >= j1))
+      return;
+    memset(error, 0, n * (j1 - j0) * sizeof(error[0]));
+
+    for (int16_t j = j0; j < j1; j++) {
+      for (int16_t i = i0; i < i1; i++) {
+        bool on;
+        if (_dither == SSD1306::DitherDiffusion) {
+          int16_t * e = &error[(j - j0) * n + (i - i0)];
+          int16_t v = bitmap[j * w + i] + e[0];
+          on = (v >= 128);
+          v = on ? v - 255 : v;
+          bool right = (i + 1 < i1), left = (i > i0), below = (j + 1 < j1);
+          if (right)          e[1]     += v * 7 / 16;
+          if (below && left)  e[n - 1] += v * 3 / 16;
+          if (below)          e[n]     += v * 5 / 16;
+          if (below && right) e[n + 1] += v - v * 7 / 16 - v * 3 / 16 - v * 5 / 16;
+        } else {
+          on = bitmap[j * w + i] >= bayerThreshold(i, j, (_dither == SSD1306::DitherBayer4) ? 4 : 8);
+        }
+        if ((mask == nullptr) || (mask[j * ((w + 7) / 8) + i / 8] & (0x80 >> (i & 7))))
+          drawPixel(x + i, y + j, on ? WHITE : BLACK);
+      }
+    }
+  }
+
+  uint8_t _frame[SSD1306_LCDWIDTH * SSD1306_LCDHEIGHT / 8];
+  SSD1306::GrayDither _dither = SSD1306::DitherBayer8;
+};
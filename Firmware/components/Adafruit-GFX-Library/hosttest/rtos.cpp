@@ -0,0 +1,66 @@
+/*
+FreeRTOS on the host: tasks are threads, semaphores are counting semaphores
+limited to one, the tick count is set by the test (hostTicks).
+*/
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "host.h"
+
+TickType_t hostTicks = 0;
+
+struct HostSemaphore {
+  std::mutex              lock;
+  std::condition_variable given;
+  bool                    available = false;
+};
+
+BaseType_t xTaskCreate(TaskFunction_t task, const char * /*name*/, uint32_t /*stackDepth*/,
+                       void * parameters, UBaseType_t /*priority*/, TaskHandle_t * created) {
+  std::thread(task, parameters).detach(); // Tasks of the display stack never end
+  if (created != nullptr)
+    *created = nullptr;
+  return pdPASS;
+}
+
+void vTaskDelay(TickType_t ticks) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ticks * portTICK_PERIOD_MS));
+}
+
+TickType_t xTaskGetTickCount(void) {
+  return hostTicks;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+  return new HostSemaphore;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks) {
+  HostSemaphore * s = (HostSemaphore *)semaphore;
+  std::unique_lock<std::mutex> guard(s->lock);
+  if (ticks == portMAX_DELAY)
+    s->given.wait(guard, [s] { return s->available; });
+  else if (!s->given.wait_for(guard, std::chrono::milliseconds(ticks * portTICK_PERIOD_MS),
+                              [s] { return s->available; }))
+    return pdFALSE;
+  s->available = false;
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+  HostSemaphore * s = (HostSemaphore *)semaphore;
+  std::lock_guard<std::mutex> guard(s->lock);
+  if (s->available)
+    return pdFALSE;
+  s->available = true;
+  s->given.notify_one();
+  return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore) {
+  delete (HostSemaphore *)semaphore;
+}
@@ -0,0 +1,22 @@
+// Host stand-in of the ESP-IDF header, only what MyHal declares
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef enum {
+  GPIO_NUM_0 = 0, GPIO_NUM_1, GPIO_NUM_2, GPIO_NUM_3, GPIO_NUM_4, GPIO_NUM_5,
+  GPIO_NUM_6, GPIO_NUM_7, GPIO_NUM_8, GPIO_NUM_9, GPIO_NUM_10, GPIO_NUM_11,
+  GPIO_NUM_12, GPIO_NUM_13, GPIO_NUM_14, GPIO_NUM_15, GPIO_NUM_16, GPIO_NUM_MAX
+} gpio_num_t;
+
+typedef enum {
+  GPIO_INTR_DISABLE = 0,
+  GPIO_INTR_POSEDGE,
+  GPIO_INTR_NEGEDGE,
+  GPIO_INTR_ANYEDGE,
+} gpio_int_type_t;
+
+typedef struct {
+  uint32_t pin_bit_mask;
+} gpio_config_t;
@@ -0,0 +1,4 @@
+// Host stand-in of the ESP-IDF header, I2cPort needs no driver types
+#pragma once
+
+#include "esp_err.h"
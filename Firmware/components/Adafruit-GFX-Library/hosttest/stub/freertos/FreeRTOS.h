@@ -0,0 +1,20 @@
+// Host stand-in of the FreeRTOS header, see rtos.cpp
+#pragma once
+
+#include <stdint.h>
+
+typedef void *   TaskHandle_t;
+typedef void *   SemaphoreHandle_t;
+typedef int      BaseType_t;
+typedef unsigned UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdTRUE  1
+#define pdFALSE 0
+#define pdPASS  pdTRUE
+#define pdFAIL  pdFALSE
+
+#define portTICK_PERIOD_MS 1
+#define portTICK_RATE_MS   portTICK_PERIOD_MS
+#define portMAX_DELAY      ((TickType_t)0xFFFFFFFF)
+#define tskIDLE_PRIORITY   0
@@ -0,0 +1,9 @@
+// Host stand-in of the FreeRTOS header, see rtos.cpp
+#pragma once
+
+#include "FreeRTOS.h"
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
+void vSemaphoreDelete(SemaphoreHandle_t semaphore);
@@ -0,0 +1,11 @@
+// Host stand-in of the FreeRTOS header, see rtos.cpp
+#pragma once
+
+#include "FreeRTOS.h"
+
+typedef void (*TaskFunction_t)(void *);
+
+BaseType_t xTaskCreate(TaskFunction_t task, const char * name, uint32_t stackDepth,
+                       void * parameters, UBaseType_t priority, TaskHandle_t * created);
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount(void);
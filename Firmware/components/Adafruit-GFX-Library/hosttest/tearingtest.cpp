@@ -0,0 +1,82 @@
+/*
+Test of the double buffered mode of the SSD1306 driver.
+
+After present() the flush task streams the frame while the next one is
+drawn into the back buffer.  Every SPI transaction takes a while here
+(hostTransferUs), so drawing and streaming overlap.  When a flush has
+ended the RAM of the panel has to equal the frame as it was presented,
+no region may show content of the frame drawn meanwhile.
+
+Prints the number of frames and how many of them were drawn during a
+flush, the exit code is 1 if a frame tore.
+
+usage: tearingtest [frames]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "Display_SSD1306.h"
+#include "host.h"
+#include "panel.h"
+
+#define FRAME_SIZE (PanelModel::Pages * PanelModel::Width)
+
+static SpiPort     spi(mode0);
+static OutputPort  dc(HostDcPin);
+static OutputPort  rst(HostResetPin);
+static PanelModel  panel;
+static SSD1306_128x64 display(&spi, &dc, &rst);
+
+// Every frame changes other regions, some of them cover several pages
+static void drawFrame(int frame) {
+  srand(frame);
+  for (int i = 0; i < 6; i++) {
+    int16_t x = rand() % 128, y = rand() % 64;
+    int16_t w = rand() % 60 + 1, h = rand() % 30 + 1;
+    display.fillRect(x, y, w, h, rand() % 3);
+  }
+  char text[16];
+  snprintf(text, sizeof(text), "%d", frame);
+  display.setTextColor(WHITE, BLACK);
+  display.setCursor(rand() % 100, rand() % 56);
+  display.print(text);
+}
+
+int main(int argc, char * argv[]) {
+  int frames = (argc > 1) ? atoi(argv[1]) : 200;
+  static uint8_t presented[FRAME_SIZE];
+  int torn = 0, overlapped = 0;
+
+  hostPanel = &panel;
+  display.Init();
+  display.display();
+  if (!display.StartFlushTask()) {
+    printf("FAIL: flush task not started\n");
+    return 1;
+  }
+  hostTransferUs = 200;
+
+  for (int frame = 0; frame < frames; frame++) {
+    drawFrame(frame);
+    memcpy(presented, display.getBuffer(), FRAME_SIZE);
+    display.present();
+
+    // The next frame is drawn while this one is streamed
+    drawFrame(frames + frame);
+    overlapped += display.isFlushing();
+
+    while (display.isFlushing())
+      usleep(50);
+    if (memcmp(panel.Ram(), presented, FRAME_SIZE)) {
+      printf("FAIL: frame %d tore\n", frame);
+      torn++;
+    }
+  }
+
+  printf("%d frames, %d drawn during a flush, %d torn\n", frames, overlapped, torn);
+  if (overlapped == 0)
+    printf("FAIL: drawing never overlapped a flush, the test proves nothing\n");
+  return (torn || !overlapped) ? 1 : 0;
+}
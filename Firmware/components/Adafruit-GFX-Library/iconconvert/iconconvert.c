@@ -0,0 +1,181 @@
+/*
+PBM to Adafruit_GFX icon set converter.
+
+NOT AN ARDUINO SKETCH.  This is a command-line tool for preprocessing
+icons to be drawn with Adafruit_GFX::drawIcon().
+
+For UNIX-like systems.  Outputs to stdout; redirect to header file, e.g.:
+  ./iconconvert StatusIcons battery.pbm wifi.pbm > StatusIcons.h
+
+Each image becomes one icon of the set, in the order of the arguments.  The
+icon is named after its file (battery_3.pbm -> StatusIcons_battery_3), so
+file names have to be valid C identifiers.  Images are plain (P1) or raw
+(P4) PBM files, 1 = set pixel.  GIMP and ImageMagick write them, and P1 is
+easy to edit in a text editor.
+
+The bitmaps are emitted in page order (see gfxicon.h): for each 8-pixel
+page row of the image one byte per column, LSB on top.  That is the
+layout of the SSD1306 frame buffer, icons starting on a page boundary are
+copied byte by byte.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdint.h>
+#include "../gfxicon.h" // Adafruit_GFX icon structures
+
+#define MAX_SIZE 255 // GFXicon stores the dimensions as bytes
+
+typedef struct {
+	char     name[64];
+	int      width, height;
+	uint8_t *pixels; // One byte per pixel, row-major
+} Image;
+
+// Next header number of a PBM file, skips white space and comments
+static int pbmNumber(FILE *fp) {
+	int c, n = 0;
+	do {
+		c = fgetc(fp);
+		if(c == '#') while((c != '\n') && (c != EOF)) c = fgetc(fp);
+	} while(isspace(c));
+	if(!isdigit(c)) return -1;
+	while(isdigit(c)) {
+		n = n * 10 + (c - '0');
+		c = fgetc(fp);
+	}
+	return n; // The single white space behind the number is consumed
+}
+
+static int readPbm(const char *path, Image *img) {
+	FILE       *fp;
+	int         magic, x, y, c;
+	const char *base, *dot;
+	size_t      len;
+
+	if(!(fp = fopen(path, "rb"))) {
+		fprintf(stderr, "%s: can't open\n", path);
+		return 0;
+	}
+	magic = (fgetc(fp) == 'P') ? fgetc(fp) : 0;
+	img->width  = pbmNumber(fp);
+	img->height = pbmNumber(fp);
+	if(((magic != '1') && (magic != '4')) ||
+	   (img->width < 1) || (img->width > MAX_SIZE) ||
+	   (img->height < 1) || (img->height > MAX_SIZE)) {
+		fprintf(stderr, "%s: not a PBM image of max. %dx%d pixels\n",
+		  path, MAX_SIZE, MAX_SIZE);
+		fclose(fp);
+		return 0;
+	}
+
+	img->pixels = (uint8_t *)calloc(img->width * img->height, 1);
+	for(y=0; y < img->height; y++) {
+		for(x=0; x < img->width; x++) {
+			if(magic == '1') {
+				do { c = fgetc(fp); } while(isspace(c));
+				if((c != '0') && (c != '1')) break;
+				img->pixels[y * img->width + x] = (c == '1');
+			} else {
+				if(!(x & 7) && ((c = fgetc(fp)) == EOF)) break;
+				img->pixels[y * img->width + x] = (c >> (7 - (x & 7))) & 1;
+			}
+		}
+		if(x < img->width) {
+			fprintf(stderr, "%s: image data too short\n", path);
+			fclose(fp);
+			return 0;
+		}
+	}
+	fclose(fp);
+
+	// Icon name is the file name without directory and extension
+	base = strrchr(path, '/');
+	base = base ? base + 1 : path;
+	dot  = strrchr(base, '.');
+	len  = dot ? (size_t)(dot - base) : strlen(base);
+	if(len >= sizeof(img->name)) len = sizeof(img->name) - 1;
+	memcpy(img->name, base, len);
+	img->name[len] = 0;
+	return 1;
+}
+
+int main(int argc, char *argv[]) {
+	Image   *images;
+	int      count, i, x, p, b, row;
+	uint8_t  byte;
+	uint32_t offset;
+	char    *set;
+
+	if(argc < 3) {
+		fprintf(stderr, "Usage: %s SetName image.pbm [image.pbm ...]\n",
+		  argv[0]);
+		return 1;
+	}
+	set   = argv[1];
+	count = argc - 2;
+	if(count > 255) {
+		fprintf(stderr, "Max. 255 icons per set\n");
+		return 1;
+	}
+	images = (Image *)calloc(count, sizeof(Image));
+	for(i=0; i<count; i++) {
+		if(!readPbm(argv[i + 2], &images[i])) return 1;
+	}
+
+	printf("// Generated by iconconvert, do not edit.  Add or change the "
+	  "images\n// and run the tool again.\n\n");
+	printf("#ifndef PROGMEM\n#define PROGMEM\n#endif\n\n");
+	printf("const uint8_t %sBitmaps[] PROGMEM = {", set);
+	for(i=0, offset=0; i<count; i++) {
+		Image *img = &images[i];
+		printf("%s\n  // %s, %dx%d\n  ", i ? "," : "", img->name,
+		  img->width, img->height);
+		row = 0;
+		for(p=0; p < (img->height + 7) / 8; p++) {
+			for(x=0; x < img->width; x++) {
+				for(b=0, byte=0; (b < 8) && (p * 8 + b < img->height); b++) {
+					if(img->pixels[(p * 8 + b) * img->width + x]) byte |= 1 << b;
+				}
+				if(row) printf((row % 12) ? ", " : ",\n  ");
+				printf("0x%02X", byte);
+				row++;
+				offset++;
+			}
+		}
+	}
+	printf(" };\n\n");
+	if(offset > 0xFFFF) {
+		fprintf(stderr, "Bitmaps exceed 64 KB\n");
+		return 1;
+	}
+
+	printf("const GFXicon %sIcons[] PROGMEM = {\n", set);
+	for(i=0, offset=0; i<count; i++) {
+		Image *img = &images[i];
+		printf("  { %5u, %3d, %3d }%s // %s\n", offset, img->width,
+		  img->height, (i < count - 1) ? ", " : "  ", img->name);
+		offset += img->width * ((img->height + 7) / 8);
+	}
+	printf("};\n\n");
+
+	printf("enum {\n");
+	for(i=0; i<count; i++) {
+		printf("  %s_%s%s\n", set, images[i].name, (i < count - 1) ? "," : "");
+	}
+	printf("};\n\n");
+
+	printf("const GFXiconSet %s PROGMEM = {\n", set);
+	printf("  (uint8_t  *)%sBitmaps,\n", set);
+	printf("  (GFXicon  *)%sIcons,\n", set);
+	printf("  %d };\n\n", count);
+
+	printf("// Approx. %u bytes\n",
+	  (unsigned)(offset + count * sizeof(GFXicon) + sizeof(GFXiconSet)));
+
+	for(i=0; i<count; i++) free(images[i].pixels);
+	free(images);
+	return 0;
+}
@@ -0,0 +1,12 @@
+#!/bin/bash
+
+# Generates the status icon set of the display from the PBM images in
+# Devices/icons.  Icons are numbered in the order of the file names, so
+# images of a sequence (battery_0 ... battery_5) stay consecutive and can
+# be selected by adding the level to the first one.
+
+convert=./iconconvert
+inpath=../../Devices/icons/
+outfile=../../Devices/include/StatusIcons.h
+
+$convert StatusIcons $inpath*.pbm > $outfile
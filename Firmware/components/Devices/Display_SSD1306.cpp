@@ -10,73 +10,49 @@
  */
 
 #include "Display_SSD1306.h"
+#include <stdlib.h>
 #include <sys/unistd.h> // for usleepCommand
 
-static uint8_t buffer[SSD1306_LCDHEIGHT * SSD1306_LCDWIDTH / 8] = {
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 
-  0x80, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x80, 0x80, 0xC0, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x80, 0xC0, 0xE0, 0xF0, 0xF8, 0xFC, 0xF8, 0xE0, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x80, 0x80, 
-  0x80, 0x80, 0x00, 0x80, 0x80, 0x00, 0x00, 0x00, 0x00, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00, 0xFF, 
-  0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x80, 0x80, 0x80, 0x80, 0x00, 0x00, 0x80, 0x80, 0x00, 0x00, 
-  0x80, 0xFF, 0xFF, 0x80, 0x80, 0x00, 0x80, 0x80, 0x00, 0x80, 0x80, 0x80, 0x80, 0x00, 0x80, 0x80, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x80, 0x00, 0x00, 0x8C, 0x8E, 0x84, 0x00, 0x00, 0x80, 0xF8, 
-  0xF8, 0xF8, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xE0, 0xE0, 0xC0, 0x80, 
-  0x00, 0xE0, 0xFC, 0xFE, 0xFF, 0xFF, 0xFF, 0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFE, 0xFF, 0xC7, 0x01, 0x01, 
-  0x01, 0x01, 0x83, 0xFF, 0xFF, 0x00, 0x00, 0x7C, 0xFE, 0xC7, 0x01, 0x01, 0x01, 0x01, 0x83, 0xFF, 
-  0xFF, 0xFF, 0x00, 0x38, 0xFE, 0xC7, 0x83, 0x01, 0x01, 0x01, 0x83, 0xC7, 0xFF, 0xFF, 0x00, 0x00, 
-  0x01, 0xFF, 0xFF, 0x01, 0x01, 0x00, 0xFF, 0xFF, 0x07, 0x01, 0x01, 0x01, 0x00, 0x00, 0x7F, 0xFF, 
-  0x80, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0x7F, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x01, 0xFF, 
-  0xFF, 0xFF, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x03, 0x0F, 0x3F, 0x7F, 0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xE7, 0xC7, 0xC7, 0x8F, 
-  0x8F, 0x9F, 0xBF, 0xFF, 0xFF, 0xC3, 0xC0, 0xF0, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFC, 0xFC, 0xFC, 
-  0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xF8, 0xF8, 0xF0, 0xF0, 0xE0, 0xC0, 0x00, 0x01, 0x03, 0x03, 0x03, 
-  0x03, 0x03, 0x01, 0x03, 0x03, 0x00, 0x00, 0x00, 0x00, 0x01, 0x03, 0x03, 0x03, 0x03, 0x01, 0x01, 
-  0x03, 0x01, 0x00, 0x00, 0x00, 0x01, 0x03, 0x03, 0x03, 0x03, 0x01, 0x01, 0x03, 0x03, 0x00, 0x00, 
-  0x00, 0x03, 0x03, 0x00, 0x00, 0x00, 0x03, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 
-  0x03, 0x03, 0x03, 0x03, 0x03, 0x01, 0x00, 0x00, 0x00, 0x01, 0x03, 0x01, 0x00, 0x00, 0x00, 0x03, 
-  0x03, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x80, 0xC0, 0xE0, 0xF0, 0xF9, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3F, 0x1F, 0x0F, 
-  0x87, 0xC7, 0xF7, 0xFF, 0xFF, 0x1F, 0x1F, 0x3D, 0xFC, 0xF8, 0xF8, 0xF8, 0xF8, 0x7C, 0x7D, 0xFF, 
-  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0x3F, 0x0F, 0x07, 0x00, 0x30, 0x30, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0xFE, 0xFE, 0xFC, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xE0, 0xC0, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0xC0, 0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0x7F, 0x3F, 0x1F, 
-  0x0F, 0x07, 0x1F, 0x7F, 0xFF, 0xFF, 0xF8, 0xF8, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0xF8, 0xE0, 
-  0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFE, 0xFE, 0x00, 0x00, 
-  0x00, 0xFC, 0xFE, 0xFC, 0x0C, 0x06, 0x06, 0x0E, 0xFC, 0xF8, 0x00, 0x00, 0xF0, 0xF8, 0x1C, 0x0E, 
-  0x06, 0x06, 0x06, 0x0C, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0xFE, 0xFE, 0x00, 0x00, 0x00, 0x00, 0xFC, 
-  0xFE, 0xFC, 0x00, 0x18, 0x3C, 0x7E, 0x66, 0xE6, 0xCE, 0x84, 0x00, 0x00, 0x06, 0xFF, 0xFF, 0x06, 
-  0x06, 0xFC, 0xFE, 0xFC, 0x0C, 0x06, 0x06, 0x06, 0x00, 0x00, 0xFE, 0xFE, 0x00, 0x00, 0xC0, 0xF8, 
-  0xFC, 0x4E, 0x46, 0x46, 0x46, 0x4E, 0x7C, 0x78, 0x40, 0x18, 0x3C, 0x76, 0xE6, 0xCE, 0xCC, 0x80, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x01, 0x07, 0x0F, 0x1F, 0x1F, 0x3F, 0x3F, 0x3F, 0x3F, 0x1F, 0x0F, 0x03, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0F, 0x0F, 0x00, 0x00, 
-  0x00, 0x0F, 0x0F, 0x0F, 0x00, 0x00, 0x00, 0x00, 0x0F, 0x0F, 0x00, 0x00, 0x03, 0x07, 0x0E, 0x0C, 
-  0x18, 0x18, 0x0C, 0x06, 0x0F, 0x0F, 0x0F, 0x00, 0x00, 0x01, 0x0F, 0x0E, 0x0C, 0x18, 0x0C, 0x0F, 
-  0x07, 0x01, 0x00, 0x04, 0x0E, 0x0C, 0x18, 0x0C, 0x0F, 0x07, 0x00, 0x00, 0x00, 0x0F, 0x0F, 0x00, 
-  0x00, 0x0F, 0x0F, 0x0F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0F, 0x0F, 0x00, 0x00, 0x00, 0x07, 
-  0x07, 0x0C, 0x0C, 0x18, 0x1C, 0x0C, 0x06, 0x06, 0x00, 0x04, 0x0E, 0x0C, 0x18, 0x0C, 0x0F, 0x07, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 
+// Adafruit splash for a 128x64 panel in page layout. Runs of zero bytes are
+// stored as 0x00 followed by the run length, see drawSplash().
+static const uint8_t splash[] = {
+  0x00, 0x3F, 0x80, 0x80, 0x80, 0x00, 0x0F, 0x80, 0x80, 0xC0, 0xC0, 0x00, 0x3F, 0x80, 0xC0, 0xE0,
+  0xF0, 0xF8, 0xFC, 0xF8, 0xE0, 0x00, 0x11, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00, 0x01, 0x80, 0x80,
+  0x00, 0x04, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00, 0x01, 0xFF, 0xFF, 0xFF, 0x00, 0x04, 0x80, 0x80,
+  0x80, 0x80, 0x00, 0x02, 0x80, 0x80, 0x00, 0x02, 0x80, 0xFF, 0xFF, 0x80, 0x80, 0x00, 0x01, 0x80,
+  0x80, 0x00, 0x01, 0x80, 0x80, 0x80, 0x80, 0x00, 0x01, 0x80, 0x80, 0x00, 0x05, 0x80, 0x80, 0x00,
+  0x02, 0x8C, 0x8E, 0x84, 0x00, 0x02, 0x80, 0xF8, 0xF8, 0xF8, 0x80, 0x00, 0x0D, 0xF0, 0xF0, 0xF0,
+  0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xE0, 0xE0, 0xC0, 0x80, 0x00, 0x01, 0xE0,
+  0xFC, 0xFE, 0xFF, 0xFF, 0xFF, 0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x0E, 0xFE, 0xFF, 0xC7,
+  0x01, 0x01, 0x01, 0x01, 0x83, 0xFF, 0xFF, 0x00, 0x02, 0x7C, 0xFE, 0xC7, 0x01, 0x01, 0x01, 0x01,
+  0x83, 0xFF, 0xFF, 0xFF, 0x00, 0x01, 0x38, 0xFE, 0xC7, 0x83, 0x01, 0x01, 0x01, 0x83, 0xC7, 0xFF,
+  0xFF, 0x00, 0x02, 0x01, 0xFF, 0xFF, 0x01, 0x01, 0x00, 0x01, 0xFF, 0xFF, 0x07, 0x01, 0x01, 0x01,
+  0x00, 0x02, 0x7F, 0xFF, 0x80, 0x00, 0x03, 0xFF, 0xFF, 0x7F, 0x00, 0x02, 0xFF, 0xFF, 0xFF, 0x00,
+  0x02, 0x01, 0xFF, 0xFF, 0xFF, 0x01, 0x00, 0x0D, 0x03, 0x0F, 0x3F, 0x7F, 0x7F, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xE7, 0xC7, 0xC7, 0x8F, 0x8F, 0x9F, 0xBF, 0xFF, 0xFF, 0xC3, 0xC0, 0xF0,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xF8, 0xF8, 0xF0,
+  0xF0, 0xE0, 0xC0, 0x00, 0x01, 0x01, 0x03, 0x03, 0x03, 0x03, 0x03, 0x01, 0x03, 0x03, 0x00, 0x04,
+  0x01, 0x03, 0x03, 0x03, 0x03, 0x01, 0x01, 0x03, 0x01, 0x00, 0x03, 0x01, 0x03, 0x03, 0x03, 0x03,
+  0x01, 0x01, 0x03, 0x03, 0x00, 0x03, 0x03, 0x03, 0x00, 0x03, 0x03, 0x03, 0x00, 0x07, 0x01, 0x03,
+  0x03, 0x03, 0x03, 0x03, 0x01, 0x00, 0x03, 0x01, 0x03, 0x01, 0x00, 0x03, 0x03, 0x03, 0x01, 0x00,
+  0x11, 0x80, 0xC0, 0xE0, 0xF0, 0xF9, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3F, 0x1F, 0x0F, 0x87, 0xC7,
+  0xF7, 0xFF, 0xFF, 0x1F, 0x1F, 0x3D, 0xFC, 0xF8, 0xF8, 0xF8, 0xF8, 0x7C, 0x7D, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0x3F, 0x0F, 0x07, 0x00, 0x01, 0x30, 0x30, 0x00, 0x16, 0xFE,
+  0xFE, 0xFC, 0x00, 0x16, 0xE0, 0xC0, 0x00, 0x0B, 0x30, 0x30, 0x00, 0x15, 0xC0, 0xFE, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0x7F, 0x3F, 0x1F, 0x0F, 0x07, 0x1F, 0x7F, 0xFF,
+  0xFF, 0xF8, 0xF8, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0xF8, 0xE0, 0x00, 0x03, 0x01, 0x00, 0x08,
+  0xFE, 0xFE, 0x00, 0x03, 0xFC, 0xFE, 0xFC, 0x0C, 0x06, 0x06, 0x0E, 0xFC, 0xF8, 0x00, 0x02, 0xF0,
+  0xF8, 0x1C, 0x0E, 0x06, 0x06, 0x06, 0x0C, 0xFF, 0xFF, 0xFF, 0x00, 0x02, 0xFE, 0xFE, 0x00, 0x04,
+  0xFC, 0xFE, 0xFC, 0x00, 0x01, 0x18, 0x3C, 0x7E, 0x66, 0xE6, 0xCE, 0x84, 0x00, 0x02, 0x06, 0xFF,
+  0xFF, 0x06, 0x06, 0xFC, 0xFE, 0xFC, 0x0C, 0x06, 0x06, 0x06, 0x00, 0x02, 0xFE, 0xFE, 0x00, 0x02,
+  0xC0, 0xF8, 0xFC, 0x4E, 0x46, 0x46, 0x46, 0x4E, 0x7C, 0x78, 0x40, 0x18, 0x3C, 0x76, 0xE6, 0xCE,
+  0xCC, 0x80, 0x00, 0x14, 0x01, 0x07, 0x0F, 0x1F, 0x1F, 0x3F, 0x3F, 0x3F, 0x3F, 0x1F, 0x0F, 0x03,
+  0x00, 0x0C, 0x0F, 0x0F, 0x00, 0x03, 0x0F, 0x0F, 0x0F, 0x00, 0x04, 0x0F, 0x0F, 0x00, 0x02, 0x03,
+  0x07, 0x0E, 0x0C, 0x18, 0x18, 0x0C, 0x06, 0x0F, 0x0F, 0x0F, 0x00, 0x02, 0x01, 0x0F, 0x0E, 0x0C,
+  0x18, 0x0C, 0x0F, 0x07, 0x01, 0x00, 0x01, 0x04, 0x0E, 0x0C, 0x18, 0x0C, 0x0F, 0x07, 0x00, 0x03,
+  0x0F, 0x0F, 0x00, 0x02, 0x0F, 0x0F, 0x0F, 0x00, 0x06, 0x0F, 0x0F, 0x00, 0x03, 0x07, 0x07, 0x0C,
+  0x0C, 0x18, 0x1C, 0x0C, 0x06, 0x06, 0x00, 0x01, 0x04, 0x0E, 0x0C, 0x18, 0x0C, 0x0F, 0x07, 0x00,
+  0x80
 };
 
 #define MYSWAP(a, b) { int16_t t = a; a = b; b = t; }
@@ -102,27 +78,50 @@ void SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color) {
     break;
   }
 
+  markDirty(x, x, y/8, y/8);
+
   // x is which column
     switch (color)
     {
-      case WHITE:   buffer[x+ (y/8)*SSD1306_LCDWIDTH] |=  (1 << (y&7)); break;
-      case BLACK:   buffer[x+ (y/8)*SSD1306_LCDWIDTH] &= ~(1 << (y&7)); break;
-      case INVERSE: buffer[x+ (y/8)*SSD1306_LCDWIDTH] ^=  (1 << (y&7)); break;
+      case WHITE:   _buffer[x+ (y/8)*WIDTH] |=  (1 << (y&7)); break;
+      case BLACK:   _buffer[x+ (y/8)*WIDTH] &= ~(1 << (y&7)); break;
+      case INVERSE: _buffer[x+ (y/8)*WIDTH] ^=  (1 << (y&7)); break;
     }
 
 }
 
-SSD1306::SSD1306(SpiPort * spiI, OutputPort * dc, OutputPort * rst) 
-  : Adafruit_GFX(SSD1306_LCDWIDTH, SSD1306_LCDHEIGHT) {
+SSD1306::SSD1306(SpiPort * spiI, OutputPort * dc, OutputPort * rst,
+                 int16_t w, int16_t h, uint8_t * buffer)
+  : Adafruit_GFX(w, h) {
   _rst = rst;
   _dc = dc;
   _spiI = spiI;
+  _buffer = buffer;
+  _pages = h / 8;
+  markAllClean();
+  markAllDirty(); // Panel RAM content is unknown after power up
+}
+
+SSD1306::SSD1306(I2cPort * i2c, uint8_t address, OutputPort * rst,
+                 int16_t w, int16_t h, uint8_t * buffer)
+  : SSD1306(nullptr, nullptr, rst, w, h, buffer) {
+  _i2c = i2c;
+  _i2cAddr = address;
+}
+
+void SSD1306::markAllDirty(void) {
+  markDirty(0, WIDTH-1, 0, _pages-1);
+}
+
+void SSD1306::markAllClean(void) {
+  memset(_dirtyFirst, 0xFF, sizeof(_dirtyFirst));
+  memset(_dirtyLast, 0x00, sizeof(_dirtyLast));
 }
 
 void SSD1306::Init(uint8_t vccstate,  bool reset) {
   _vccState = vccstate;
 
-  if (reset) { // Setup reset pin direction (used by both SPI)
+  if (reset && (_rst != nullptr)) { // I2C modules often have no reset line
     _rst->WritePort(1); // VDD (3.3V) goes high at start, lets just chill for a ms
     usleep(1000); // 1 ms
     _rst->WritePort(0);
@@ -131,74 +130,111 @@ void SSD1306::Init(uint8_t vccstate,  bool reset) {
   }
 
   // Init sequence
-  ssd1306_command(SSD1306_DISPLAYOFF);                    // 0xAE
-  ssd1306_command(SSD1306_SETDISPLAYCLOCKDIV);            // 0xD5
-  ssd1306_command(0x80);                                  // the suggested ratio 0x80
-
-  ssd1306_command(SSD1306_SETMULTIPLEX);                  // 0xA8
-  ssd1306_command(SSD1306_LCDHEIGHT - 1);
-
-  ssd1306_command(SSD1306_SETDISPLAYOFFSET);              // 0xD3
-  ssd1306_command(0x0);                                   // no offset
-  ssd1306_command(SSD1306_SETSTARTLINE | 0x0);            // line #0
-  ssd1306_command(SSD1306_CHARGEPUMP);                    // 0x8D
+  beginCommands();
+  cmd(SSD1306_DISPLAYOFF);                    // 0xAE
+  cmd(SSD1306_SETDISPLAYCLOCKDIV);            // 0xD5
+  cmd(0x80);                                  // the suggested ratio 0x80
+
+  cmd(SSD1306_SETMULTIPLEX);                  // 0xA8
+  cmd(HEIGHT - 1);
+
+  cmd(SSD1306_SETDISPLAYOFFSET);              // 0xD3
+  cmd(0x0);                                   // no offset
+  cmd(SSD1306_SETSTARTLINE | 0x0);            // line #0
+  cmd(SSD1306_CHARGEPUMP);                    // 0x8D
   if (vccstate == SSD1306_EXTERNALVCC)
-    { ssd1306_command(0x10); }
+    { cmd(0x10); }
   else
-    { ssd1306_command(0x14); }
-
-  ssd1306_command(SSD1306_MEMORYMODE);                    // 0x20
-  ssd1306_command(0x00);                                  // 0x0 act like ks0108
-  ssd1306_command(SSD1306_SEGREMAP | 0x1);
-  ssd1306_command(SSD1306_COMSCANDEC);
-
-  ssd1306_command(SSD1306_SETCOMPINS);                    // 0xDA
-  ssd1306_command(0x12);
-  ssd1306_command(SSD1306_SETCONTRAST);                   // 0x81
-  if (vccstate == SSD1306_EXTERNALVCC)
-    { ssd1306_command(0x9F); }
+    { cmd(0x14); }
+
+  cmd(SSD1306_MEMORYMODE);                    // 0x20
+  cmd(0x00);                                  // 0x0 act like ks0108
+  cmd(SSD1306_SEGREMAP | 0x1);
+  cmd(SSD1306_COMSCANDEC);
+
+  cmd(SSD1306_SETCOMPINS);                    // 0xDA
+  cmd((HEIGHT == 64) ? 0x12 : 0x02);          // alternative COM pins on 64 rows only
+  cmd(SSD1306_SETCONTRAST);                   // 0x81
+  if (HEIGHT == 32)
+    { _contrast = 0x8F; }
+  else if (vccstate == SSD1306_EXTERNALVCC)
+    { _contrast = (HEIGHT == 64) ? 0x9F : 0x10; }
   else
-    { ssd1306_command(0xCF); }
+    { _contrast = (HEIGHT == 64) ? 0xCF : 0xAF; }
+  cmd(_contrast);
 
-  ssd1306_command(SSD1306_SETPRECHARGE);                  // 0xd9
+  cmd(SSD1306_SETPRECHARGE);                  // 0xd9
   if (vccstate == SSD1306_EXTERNALVCC)
-    { ssd1306_command(0x22); }
+    { cmd(0x22); }
   else
-    { ssd1306_command(0xF1); }
-  ssd1306_command(SSD1306_SETVCOMDETECT);                 // 0xDB
-  ssd1306_command(0x40);
-  ssd1306_command(SSD1306_DISPLAYALLON_RESUME);           // 0xA4
-  ssd1306_command(SSD1306_NORMALDISPLAY);                 // 0xA6
+    { cmd(0xF1); }
+  cmd(SSD1306_SETVCOMDETECT);                 // 0xDB
+  cmd(0x40);
+  cmd(SSD1306_DISPLAYALLON_RESUME);           // 0xA4
+  cmd(SSD1306_NORMALDISPLAY);                 // 0xA6
 
-  ssd1306_command(SSD1306_DEACTIVATE_SCROLL);
+  cmd(SSD1306_DEACTIVATE_SCROLL);
 
-  ssd1306_command(SSD1306_DISPLAYON);//--turn on oled panel
+  cmd(SSD1306_DISPLAYON);//--turn on oled panel
+  commit();
 }
 
 void SSD1306::invertDisplay(uint8_t i) {
+  waitForFlush();
+  beginCommands();
   if (i) {
-    ssd1306_command(SSD1306_INVERTDISPLAY);
+    cmd(SSD1306_INVERTDISPLAY);
   } else {
-    ssd1306_command(SSD1306_NORMALDISPLAY);
+    cmd(SSD1306_NORMALDISPLAY);
   }
+  commit();
 }
 
 void SSD1306::ssd1306_command(uint8_t c) {
+  transmit(false, &c, 1);
+}
+
+// Sends commands or display data as one transaction. SPI signals the type with
+// the DC line, I2C with the control byte in front of the burst.
+void SSD1306::transmit(bool data, const uint8_t * src, size_t len) {
+  _txStats.transactions++;
+  if (data)
+    _txStats.dataBytes += len;
+  else
+    _txStats.commandBytes += len;
+
   if (_spiI != nullptr)
   {
     // SPI
-    _dc->WritePort(0);
-    _spiI->TransmitSync(&c,1);
+    _dc->WritePort(data ? 1 : 0);
+    _spiI->TransmitSync(src, len);
   }
-  else
+  else if (_i2c != nullptr)
   {
     // I2C
-    // uint8_t control = 0x00;   // Co = 0, D/C = 0
-    // Wire.beginTransmission(_i2caddr);
-    // Wire.write(control);
-    // Wire.write(c);
-    // Wire.endTransmission();
+    uint8_t control = data ? 0x40 : 0x00; // Co = 0, D/C = data
+    _i2c->WriteData(_i2cAddr, &control, 1, const_cast<uint8_t *>(src), len);
+  }
+}
+
+// Command batches are collected and sent in one transaction with DC low
+void SSD1306::beginCommands(void) {
+  _cmdLen = 0;
+}
+
+void SSD1306::cmd(uint8_t c) {
+  if (_cmdLen >= sizeof(_cmdBuf)) {
+    commit();
   }
+  _cmdBuf[_cmdLen++] = c;
+}
+
+void SSD1306::commit(void) {
+  if (_cmdLen == 0)
+    return;
+
+  transmit(false, _cmdBuf, _cmdLen);
+  _cmdLen = 0;
 }
 
 // startscrollright
@@ -206,14 +242,17 @@ void SSD1306::ssd1306_command(uint8_t c) {
 // Hint, the display is 16 rows tall. To scroll the whole display, run:
 // display.scrollright(0x00, 0x0F)
 void SSD1306::startscrollright(uint8_t start, uint8_t stop){
-  ssd1306_command(SSD1306_RIGHT_HORIZONTAL_SCROLL);
-  ssd1306_command(0X00);
-  ssd1306_command(start);
-  ssd1306_command(0X00);
-  ssd1306_command(stop);
-  ssd1306_command(0X00);
-  ssd1306_command(0XFF);
-  ssd1306_command(SSD1306_ACTIVATE_SCROLL);
+  waitForFlush();
+  beginCommands();
+  cmd(SSD1306_RIGHT_HORIZONTAL_SCROLL);
+  cmd(0X00);
+  cmd(start);
+  cmd(0X00);
+  cmd(stop);
+  cmd(0X00);
+  cmd(0XFF);
+  cmd(SSD1306_ACTIVATE_SCROLL);
+  commit();
 }
 
 // startscrollleft
@@ -221,14 +260,17 @@ void SSD1306::startscrollright(uint8_t start, uint8_t stop){
 // Hint, the display is 16 rows tall. To scroll the whole display, run:
 // display.scrollright(0x00, 0x0F)
 void SSD1306::startscrollleft(uint8_t start, uint8_t stop){
-  ssd1306_command(SSD1306_LEFT_HORIZONTAL_SCROLL);
-  ssd1306_command(0X00);
-  ssd1306_command(start);
-  ssd1306_command(0X00);
-  ssd1306_command(stop);
-  ssd1306_command(0X00);
-  ssd1306_command(0XFF);
-  ssd1306_command(SSD1306_ACTIVATE_SCROLL);
+  waitForFlush();
+  beginCommands();
+  cmd(SSD1306_LEFT_HORIZONTAL_SCROLL);
+  cmd(0X00);
+  cmd(start);
+  cmd(0X00);
+  cmd(stop);
+  cmd(0X00);
+  cmd(0XFF);
+  cmd(SSD1306_ACTIVATE_SCROLL);
+  commit();
 }
 
 // startscrolldiagright
@@ -236,16 +278,19 @@ void SSD1306::startscrollleft(uint8_t start, uint8_t stop){
 // Hint, the display is 16 rows tall. To scroll the whole display, run:
 // display.scrollright(0x00, 0x0F)
 void SSD1306::startscrolldiagright(uint8_t start, uint8_t stop){
-  ssd1306_command(SSD1306_SET_VERTICAL_SCROLL_AREA);
-  ssd1306_command(0X00);
-  ssd1306_command(SSD1306_LCDHEIGHT);
-  ssd1306_command(SSD1306_VERTICAL_AND_RIGHT_HORIZONTAL_SCROLL);
-  ssd1306_command(0X00);
-  ssd1306_command(start);
-  ssd1306_command(0X00);
-  ssd1306_command(stop);
-  ssd1306_command(0X01);
-  ssd1306_command(SSD1306_ACTIVATE_SCROLL);
+  waitForFlush();
+  beginCommands();
+  cmd(SSD1306_SET_VERTICAL_SCROLL_AREA);
+  cmd(0X00);
+  cmd(HEIGHT);
+  cmd(SSD1306_VERTICAL_AND_RIGHT_HORIZONTAL_SCROLL);
+  cmd(0X00);
+  cmd(start);
+  cmd(0X00);
+  cmd(stop);
+  cmd(0X01);
+  cmd(SSD1306_ACTIVATE_SCROLL);
+  commit();
 }
 
 // startscrolldiagleft
@@ -253,90 +298,230 @@ void SSD1306::startscrolldiagright(uint8_t start, uint8_t stop){
 // Hint, the display is 16 rows tall. To scroll the whole display, run:
 // display.scrollright(0x00, 0x0F)
 void SSD1306::startscrolldiagleft(uint8_t start, uint8_t stop){
-  ssd1306_command(SSD1306_SET_VERTICAL_SCROLL_AREA);
-  ssd1306_command(0X00);
-  ssd1306_command(SSD1306_LCDHEIGHT);
-  ssd1306_command(SSD1306_VERTICAL_AND_LEFT_HORIZONTAL_SCROLL);
-  ssd1306_command(0X00);
-  ssd1306_command(start);
-  ssd1306_command(0X00);
-  ssd1306_command(stop);
-  ssd1306_command(0X01);
-  ssd1306_command(SSD1306_ACTIVATE_SCROLL);
+  waitForFlush();
+  beginCommands();
+  cmd(SSD1306_SET_VERTICAL_SCROLL_AREA);
+  cmd(0X00);
+  cmd(HEIGHT);
+  cmd(SSD1306_VERTICAL_AND_LEFT_HORIZONTAL_SCROLL);
+  cmd(0X00);
+  cmd(start);
+  cmd(0X00);
+  cmd(stop);
+  cmd(0X01);
+  cmd(SSD1306_ACTIVATE_SCROLL);
+  commit();
 }
 
 void SSD1306::stopscroll(void){
-  ssd1306_command(SSD1306_DEACTIVATE_SCROLL);
+  waitForFlush();
+  beginCommands();
+  cmd(SSD1306_DEACTIVATE_SCROLL);
+  commit();
+}
+
+// setScrollArea
+// The first fixedRows rows are not affected by the start line, the following
+// scrollRows rows show the RAM rows of the same area rotated by the start line.
+void SSD1306::setScrollArea(uint8_t fixedRows, uint8_t scrollRows){
+  waitForFlush();
+  beginCommands();
+  cmd(SSD1306_SET_VERTICAL_SCROLL_AREA);
+  cmd(fixedRows);
+  cmd(scrollRows);
+  commit();
+}
+
+// setStartLine
+// Line must be smaller than the scrollRows of setScrollArea
+void SSD1306::setStartLine(uint8_t line){
+  waitForFlush();
+  beginCommands();
+  cmd(SSD1306_SETSTARTLINE | (line & 0x3F));
+  commit();
 }
 
 // Dim the display
 // dim = true: display is dimmed
 // dim = false: display is normal
 void SSD1306::dim(bool dim) {
-  uint8_t contrast;
+  // the range of contrast to too small to be really useful
+  // it is useful to dim the display
+  // Undimmed is the contrast that Init() chose for the panel
+  waitForFlush();
+  beginCommands();
+  cmd(SSD1306_SETCONTRAST);
+  cmd(dim ? 0 : _contrast);
+  commit();
+}
 
-  if (dim) {
-    contrast = 0; // Dimmed display
+// Sets the RAM window and pushes the buffer content of the given area.
+// With horizontal addressing the panel wraps to the next page at col1, so each
+// page of the window is a separate, contiguous slice of the buffer.
+void SSD1306::sendWindow(const uint8_t * src, uint8_t col0, uint8_t col1, uint8_t page0, uint8_t page1) {
+  beginCommands();
+  cmd(SSD1306_COLUMNADDR);
+  cmd(col0);  // Column start address
+  cmd(col1);  // Column end address
+
+  cmd(SSD1306_PAGEADDR);
+  cmd(page0); // Page start address
+  cmd(page1); // Page end address
+  commit();
+
+  if ((col0 == 0) && (col1 == WIDTH-1)) {
+    // Full width pages are adjacent in the buffer
+    transmit(true, &src[page0*WIDTH], (page1-page0+1)*WIDTH);
   } else {
-    if (_vccState == SSD1306_EXTERNALVCC) {
-      contrast = 0x9F;
-    } else {
-      contrast = 0xCF;
+    for (uint8_t p = page0; p <= page1; p++) {
+      transmit(true, &src[p*WIDTH + col0], col1-col0+1);
     }
   }
-  // the range of contrast to too small to be really useful
-  // it is useful to dim the display
-  ssd1306_command(SSD1306_SETCONTRAST);
-  ssd1306_command(contrast);
 }
 
+// Transmits the marked regions of src and clears the marks.
+// Adjacent dirty pages sharing the same column range are sent as one window,
+// all others get a window each.
+void SSD1306::transmitDirty(const uint8_t * src, uint8_t * first, uint8_t * last) {
+  uint8_t page = 0;
+  while (page < _pages) {
+    uint8_t col0 = first[page];
+    uint8_t col1 = last[page];
+    if (col0 > col1) {
+      page++;
+      continue;
+    }
+
+    uint8_t page0 = page;
+    while ((page+1 < _pages) &&
+           (first[page+1] == col0) && (last[page+1] == col1)) {
+      page++;
+    }
+    sendWindow(src, col0, col1, page0, page);
+    page++;
+  }
+  memset(first, 0xFF, _pages);
+  memset(last, 0x00, _pages);
+}
+
+// Transmits only the regions modified since the last call.
 void SSD1306::display(void) {
-  ssd1306_command(SSD1306_COLUMNADDR);
-  ssd1306_command(0);   // Column start address (0 = reset)
-  ssd1306_command(SSD1306_LCDWIDTH-1); // Column end address (127 = reset)
-
-  ssd1306_command(SSD1306_PAGEADDR);
-  ssd1306_command(0); // Page start address (0 = reset)
-  #if SSD1306_LCDHEIGHT == 64
-    ssd1306_command(7); // Page end address
-  #endif
-  #if SSD1306_LCDHEIGHT == 32
-    ssd1306_command(3); // Page end address
-  #endif
-  #if SSD1306_LCDHEIGHT == 16
-    ssd1306_command(1); // Page end address
-  #endif
+  waitForFlush();
+  transmitDirty(_buffer, _dirtyFirst, _dirtyLast);
+}
 
-  if (_spiI != nullptr)
-  {
-    // SPI
-    _dc->WritePort(1);
-    _spiI->TransmitSync(buffer, sizeof(buffer));
+// Allocates the front buffer and starts the task that streams it.
+// Returns false if there is not enough memory, display() is used then.
+bool SSD1306::StartFlushTask(UBaseType_t priority) {
+  if (_front != nullptr)
+    return true;
+
+  _front = (uint8_t *)malloc(bufferSize());
+  _flushRequest = xSemaphoreCreateBinary();
+  _flushDone = xSemaphoreCreateBinary();
+  if ((_front == nullptr) || (_flushRequest == nullptr) || (_flushDone == nullptr)) {
+    releaseFlushTask();
+    return false;
   }
-  else
-  {
-  //   // save I2C bitrate
-  //   uint8_t twbrbackup = TWBR;
-  //   TWBR = 12; // upgrade to 400KHz!
 
-  //   // I2C
-  //   for (uint16_t i=0; i<(SSD1306_LCDWIDTH*SSD1306_LCDHEIGHT/8); i++) {
-  //     // send a bunch of data in one xmission
-  //     Wire.beginTransmission(_i2caddr);
-  //     WIRE_WRITE(0x40);
-  //     for (uint8_t x=0; x<16; x++) {
-  //       WIRE_WRITE(buffer[i]);
-  //       i++;
-  //     }
-  //     i--;
-  //     Wire.endTransmission();
-  //   }
+  memcpy(_front, _buffer, bufferSize());
+  memset(_flushFirst, 0xFF, sizeof(_flushFirst));
+  memset(_flushLast, 0x00, sizeof(_flushLast));
+  xSemaphoreGive(_flushDone);
+
+  if (xTaskCreate(flushTask, "ssd1306Flush", 2048, this, priority, NULL) != pdPASS) {
+    releaseFlushTask();
+    return false;
+  }
+  return true;
+}
+
+// Frees what StartFlushTask() got so far, the driver stays in the single
+// buffered mode and a later call starts from scratch
+void SSD1306::releaseFlushTask(void) {
+  free(_front);
+  _front = nullptr;
+  if (_flushRequest != nullptr)
+    vSemaphoreDelete(_flushRequest);
+  _flushRequest = nullptr;
+  if (_flushDone != nullptr)
+    vSemaphoreDelete(_flushDone);
+  _flushDone = nullptr;
+}
+
+// Copies the modified regions to the front buffer and triggers the flush task.
+// Blocks only if the previous frame is still being transmitted, this way the
+// front buffer never changes while it is streamed.
+void SSD1306::present(void) {
+  if (_front == nullptr) {
+    display();
+    return;
+  }
+
+  xSemaphoreTake(_flushDone, portMAX_DELAY);
+  for (uint8_t p = 0; p < _pages; p++) {
+    uint8_t col0 = _dirtyFirst[p];
+    uint8_t col1 = _dirtyLast[p];
+    if (col0 > col1)
+      continue;
+
+    uint16_t offset = p*WIDTH + col0;
+    memcpy(&_front[offset], &_buffer[offset], col1-col0+1);
+    if (col0 < _flushFirst[p]) _flushFirst[p] = col0;
+    if (col1 > _flushLast[p])  _flushLast[p]  = col1;
+  }
+  markAllClean();
+
+  _flushing = true;
+  xSemaphoreGive(_flushRequest);
+}
+
+// Commands must not interleave with a running data transfer
+void SSD1306::waitForFlush(void) {
+  if (_front == nullptr)
+    return;
+
+  xSemaphoreTake(_flushDone, portMAX_DELAY);
+  xSemaphoreGive(_flushDone);
+}
+
+void SSD1306::flushTask(void * pvParameters) {
+  SSD1306 * display = (SSD1306 *)pvParameters;
+
+  while (true) {
+    xSemaphoreTake(display->_flushRequest, portMAX_DELAY);
+    display->transmitDirty(display->_front, display->_flushFirst, display->_flushLast);
+    display->_flushing = false;
+    xSemaphoreGive(display->_flushDone);
   }
 }
 
 // clear everything
 void SSD1306::clearDisplay(void) {
-  memset(buffer, 0, (sizeof(buffer)));
+  memset(_buffer, 0, (bufferSize()));
+  markAllDirty();
+}
+
+// Decodes the splash from flash into the frame. Panels with less rows show the
+// middle pages of it, narrower ones the left part.
+void SSD1306::drawSplash(void) {
+  const uint8_t splashPages = 8;
+  const uint16_t first = (splashPages - _pages) / 2 * 128; // Splash bytes to skip
+  const uint16_t end = first + _pages * 128;
+
+  memset(_buffer, 0, bufferSize());
+  uint16_t pos = 0;
+  for (uint16_t i = 0; (i < sizeof(splash)) && (pos < end); i++) {
+    uint8_t value = splash[i];
+    uint16_t run = (value == 0x00) ? splash[++i] : 1;
+    for (; run > 0; run--, pos++) {
+      uint8_t x = pos & 127;
+      if ((pos >= first) && (pos < end) && (x < WIDTH)) {
+        _buffer[(pos - first) / 128 * WIDTH + x] = value;
+      }
+    }
+  }
+  markAllDirty();
 }
 
 void SSD1306::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
@@ -391,10 +576,12 @@ void SSD1306::drawFastHLineInternal(int16_t x, int16_t y, int16_t w, uint16_t co
   // if our width is now negative, punt
   if(w <= 0) { return; }
 
+  markDirty(x, x+w-1, y/8, y/8);
+
   // set up the pointer for  movement through the buffer
-  register uint8_t *pBuf = buffer;
+  register uint8_t *pBuf = _buffer;
   // adjust the buffer pointer for the current row
-  pBuf += ((y/8) * SSD1306_LCDWIDTH);
+  pBuf += ((y/8) * WIDTH);
   // and offset x columns in
   pBuf += x;
 
@@ -442,6 +629,122 @@ void SSD1306::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
 }
 
 
+// Spans are clipped already, the rotation is resolved per batch. Vertical spans
+// in panel orientation are written as whole page bytes. Horizontal spans are
+// collected per page and written in one pass per page, so each byte is
+// modified once instead of once per row.
+void SSD1306::fillSpans(const GFXspan * spans, uint16_t count, bool vertical, uint16_t color) {
+  // Spans that are vertical on the panel, see drawFastVLine/drawFastHLine
+  bool column = vertical != (rotation & 1);
+  uint8_t rowFirst[SSD1306_LCDPAGES][8];
+  uint8_t rowEnd[SSD1306_LCDPAGES][8];  // Behind the last column
+  uint8_t rowBits[SSD1306_LCDPAGES] = {};
+
+  for (uint16_t i = 0; i < count; i++) {
+    int16_t x = spans[i].x;
+    int16_t y = spans[i].y;
+    int16_t len = spans[i].len;
+    int16_t t;
+
+    switch (rotation) {
+      case 1:
+        t = x;
+        x = vertical ? WIDTH - y - len : WIDTH - 1 - y;
+        y = t;
+        break;
+      case 2:
+        x = vertical ? WIDTH - 1 - x : WIDTH - x - len;
+        y = vertical ? HEIGHT - y - len : HEIGHT - 1 - y;
+        break;
+      case 3:
+        t = x;
+        x = y;
+        y = vertical ? HEIGHT - 1 - t : HEIGHT - t - len;
+        break;
+    }
+
+    if (column) {
+      drawFastVLineInternal(x, y, len, color);
+      continue;
+    }
+
+    if ((y < 0) || (y >= HEIGHT)) continue;
+    if (x < 0) { len += x; x = 0; }
+    if (x + len > WIDTH) len = WIDTH - x;
+    if (len <= 0) continue;
+
+    uint8_t page = y / 8;
+    uint8_t row = y & 7;
+    if (rowBits[page] & (1 << row)) {
+      // Overlapping spans of a row are joined for WHITE and BLACK. Otherwise
+      // the collected rows are written first, INVERSE must toggle twice.
+      uint8_t & first = rowFirst[page][row];
+      uint8_t & end = rowEnd[page][row];
+      if ((color != INVERSE) && (x <= end) && (x + len >= first)) {
+        if (x < first) first = x;
+        if (x + len > end) end = x + len;
+        continue;
+      }
+      fillPageRows(page, rowBits[page], rowFirst[page], rowEnd[page], color);
+      rowBits[page] = 0;
+    }
+    rowFirst[page][row] = x;
+    rowEnd[page][row] = x + len;
+    rowBits[page] |= (1 << row);
+  }
+
+  for (uint8_t page = 0; page < _pages; page++) {
+    if (rowBits[page])
+      fillPageRows(page, rowBits[page], rowFirst[page], rowEnd[page], color);
+  }
+}
+
+// Writes the collected rows of one page. The mask of a column only changes at
+// the ends of the rows, the columns between two ends get the same mask.
+void SSD1306::fillPageRows(uint8_t page, uint8_t rows, const uint8_t * first, const uint8_t * end,
+                           uint16_t color) {
+  uint8_t edge[16];
+  uint8_t toggle[16];
+  uint8_t edges = 0;
+
+  // Row ends sorted by column, each toggles the bit of its row
+  for (uint8_t row = 0; row < 8; row++) {
+    if (!(rows & (1 << row)))
+      continue;
+
+    for (uint8_t e = 0; e < 2; e++) {
+      uint8_t x = e ? end[row] : first[row];
+      uint8_t k = edges++;
+      while ((k > 0) && (edge[k - 1] > x)) {
+        edge[k] = edge[k - 1];
+        toggle[k] = toggle[k - 1];
+        k--;
+      }
+      edge[k] = x;
+      toggle[k] = 1 << row;
+    }
+  }
+
+  markDirty(edge[0], edge[edges - 1] - 1, page, page);
+
+  uint8_t * row = &_buffer[page * WIDTH];
+  uint8_t mask = 0;
+  for (uint8_t k = 0; k + 1 < edges; k++) {
+    mask ^= toggle[k];
+    if ((mask == 0) || (edge[k] == edge[k + 1]))
+      continue;
+
+    uint8_t * pBuf = row + edge[k];
+    uint8_t w = edge[k + 1] - edge[k];
+    switch (color)
+    {
+      case WHITE:   while (w--) { *pBuf++ |=  mask; } break;
+      case BLACK:   while (w--) { *pBuf++ &= ~mask; } break;
+      case INVERSE: while (w--) { *pBuf++ ^=  mask; } break;
+    }
+  }
+}
+
 void SSD1306::drawFastVLineInternal(int16_t x, int16_t __y, int16_t __h, uint16_t color) {
 
   // do nothing if we're off the left or right side of the screen
@@ -465,15 +768,17 @@ void SSD1306::drawFastVLineInternal(int16_t x, int16_t __y, int16_t __h, uint16_
     return;
   }
 
+  markDirty(x, x, __y/8, (__y+__h-1)/8);
+
   // this display doesn't need ints for coordinates, use local byte registers for faster juggling
   register uint8_t y = __y;
   register uint8_t h = __h;
 
 
   // set up the pointer for fast movement through the buffer
-  register uint8_t *pBuf = buffer;
+  register uint8_t *pBuf = _buffer;
   // adjust the buffer pointer for the current row
-  pBuf += ((y/8) * SSD1306_LCDWIDTH);
+  pBuf += ((y/8) * WIDTH);
   // and offset x columns in
   pBuf += x;
 
@@ -505,7 +810,7 @@ void SSD1306::drawFastVLineInternal(int16_t x, int16_t __y, int16_t __h, uint16_
 
     h -= mod;
 
-    pBuf += SSD1306_LCDWIDTH;
+    pBuf += WIDTH;
   }
 
 
@@ -516,7 +821,7 @@ void SSD1306::drawFastVLineInternal(int16_t x, int16_t __y, int16_t __h, uint16_
       *pBuf=~(*pBuf);
 
         // adjust the buffer forward 8 rows worth of data
-        pBuf += SSD1306_LCDWIDTH;
+        pBuf += WIDTH;
 
         // adjust h & y (there's got to be a faster way for me to do this, but this should still help a fair bit for now)
         h -= 8;
@@ -531,7 +836,7 @@ void SSD1306::drawFastVLineInternal(int16_t x, int16_t __y, int16_t __h, uint16_
       *pBuf = val;
 
         // adjust the buffer forward 8 rows worth of data
-        pBuf += SSD1306_LCDWIDTH;
+        pBuf += WIDTH;
 
         // adjust h & y (there's got to be a faster way for me to do this, but this should still help a fair bit for now)
         h -= 8;
@@ -555,3 +860,540 @@ void SSD1306::drawFastVLineInternal(int16_t x, int16_t __y, int16_t __h, uint16_
     }
   }
 }
+
+static inline void applyMask(uint8_t * pBuf, uint8_t mask, uint16_t color) {
+  switch (color)
+  {
+    case WHITE:   *pBuf |=  mask;  break;
+    case BLACK:   *pBuf &= ~mask;  break;
+    case INVERSE: *pBuf ^=  mask;  break;
+  }
+}
+
+void SSD1306::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  if ((w <= 0) || (h <= 0)) { return; }
+
+  // Transform the rectangle to panel coordinates, see drawPixel
+  switch (rotation) {
+    case 1:
+      MYSWAP(x, y);
+      MYSWAP(w, h);
+      x = WIDTH - x - w;
+      break;
+    case 2:
+      x = WIDTH - x - w;
+      y = HEIGHT - y - h;
+      break;
+    case 3:
+      MYSWAP(x, y);
+      MYSWAP(w, h);
+      y = HEIGHT - y - h;
+      break;
+  }
+  fillRectInternal(x, y, w, h, color);
+}
+
+// Fills whole page bytes at once, only the top and bottom page need masking
+void SSD1306::fillRectInternal(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  if (color > INVERSE) { return; }
+
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if ((x + w) > WIDTH)  { w = WIDTH - x; }
+  if ((y + h) > HEIGHT) { h = HEIGHT - y; }
+  if ((w <= 0) || (h <= 0)) { return; }
+
+  uint8_t page0 = y / 8;
+  uint8_t page1 = (y + h - 1) / 8;
+  markDirty(x, x+w-1, page0, page1);
+
+  for (uint8_t p = page0; p <= page1; p++) {
+    uint8_t mask = 0xFF;
+    if (p == page0) { mask &= 0xFF << (y & 7); }
+    if (p == page1) { mask &= 0xFF >> (7 - ((y + h - 1) & 7)); }
+
+    uint8_t *pBuf = &_buffer[p * WIDTH + x];
+    if ((mask == 0xFF) && (color != INVERSE)) {
+      memset(pBuf, (color == WHITE) ? 0xFF : 0x00, w);
+    } else {
+      for (int16_t i = 0; i < w; i++) {
+        applyMask(pBuf++, mask, color);
+      }
+    }
+  }
+}
+
+void SSD1306::shiftLeft(int16_t x, int16_t y, int16_t w, int16_t h, int16_t n) {
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if ((x + w) > WIDTH)  { w = WIDTH - x; }
+  if ((y + h) > HEIGHT) { h = HEIGHT - y; }
+  if ((w <= 0) || (h <= 0) || (n <= 0)) { return; }
+  if (n >= w) {
+    fillRectInternal(x, y, w, h, BLACK);
+    return;
+  }
+
+  uint8_t page0 = y / 8;
+  uint8_t page1 = (y + h - 1) / 8;
+  markDirty(x, x+w-1, page0, page1);
+
+  for (uint8_t p = page0; p <= page1; p++) {
+    uint8_t mask = 0xFF;
+    if (p == page0) { mask &= 0xFF << (y & 7); }
+    if (p == page1) { mask &= 0xFF >> (7 - ((y + h - 1) & 7)); }
+
+    uint8_t *pBuf = &_buffer[p * WIDTH + x];
+    if (mask == 0xFF) {
+      memmove(pBuf, pBuf + n, w - n);
+      memset(pBuf + w - n, 0x00, n);
+    } else {
+      for (int16_t i = 0; i < w; i++) {
+        uint8_t src = (i + n < w) ? pBuf[i + n] : 0x00;
+        pBuf[i] = (pBuf[i] & ~mask) | (src & mask);
+      }
+    }
+  }
+}
+
+// writePages
+// One copy for the whole range, each page holds WIDTH bytes. The pages are
+// transmitted completely with the next display().
+void SSD1306::writePages(uint8_t page0, uint8_t pages, const uint8_t * src) {
+  if (page0 >= _pages) { return; }
+  if (pages > (_pages - page0)) { pages = _pages - page0; }
+  if (pages == 0) { return; }
+
+  uint8_t *pBuf = &_buffer[page0 * WIDTH];
+  if (src) {
+    memcpy(pBuf, src, pages * WIDTH);
+  } else {
+    memset(pBuf, 0x00, pages * WIDTH);
+  }
+  markDirty(0, WIDTH-1, page0, page0 + pages - 1);
+}
+
+void SSD1306::fillScreen(uint16_t color) {
+  switch (color)
+  {
+    case WHITE:   memset(_buffer, 0xFF, bufferSize()); break;
+    case BLACK:   memset(_buffer, 0x00, bufferSize()); break;
+    case INVERSE:
+      for (uint16_t i = 0; i < bufferSize(); i++) { _buffer[i] = ~_buffer[i]; }
+      break;
+    default: return;
+  }
+  markAllDirty();
+}
+
+void SSD1306::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color) {
+  if (rotation != 0) {
+    Adafruit_GFX::drawBitmap(x, y, bitmap, w, h, color);
+    return;
+  }
+  blitBitmap(x, y, bitmap, w, h, color, color, false);
+}
+
+void SSD1306::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color, uint16_t bg) {
+  if (rotation != 0) {
+    Adafruit_GFX::drawBitmap(x, y, bitmap, w, h, color, bg);
+    return;
+  }
+  blitBitmap(x, y, bitmap, w, h, color, bg, true);
+}
+
+void SSD1306::drawBitmap(int16_t x, int16_t y, uint8_t *bitmap, int16_t w, int16_t h, uint16_t color) {
+  drawBitmap(x, y, (const uint8_t *)bitmap, w, h, color);
+}
+
+void SSD1306::drawBitmap(int16_t x, int16_t y, uint8_t *bitmap, int16_t w, int16_t h, uint16_t color, uint16_t bg) {
+  drawBitmap(x, y, (const uint8_t *)bitmap, w, h, color, bg);
+}
+
+// 8x8 bit matrix transpose (Hacker's Delight, 7-3).
+// Turns 8 bitmap rows (MSB = left) into 8 page columns (LSB = top).
+static void transpose8(const uint8_t * rows, uint8_t * cols) {
+  uint32_t x, y, t;
+
+  x = ((uint32_t)rows[7] << 24) | ((uint32_t)rows[6] << 16) | ((uint32_t)rows[5] << 8) | rows[4];
+  y = ((uint32_t)rows[3] << 24) | ((uint32_t)rows[2] << 16) | ((uint32_t)rows[1] << 8) | rows[0];
+
+  t = (x ^ (x >> 7)) & 0x00AA00AA;  x = x ^ t ^ (t << 7);
+  t = (y ^ (y >> 7)) & 0x00AA00AA;  y = y ^ t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCC; x = x ^ t ^ (t << 14);
+  t = (y ^ (y >> 14)) & 0x0000CCCC; y = y ^ t ^ (t << 14);
+  t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+  y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+  x = t;
+
+  cols[0] = x >> 24; cols[1] = x >> 16; cols[2] = x >> 8; cols[3] = x;
+  cols[4] = y >> 24; cols[5] = y >> 16; cols[6] = y >> 8; cols[7] = y;
+}
+
+// Marks the visible part of a panel area as dirty, returns false if nothing is visible
+bool SSD1306::markArea(int16_t x, int16_t y, int16_t w, int16_t h) {
+  int16_t x0 = (x < 0) ? 0 : x;
+  int16_t y0 = (y < 0) ? 0 : y;
+  int16_t x1 = (x + w > WIDTH) ? WIDTH - 1 : x + w - 1;
+  int16_t y1 = (y + h > HEIGHT) ? HEIGHT - 1 : y + h - 1;
+  if ((x1 < x0) || (y1 < y0)) { return false; }
+  markDirty(x0, x1, y0 / 8, y1 / 8);
+  return true;
+}
+
+// Writes a vertical byte that starts 'shift' rows below the top of 'page'
+void SSD1306::blitColumn(int16_t x, int16_t page, uint8_t shift, uint8_t bits, uint16_t color) {
+  if (bits == 0) { return; }
+
+  if ((page >= 0) && (page < _pages)) {
+    applyMask(&_buffer[page * WIDTH + x], bits << shift, color);
+  }
+  if (shift && (page + 1 < _pages)) {
+    applyMask(&_buffer[(page + 1) * WIDTH + x], bits >> (8 - shift), color);
+  }
+}
+
+// Draws a row-major bitmap (Adafruit format) in blocks of 8x8 pixels that are
+// transposed to page columns and shifted into place.
+void SSD1306::blitBitmap(int16_t x, int16_t y, const uint8_t * bitmap, int16_t w, int16_t h,
+                         uint16_t color, uint16_t bg, bool opaque) {
+  if (!markArea(x, y, w, h)) { return; }
+
+  int16_t byteWidth = (w + 7) / 8; // Bitmap scanline pad = whole byte
+  uint8_t rows[8], cols[8];
+
+  for (int16_t j = 0; j < h; j += 8) {
+    int16_t top = y + j;
+    if ((top <= -8) || (top >= HEIGHT)) { continue; }
+
+    uint8_t valid = (h - j >= 8) ? 0xFF : (0xFF >> (8 - (h - j)));
+    int16_t page = (top + 8) / 8 - 1; // Rounds down for negative rows too
+    uint8_t shift = (top + 8) & 7;
+
+    for (int16_t bx = 0; bx < byteWidth; bx++) {
+      for (uint8_t k = 0; k < 8; k++) {
+        rows[k] = (j + k < h) ? bitmap[(j + k) * byteWidth + bx] : 0;
+      }
+      transpose8(rows, cols);
+
+      for (uint8_t i = 0; (i < 8) && (bx * 8 + i < w); i++) {
+        int16_t col = x + bx * 8 + i;
+        if ((col < 0) || (col >= WIDTH)) { continue; }
+
+        blitColumn(col, page, shift, cols[i] & valid, color);
+        if (opaque) {
+          blitColumn(col, page, shift, ~cols[i] & valid, bg);
+        }
+      }
+    }
+  }
+}
+
+// Adds the bits in mask to the operation of blitColumnBits for one color
+static inline void foldColor(uint8_t mask, uint16_t color, uint8_t & keep, uint8_t & set, uint8_t & flip) {
+  switch (color)
+  {
+    case WHITE:   set  |=  mask; break;
+    case BLACK:   keep &= ~mask; break;
+    case INVERSE: flip ^=  mask; break;
+  }
+}
+
+// Writes up to 32 vertical bits (LSB = top) starting at row 'top' into
+// 'columns' neighbouring columns. Set bits get color, clear bits get bg unless
+// both are equal (transparent). Each page byte is composed once and written to
+// all columns.
+void SSD1306::blitColumnBits(int16_t x, int16_t top, uint32_t bits, uint8_t rows, uint16_t color, uint16_t bg,
+                             uint8_t columns) {
+  int16_t x0 = (x < 0) ? 0 : x;
+  int16_t x1 = (x + columns > WIDTH) ? WIDTH : x + columns;
+  if ((x0 >= x1) || (top + rows <= 0) || (top >= HEIGHT)) { return; }
+
+  bool opaque = (bg != color);
+  uint32_t cover = (rows >= 32) ? 0xFFFFFFFF : ((1UL << rows) - 1);
+  int16_t page0 = (top < 0) ? 0 : top / 8;
+  int16_t page1 = (top + rows - 1) / 8;
+  if (page1 >= _pages) { page1 = _pages - 1; }
+
+  for (int16_t page = page0; page <= page1; page++) {
+    // Bits of this page, 'offset' is the row of the page top relative to 'top'
+    int16_t offset = page * 8 - top;
+    uint8_t valid = (offset >= 0) ? (cover >> offset) : (cover << -offset);
+    uint8_t chunk = ((offset >= 0) ? (bits >> offset) : (bits << -offset)) & valid;
+
+    // Both colors folded into one operation: ((byte & keep) | set) ^ flip
+    uint8_t keep = 0xFF, set = 0, flip = 0;
+    foldColor(chunk, color, keep, set, flip);
+    if (opaque) {
+      foldColor(~chunk & valid, bg, keep, set, flip);
+    }
+
+    uint8_t * pBuf = &_buffer[page * WIDTH + x0];
+    for (int16_t c = x0; c < x1; c++, pBuf++) {
+      *pBuf = ((*pBuf & keep) | set) ^ flip;
+    }
+  }
+}
+
+// Each nibble of a column byte stretched to 2, 3 and 4 bits per bit
+static const uint8_t  Stretch2[16] = {
+  0x00, 0x03, 0x0C, 0x0F, 0x30, 0x33, 0x3C, 0x3F, 0xC0, 0xC3, 0xCC, 0xCF, 0xF0, 0xF3, 0xFC, 0xFF };
+static const uint16_t Stretch3[16] = {
+  0x000, 0x007, 0x038, 0x03F, 0x1C0, 0x1C7, 0x1F8, 0x1FF, 0xE00, 0xE07, 0xE38, 0xE3F, 0xFC0, 0xFC7, 0xFF8, 0xFFF };
+static const uint16_t Stretch4[16] = {
+  0x0000, 0x000F, 0x00F0, 0x00FF, 0x0F00, 0x0F0F, 0x0FF0, 0x0FFF,
+  0xF000, 0xF00F, 0xF0F0, 0xF0FF, 0xFF00, 0xFF0F, 0xFFF0, 0xFFFF };
+
+// Stretches each bit of a column byte to 'size' bits, size 1..MaxScaledTextSize
+static inline uint32_t expandBits(uint8_t line, uint8_t size) {
+  switch (size) {
+    case 2:  return Stretch2[line & 0x0F] | ((uint32_t)Stretch2[line >> 4] << 8);
+    case 3:  return Stretch3[line & 0x0F] | ((uint32_t)Stretch3[line >> 4] << 12);
+    case 4:  return Stretch4[line & 0x0F] | ((uint32_t)Stretch4[line >> 4] << 16);
+    default: return line;
+  }
+}
+
+void SSD1306::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size) {
+  if ((rotation != 0) || (size > MaxScaledTextSize) || (gfxFont != nullptr)) {
+    Adafruit_GFX::drawChar(x, y, c, color, bg, size); // Custom fonts end up in drawGlyph
+    return;
+  }
+
+  // 'Classic' built-in font, stored as page columns already
+  if ((x >= _width) || (y >= _height) ||
+      ((x + 6 * size - 1) < 0) || ((y + 8 * size - 1) < 0))
+    return;
+
+  if (!_cp437 && (c >= 176)) c++; // Handle 'classic' charset behavior
+
+  uint8_t rows = 8 * size;
+  markArea(x, y, 6 * size, rows);
+
+  if ((size == 1) && (x >= 0) && (x + 6 <= WIDTH) && (color <= WHITE) && (bg <= WHITE)) {
+    // Most common case: opaque or transparent text with all columns visible, one or
+    // two page rows. Opaque text writes the whole cell, transparent the set bits only.
+    const uint8_t * glyph = &font[c * 5];
+    int16_t page = (y + 8) / 8 - 1;
+    uint8_t shift = (y + 8) & 7;
+    bool opaque = (color != bg);
+    uint8_t inv = (color == WHITE) ? 0x00 : 0xFF;
+    uint8_t * pUpper = ((page >= 0) && (page < _pages))
+      ? &_buffer[page * WIDTH + x] : nullptr;
+    uint8_t * pLower = (shift && (page + 1 < _pages))
+      ? &_buffer[(page + 1) * WIDTH + x] : nullptr;
+
+    for (uint8_t i = 0; i < 6; i++) {
+      uint8_t bits = (i < 5) ? glyph[i] : 0;
+      uint8_t mask = opaque ? 0xFF : bits;
+      uint8_t line = (bits ^ inv) & mask;
+      if (pUpper) { pUpper[i] = (pUpper[i] & ~(uint8_t)(mask << shift)) | (uint8_t)(line << shift); }
+      if (pLower) { pLower[i] = (pLower[i] & ~(uint8_t)(mask >> (8 - shift))) | (uint8_t)(line >> (8 - shift)); }
+    }
+    return;
+  }
+
+  for (uint8_t i = 0; i < 6; i++) { // 5 glyph columns and the spacing column
+    uint32_t bits = expandBits((i < 5) ? font[c * 5 + i] : 0, size);
+    blitColumnBits(x + i * size, y, bits, rows, color, bg, size);
+  }
+}
+
+void SSD1306::drawGlyph(int16_t x, int16_t y, uint16_t index, uint16_t color, uint8_t size) {
+  if ((rotation != 0) || (size > MaxScaledTextSize) || (_atlas == nullptr) || (_atlas->Font() != gfxFont)) {
+    Adafruit_GFX::drawGlyph(x, y, index, color, size);
+    return;
+  }
+
+  // No background by design (see Adafruit_GFX::drawChar)
+  const GFXglyph * glyph = &gfxFont->glyph[index];
+  uint8_t w  = glyph->width;
+  uint8_t h  = glyph->height;
+  int8_t  xo = glyph->xOffset;
+  int8_t  yo = glyph->yOffset;
+  uint8_t pages = (h + 7) / 8;
+  const uint8_t * cols = _atlas->Columns(index);
+
+  if (!markArea(x + xo * size, y + yo * size, w * size, h * size)) { return; }
+  for (uint8_t i = 0; i < w; i++) {
+    for (uint8_t p = 0; p < pages; p++) {
+      uint8_t rows = ((h - p * 8) >= 8) ? 8 : (h - p * 8);
+      uint32_t bits = expandBits(cols[i * pages + p], size);
+      int16_t top = y + (yo + p * 8) * size;
+      blitColumnBits(x + (xo + i) * size, top, bits, rows * size, color, color, size);
+    }
+  }
+}
+
+void SSD1306::drawIcon(int16_t x, int16_t y, const GFXiconSet * set, uint8_t index, uint16_t color, uint16_t bg) {
+  if (rotation != 0) {
+    Adafruit_GFX::drawIcon(x, y, set, index, color, bg);
+    return;
+  }
+
+  const GFXicon * icon = &set->icon[index];
+  const uint8_t * bitmap = &set->bitmap[icon->bitmapOffset];
+  uint8_t w = icon->width;
+  uint8_t h = icon->height;
+  uint8_t pages = (h + 7) / 8;
+
+  if (!markArea(x, y, w, h)) { return; }
+
+  if (((y & 7) == 0) && ((h & 7) == 0) && (x >= 0) && (x + w <= WIDTH) && (y >= 0) && (y + h <= HEIGHT) &&
+      (color != bg) && (color <= WHITE) && (bg <= WHITE)) {
+    // Aligned blit, the icon pages are frame buffer pages already
+    for (uint8_t p = 0; p < pages; p++) {
+      uint8_t * pBuf = &_buffer[(y / 8 + p) * WIDTH + x];
+      const uint8_t * src = &bitmap[p * w];
+      if (color == WHITE) {
+        memcpy(pBuf, src, w);
+      } else {
+        for (uint8_t i = 0; i < w; i++) { pBuf[i] = ~src[i]; }
+      }
+    }
+    return;
+  }
+
+  for (uint8_t p = 0; p < pages; p++) {
+    uint8_t rows = ((h - p * 8) >= 8) ? 8 : (h - p * 8);
+    for (uint8_t i = 0; i < w; i++) {
+      blitColumnBits(x + i, y + p * 8, bitmap[p * w + i], rows, color, bg);
+    }
+  }
+}
+
+void SSD1306::drawGrayscaleBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h) {
+  ditherBitmap(x, y, bitmap, nullptr, w, h);
+}
+
+void SSD1306::drawGrayscaleBitmap(int16_t x, int16_t y, uint8_t *bitmap, int16_t w, int16_t h) {
+  ditherBitmap(x, y, bitmap, nullptr, w, h);
+}
+
+void SSD1306::drawGrayscaleBitmap(int16_t x, int16_t y, const uint8_t bitmap[], const uint8_t mask[],
+                                  int16_t w, int16_t h) {
+  ditherBitmap(x, y, bitmap, mask, w, h);
+}
+
+void SSD1306::drawGrayscaleBitmap(int16_t x, int16_t y, uint8_t *bitmap, uint8_t *mask, int16_t w, int16_t h) {
+  ditherBitmap(x, y, bitmap, mask, w, h);
+}
+
+// Thresholds of the Bayer matrices, (2 * n + 1) * 128 / cells, stored column by
+// column. The 4x4 matrix is repeated to 8x8, so both are looked up the same way.
+static const uint8_t Bayer4Threshold[8 * 8] = {
+    8, 200,  56, 248,   8, 200,  56, 248,
+  136,  72, 184, 120, 136,  72, 184, 120,
+   40, 232,  24, 216,  40, 232,  24, 216,
+  168, 104, 152,  88, 168, 104, 152,  88,
+    8, 200,  56, 248,   8, 200,  56, 248,
+  136,  72, 184, 120, 136,  72, 184, 120,
+   40, 232,  24, 216,  40, 232,  24, 216,
+  168, 104, 152,  88, 168, 104, 152,  88 };
+static const uint8_t Bayer8Threshold[8 * 8] = {
+    2, 194,  50, 242,  14, 206,  62, 254,
+  130,  66, 178, 114, 142,  78, 190, 126,
+   34, 226,  18, 210,  46, 238,  30, 222,
+  162,  98, 146,  82, 174, 110, 158,  94,
+   10, 202,  58, 250,   6, 198,  54, 246,
+  138,  74, 186, 122, 134,  70, 182, 118,
+   42, 234,  26, 218,  38, 230,  22, 214,
+  170, 106, 154,  90, 166, 102, 150,  86 };
+
+// Bits of the 1-bit mask (drawBitmap() layout) in column i, rows j..j+rows-1
+static uint32_t maskColumn(const uint8_t * mask, int16_t w, int16_t i, int16_t j, uint8_t rows) {
+  if (mask == nullptr) { return 0xFFFFFFFF; }
+
+  int16_t byteWidth = (w + 7) / 8;
+  const uint8_t * src = &mask[j * byteWidth + i / 8];
+  uint8_t bit = 0x80 >> (i & 7);
+  uint32_t bits = 0;
+  for (uint8_t k = 0; k < rows; k++, src += byteWidth) {
+    if (*src & bit) { bits |= 1UL << k; }
+  }
+  return bits;
+}
+
+// Writes dithered column bits, set bits white and clear bits black, where mask is set
+void SSD1306::writeDithered(int16_t x, int16_t top, uint32_t bits, uint32_t mask, uint8_t rows) {
+  if (rotation != 0) {
+    for (uint8_t k = 0; k < rows; k++) {
+      if (mask & (1UL << k)) { drawPixel(x, top + k, (bits & (1UL << k)) ? WHITE : BLACK); }
+    }
+  } else if (mask == 0xFFFFFFFF) {
+    blitColumnBits(x, top, bits, rows, WHITE, BLACK);
+  } else {
+    blitColumnBits(x, top, bits & mask, rows, WHITE, WHITE);
+    blitColumnBits(x, top, ~bits & mask, rows, BLACK, BLACK);
+  }
+}
+
+// Only the visible part of the image is dithered. The rows are processed in strips
+// that end on page boundaries, so each page byte is written once.
+void SSD1306::ditherBitmap(int16_t x, int16_t y, const uint8_t * bitmap, const uint8_t * mask, int16_t w, int16_t h) {
+  int16_t i0 = (x < 0) ? -x : 0;
+  int16_t i1 = (x + w > width()) ? width() - x : w;
+  int16_t j0 = (y < 0) ? -y : 0;
+  int16_t j1 = (y + h > height()) ? height() - y : h;
+  if ((i0 >= i1) || (j0 >= j1)) { return; }
+  if (rotation == 0) { markArea(x + i0, y + j0, i1 - i0, j1 - j0); }
+
+  if (_dither != DitherDiffusion) {
+    const uint8_t * thresholds = (_dither == DitherBayer4) ? Bayer4Threshold : Bayer8Threshold;
+
+    for (int16_t j = j0; j < j1; ) {
+      uint8_t rows = 32 - ((y + j) & 7);
+      if (rows > j1 - j) { rows = j1 - j; }
+
+      for (int16_t i = i0; i < i1; i++) {
+        const uint8_t * threshold = &thresholds[(i & 7) * 8];
+        const uint8_t * src = &bitmap[j * w + i];
+        uint32_t bits = 0;
+        for (uint8_t k = 0; k < rows; k++, src += w) {
+          bits |= (uint32_t)(*src >= threshold[(j + k) & 7]) << k;
+        }
+        writeDithered(x + i, y + j, bits, maskColumn(mask, w, i, j, rows), rows);
+      }
+      j += rows;
+    }
+    return;
+  }
+
+  // Floyd-Steinberg, 'below' holds the error for the next row (with a margin
+  // column on the left), the strip collects up to 8 rows of output bits
+  int16_t below[SSD1306_LCDWIDTH + 1];
+  uint8_t strip[SSD1306_LCDWIDTH];
+  int16_t n = i1 - i0;
+  memset(below, 0, (n + 1) * sizeof(below[0]));
+
+  for (int16_t j = j0; j < j1; ) {
+    uint8_t rows = 8 - ((y + j) & 7);
+    if (rows > j1 - j) { rows = j1 - j; }
+    memset(strip, 0, n);
+
+    for (uint8_t k = 0; k < rows; k++) {
+      const uint8_t * src = &bitmap[(j + k) * w + i0];
+      int16_t right = 0;    // 7/16 of the error of the previous pixel
+      int16_t diagonal = 0; // 1/16 of the error of the previous pixel, for the next row
+      for (int16_t c = 0; c < n; c++) {
+        int16_t v = src[c] + below[c + 1] + right;
+        bool on = (v >= 128);
+        int16_t e = on ? v - 255 : v;
+        int16_t e7 = e * 7 / 16;
+        int16_t e3 = e * 3 / 16;
+        int16_t e5 = e * 5 / 16;
+        strip[c] |= (uint8_t)on << k;
+        below[c] += e3;
+        below[c + 1] = diagonal + e5;
+        diagonal = e - e7 - e3 - e5;
+        right = e7;
+      }
+      below[0] = 0; // Error left of the image is dropped
+    }
+
+    for (int16_t c = 0; c < n; c++) {
+      writeDithered(x + i0 + c, y + j, strip[c], maskColumn(mask, w, i0 + c, j, rows), rows);
+    }
+    j += rows;
+  }
+}
@@ -0,0 +1,73 @@
+/**
+ * @file GlyphAtlas.cpp
+ * @author Gustice
+ * @brief Glyph atlas implementation
+ * @version 0.1
+ * @date 2021-01-01
+ *
+ * @copyright Copyright (c) 2021
+ */
+
+#include "GlyphAtlas.h"
+#include "gfxglyphruns.h"
+#include <stdlib.h>
+#include <string.h>
+
+GlyphAtlas::GlyphAtlas(const GFXfont * font)
+{
+    _font = font;
+    uint16_t count = gfxFontGlyphCount(font);
+
+    uint32_t size = 0;
+    for (uint16_t c = 0; c < count; c++)
+    {
+        const GFXglyph * glyph = &font->glyph[c];
+        size += glyph->width * ((glyph->height + 7) / 8);
+    }
+
+    // The offsets are 16 bit, larger atlases exceed the heap of the ESP8266 anyway
+    if (size > 0xFFFF)
+        return;
+
+    _offsets = (uint16_t *)malloc(count * sizeof(uint16_t));
+    _data = (uint8_t *)malloc(size > 0 ? size : 1);
+    if ((_offsets == nullptr) || (_data == nullptr))
+    {
+        free(_offsets);
+        free(_data);
+        _offsets = nullptr;
+        _data = nullptr;
+        return;
+    }
+    memset(_data, 0, size);
+
+    uint16_t offset = 0;
+    for (uint16_t c = 0; c < count; c++)
+    {
+        const GFXglyph * glyph = &font->glyph[c];
+        uint8_t pages = (glyph->height + 7) / 8;
+        GFXglyphRuns runs(&font->bitmap[glyph->bitmapOffset], glyph->width, glyph->height,
+                          font->encoding);
+        uint8_t rows, x, len;
+
+        _offsets[c] = offset;
+        for (uint8_t yy = 0; (rows = runs.nextBand()) > 0; yy += rows)
+        {
+            while (runs.nextRun(x, len))
+            {
+                for (uint8_t r = yy; r < yy + rows; r++)
+                {
+                    for (uint8_t xx = x; xx < x + len; xx++)
+                        _data[offset + xx * pages + r / 8] |= 1 << (r & 7);
+                }
+            }
+        }
+        offset += glyph->width * pages;
+    }
+}
+
+GlyphAtlas::~GlyphAtlas()
+{
+    free(_offsets);
+    free(_data);
+}
@@ -4,7 +4,9 @@
  * @brief UI-Implementation for certain usecase.
  * @details The UI is designed to fit on a 128x68 OLED display. 
  *  The upper half is for status report the lower half is for log messages.
- * @bug This ui builds only once, the cursor can not be modified properly after that.
+ *  The elements are retained widgets, only the ones that changed are redrawn.
+ *  The status area rotates between screens. Their static parts are rendered once
+ *  into backgrounds, a switch copies in the background and draws the widgets only.
  * @version 0.1
  * @date 2021-01-01
  * 
@@ -13,7 +15,10 @@
 
 #include "MyDisplay.h"
 #include <math.h>
+#include <stdio.h>
+#include <string.h>
 #include "esp_log.h"
+#include "StatusIcons.h"
 
 #define MAX(x, y) (((x) > (y)) ? (x) : (y))
 #define MIN(x, y) (((x) < (y)) ? (x) : (y))
@@ -30,151 +35,266 @@ const size_t DisplayHeight = 64;
 
 const size_t LogRange = DisplayTitleHeight + 2* TextHeight;
 
-const int NumElements = 8;
-const int ElementWidth = 30;
-const int ElementHeight = 16;
+const size_t ValueWidth = 80; // "T = -10.5 °C" fits, the trend takes the rest
+const size_t CaptionWidth = 30; // Captions of the other screens, e.g. "RSSI"
 
 // Display layout - OLED-128x64
 // First 2xRow is for title and symbols.
-// Next 6xRows for Status messages.
+// Next 2xRows for Status messages, T and RH each with a trend graph on the right.
+// Last 4xRows for log lines, scrolled by the panel (vertical scroll area).
 // Each Row has a height of 8 pixels
+// The range and network screens show a caption and a value per row instead.
 
-MyDisplay::MyDisplay(SSD1306 * display){
+// Static content of the screens, drawn into their backgrounds
+struct ScreenLayout
+{
+    const char * title;
+    const char * captions[2];
+};
+
+static const ScreenLayout Layouts[MyDisplay::ScreenCount] = {
+    {"T/H-Sensor", {nullptr, nullptr}},
+    {"Min/Max", {"T", "RH"}},
+    {"Network", {"RSSI", "IP"}},
+};
+
+// Status symbols are icons of StatusIcons, see Devices/icons
+static int16_t selectBattery(int32_t full);
+static int16_t selectConnection(int32_t bars);
+static int16_t selectSupply(int32_t supply);
+
+MyDisplay::MyDisplay(SSD1306 * display) :
+    _battery(DisplayWidth-SymbolWidth, 0, SymbolWidth, SymbolHeight, &StatusIcons, selectBattery, 50),
+    _connection(DisplayWidth-2*SymbolWidth, 0, SymbolWidth, SymbolHeight, &StatusIcons, selectConnection, 3),
+    _supply(DisplayWidth-3*SymbolWidth, 0, SymbolWidth, SymbolHeight, &StatusIcons, selectSupply, true),
+    _log(0, LogRange, DisplayWidth),
+    _temperature(0, DisplayTitleHeight, ValueWidth, TextHeight, "T = ", " °C"),
+    _humidity(0, DisplayTitleHeight+TextHeight, ValueWidth, TextHeight, "RH= ", " %"),
+    _temperatureTrend(display, ValueWidth, DisplayTitleHeight, DisplayWidth-ValueWidth, TextHeight),
+    _humidityTrend(display, ValueWidth, DisplayTitleHeight+TextHeight, DisplayWidth-ValueWidth, TextHeight),
+    _temperatureRange(CaptionWidth, DisplayTitleHeight, DisplayWidth-CaptionWidth, TextHeight, " °C"),
+    _humidityRange(CaptionWidth, DisplayTitleHeight+TextHeight, DisplayWidth-CaptionWidth, TextHeight, " %"),
+    _signal(CaptionWidth, DisplayTitleHeight, DisplayWidth-CaptionWidth, TextHeight, "---"),
+    _address(CaptionWidth, DisplayTitleHeight+TextHeight, DisplayWidth-CaptionWidth, TextHeight, "---")
+{
     _display = display;
     _display->Init(SSD1306_SWITCHCAPVCC);
     _display->clearDisplay();
+    _display->utf8(); // Units like " °C" are UTF-8 in the source
 
-    memset(log,0,sizeof(log));
-    logLine = 0;
-}
+    _display->setScrollArea(LogRange, DisplayHeight-LogRange);
+    _display->setStartLine(0);
+
+    _temperature.SetText("T = ---.- °C");
+    _humidity.SetText("RH= ---.- %");
+    _temperatureRange.SetText("---");
+    _humidityRange.SetText("---");
 
+    _shared.Add(&_battery);
+    _shared.Add(&_connection);
+    _shared.Add(&_supply);
+    _shared.Add(&_log);
 
+    _screens[ScreenValues].Add(&_temperature);
+    _screens[ScreenValues].Add(&_humidity);
+    _screens[ScreenValues].Add(&_temperatureTrend);
+    _screens[ScreenValues].Add(&_humidityTrend);
+    _screens[ScreenRange].Add(&_temperatureRange);
+    _screens[ScreenRange].Add(&_humidityRange);
+    _screens[ScreenNetwork].Add(&_signal);
+    _screens[ScreenNetwork].Add(&_address);
+
+    for (int s = 0; s < ScreenCount; s++)
+        renderBackground((Screen)s);
+    _display->clearDisplay();
+}
+
+/**
+ * @brief Builds the complete screen
+ * @details The scroll position of the panel is kept, so each log line goes back
+ *  to its slot.
+ */
 void MyDisplay::PrintInitFrame(bool wifiOk, bool supply, float battery)
 {
+    SetStatus(wifiOk, supply, battery);
     NewImage();
-    _display->setCursor(0,0);
-    _display->setTextSize(2);
+    _shared.Invalidate();
+    ShowScreen(_current);
+}
+
+/**
+ * @brief Switches the status area to the given screen
+ * @details The status area is restored from the background of the screen, that
+ *  is one copy of its pages. Then only the widgets of the screen and the status
+ *  symbols on top of the title are drawn, the log area is not touched.
+ */
+void MyDisplay::ShowScreen(Screen screen)
+{
+    _current = screen;
+    _backgrounds[screen].Restore(_display);
+    _screens[screen].Invalidate();
+    _battery.Invalidate();
+    _connection.Invalidate();
+    _supply.Invalidate();
+    Update();
+}
+
+void MyDisplay::NextScreen(void)
+{
+    ShowScreen((Screen)((_current + 1) % ScreenCount));
+}
+
+// Draws the static content of the screen into the status area and keeps it
+void MyDisplay::renderBackground(Screen screen)
+{
+    const ScreenLayout & layout = Layouts[screen];
+
+    _display->fillRect(0, 0, DisplayWidth, LogRange, BLACK);
     _display->setTextColor(WHITE);
-    _display->print("T/H-Sensor");
-    // Clear space for symbols
-    _display->fillRect(DisplayWidth-3*SymbolWidth, 0, 3*SymbolWidth,SymbolHeight, BLACK);
-
-    point_t p1 = {DisplayWidth-SymbolWidth ,0};
-    printBattery(p1, 50);
-    
-    point_t p2 = {DisplayWidth-2*SymbolWidth ,0};
-    if(wifiOk)
-        printConnectSymbol(p2);
-    else
-        printWarningSymbol(p2);
-    
-    point_t p3 = {DisplayWidth-3*SymbolWidth ,0};
-    if(supply)
-        printPowerSymbol(p3);
+    bool wrap = _display->getTextWrap();
+    _display->setTextWrap(false);
+    _display->setTextSize(2);
+    _display->setCursor(0, 0);
+    _display->print(layout.title);
 
     _display->setTextSize(1);
-    _display->setCursor(0,DisplayTitleHeight);
-    _display->print("T = 000.0 °C ");
-    _display->setCursor(0,DisplayTitleHeight+TextHeight);
-    _display->print("RH= 000.0 %");
-
-    _display->setCursor(0,LogRange);
-    _display->print("Line 1");
-    _display->setCursor(0,LogRange+TextHeight);
-    _display->print("Line 2");
-    _display->setCursor(0,LogRange+TextHeight*2);
-    _display->print("Line 2");
-    _display->setCursor(0,LogRange+TextHeight*3);
-    _display->print("Line 3");
-    Display();
-}
-
-void MyDisplay::PrintLogLine(char * line)
-{
-    // int len = MIN(24u, strlen(line));
-    // _display->setTextColor(WHITE);
-
-    // // if (logLine >= LogLines-1)
-    // // {
-    // //     _display->fillRect(0, LogRange, DisplayWidth,DisplayHeight-LogRange, BLACK);
-    // //     logLine = LogLines-1;
-    // //     for (size_t i = 0; i < LogLines-2; i++)
-    // //     {
-    // //         memcpy(log[logLine], line, len);
-    // //         log[logLine][len] = 0; // Terminate string
-    // //         _display->setCursor(0,LogRange + i*TextHeight);
-    // //         _display->print(log[logLine]);
-    // //         logLine++;
-    // //     }
-
-    // //     memcpy(log[logLine], line, len);
-    // //     _display->print(log[logLine]);
-    // // }
-    // // else
-    // // {
-    //     memcpy(log[logLine], line, len);
-    //     _display->setCursor(0,LogRange + logLine*TextHeight);
-    //     _display->print(log[logLine]);
-    //     ESP_LOGI(TAG, "len=%d, line=%d, cursor=%d", len, logLine, _display->getCursorY() );
-    //     logLine++;
-    // // }
-
-    // Display();
-}
-
-
-
-void MyDisplay::printBattery(point_t anchor, uint32_t full)
-{
-    const uint16_t p = 1;     // padding
-    const uint16_t sw = SymbolWidth-2*p; // Symbol Width
-    const uint16_t sh = SymbolHeight-2*p; // Symbol Height
-    const uint16_t fw = sw-2; // fill Width
-        
-    _display->drawRect(anchor.x+4, anchor.y+p, 4, 2, WHITE); // draw Hat
-    _display->drawRect(anchor.x+p, anchor.y+3, sw, 12, WHITE); // draw Frame
-    
-    if (full < 10)
-        return;
-    _display->drawRect(anchor.x+p+1, anchor.y+12, fw, 2, WHITE); //  20%
+    for (int i = 0; i < 2; i++)
+    {
+        if (!layout.captions[i])
+            continue;
+        _display->setCursor(0, DisplayTitleHeight + i*TextHeight);
+        _display->print(layout.captions[i]);
+    }
+    _display->setTextWrap(wrap);
 
-    if (full < 30)
-        return;
-    _display->drawRect(anchor.x+p+1, anchor.y+10, fw, 2, WHITE); //  40%
-    
-    if (full < 50)
-        return;
-    _display->drawRect(anchor.x+p+1, anchor.y+8, fw, 2, WHITE); //  60%
-    
-    if (full < 70)
-        return;
-    _display->drawRect(anchor.x+p+1, anchor.y+6, fw, 2, WHITE); //  80%
+    if (!_backgrounds[screen].Capture(_display, 0, LogRange / 8))
+        ESP_LOGE(TAG, "No memory for the background of screen %d", screen);
+}
 
-    if (full < 90)
+void MyDisplay::SetStatus(bool wifiOk, bool supply, float battery)
+{
+    _battery.SetState((int32_t)(battery * 100));
+    if (!wifiOk)
+        _connection.SetState(0);
+    else if (_connection.State() == 0)
+        _connection.SetState(3); // Full bars until the signal is known
+    _supply.SetState(supply);
+    if (!wifiOk)
+    {
+        _signal.SetText("---");
+        _address.SetText("---");
+    }
+}
+
+void MyDisplay::SetSignal(int8_t rssi)
+{
+    if (_connection.State() == 0)
+        return; // Not connected
+
+    _connection.SetState((rssi >= -67) ? 3 : (rssi >= -75) ? 2 : 1);
+
+    char text[UiLabel::LabelChars];
+    snprintf(text, sizeof(text), "%d dBm", rssi);
+    _signal.SetText(text);
+}
+
+void MyDisplay::SetValues(float temperature, float humidity)
+{
+    uint32_t hour = xTaskGetTickCount() / (3600000 / portTICK_PERIOD_MS);
+    float min, max;
+
+    _temperature.SetValue(temperature);
+    _humidity.SetValue(humidity);
+    _temperatureTrend.AddSample(temperature);
+    _humidityTrend.AddSample(humidity);
+
+    _temperatureDay.Add(temperature, hour);
+    _humidityDay.Add(humidity, hour);
+    if (_temperatureDay.Get(hour, &min, &max))
+        _temperatureRange.SetRange(min, max);
+    if (_humidityDay.Get(hour, &min, &max))
+        _humidityRange.SetRange(min, max);
+}
+
+void MyDisplay::SetAddress(const char * address)
+{
+    _address.SetText(address);
+}
+
+// Widgets of hidden screens keep their state until they are shown again
+void MyDisplay::Update(void)
+{
+    bool drawn = _screens[_current].Render(_display);
+    drawn |= _shared.Render(_display);
+    if (drawn)
+        Display(); // Only the regions of redrawn widgets are dirty
+}
+
+/**
+ * @brief Appends a line at the bottom of the log area
+ * @details The line is drawn into its own page only. Once the area is full the
+ *  page of the oldest line is reused and the panel start line moves on by one
+ *  text row, so the other lines are shifted up without being transmitted again.
+ *  An append costs one page (128 bytes) plus the start line command.
+ */
+void MyDisplay::PrintLogLine(const char * line)
+{
+    bool scroll = _log.Append(line);
+    Update();
+
+    if (scroll)
+        _display->setStartLine(_log.Head()*UiLog::LineHeight);
+}
+
+void DailyRange::Add(float value, uint32_t hour)
+{
+    size_t slot = hour % Hours;
+
+    if (_hour[slot] != hour + 1)
+    {
+        // The slot still holds an older hour
+        _hour[slot] = hour + 1;
+        _min[slot] = value;
+        _max[slot] = value;
         return;
-    _display->drawRect(anchor.x+p+1, anchor.y+4, fw, 2, WHITE); // 100%
+    }
+    _min[slot] = MIN(_min[slot], value);
+    _max[slot] = MAX(_max[slot], value);
 }
 
-void MyDisplay::printConnectSymbol(point_t anchor){
+bool DailyRange::Get(uint32_t hour, float * min, float * max) const
+{
+    bool found = false;
 
-    _display->drawRect(anchor.x+2, anchor.y+9, 2, 4, WHITE);
-    _display->drawRect(anchor.x+4, anchor.y+6, 2, 7, WHITE);
-    _display->drawRect(anchor.x+6, anchor.y+3, 2, 10, WHITE);
+    for (size_t slot = 0; slot < Hours; slot++)
+    {
+        if ((_hour[slot] == 0) || (hour + 1 - _hour[slot] >= Hours))
+            continue;
+        *min = found ? MIN(*min, _min[slot]) : _min[slot];
+        *max = found ? MAX(*max, _max[slot]) : _max[slot];
+        found = true;
+    }
+    return found;
 }
 
-void MyDisplay::printPowerSymbol(point_t anchor){
- _display->drawRect(anchor.x+2, anchor.y+5, 7, 4, WHITE);
- _display->drawRect(anchor.x+3, anchor.y+6, 5, 4, WHITE);
- _display->drawRect(anchor.x+4, anchor.y+7, 3, 4, WHITE);
- _display->drawLine(anchor.x+3, anchor.y+2, anchor.x+3, anchor.y+5, WHITE); 
- _display->drawLine(anchor.x+7, anchor.y+2, anchor.x+7, anchor.y+5, WHITE); 
- _display->drawLine(anchor.x+5, anchor.y+10, anchor.x+5, anchor.y+13, WHITE); 
+static int16_t selectBattery(int32_t full)
+{
+    // Empty frame below 10 %, then one bar per 20 %
+    if (full < 10)
+        return StatusIcons_battery_0;
+    if (full >= 90)
+        return StatusIcons_battery_5;
+    return StatusIcons_battery_1 + (full - 10) / 20;
 }
 
-void MyDisplay::printWarningSymbol(point_t anchor){
-     _display->drawRect(anchor.x+4, anchor.y+2, 4, 5, WHITE);
-    _display->drawRect(anchor.x+5, anchor.y+1, 2, 9, WHITE);
-    _display->drawRect(anchor.x+4, anchor.y+12, 4, 2, WHITE);
-    _display->drawRect(anchor.x+5, anchor.y+11, 2, 4, WHITE);
+static int16_t selectConnection(int32_t bars)
+{
+    if (bars <= 0)
+        return StatusIcons_warning;
+    return StatusIcons_wifi_1 + MIN(bars, 3) - 1;
 }
 
+static int16_t selectSupply(int32_t supply)
+{
+    return supply ? StatusIcons_supply : -1;
+}
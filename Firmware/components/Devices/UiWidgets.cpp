@@ -0,0 +1,445 @@
+/**
+ * @file UiWidgets.cpp
+ * @author Gustice
+ * @brief Retained UI elements for the status screen
+ * @version 0.1
+ * @date 2021-01-01
+ *
+ * @copyright Copyright (c) 2021
+ */
+
+#include "UiWidgets.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Formatted as integers, printf of the SDK may lack float support
+static void formatNumber(char * text, size_t size, float value, uint8_t decimals)
+{
+    static const int32_t Scale[] = {1, 10, 100, 1000};
+    int32_t v = (int32_t)(value * Scale[decimals] + ((value < 0) ? -0.5f : 0.5f));
+    uint32_t a = abs(v);
+    char frac[5] = ".";
+
+    for (uint8_t i = decimals; i > 0; i--)
+    {
+        frac[i] = '0' + a % 10;
+        a /= 10;
+    }
+    frac[decimals ? decimals + 1 : 0] = 0;
+
+    snprintf(text, size, "%s%u%s", (v < 0) ? "-" : "", (unsigned)a, frac);
+}
+
+
+UiWidget::UiWidget(int16_t x, int16_t y, int16_t w, int16_t h)
+    : _x(x), _y(y), _w(w), _h(h)
+{
+}
+
+void UiWidget::Render(Adafruit_GFX * gfx)
+{
+    gfx->fillRect(_x, _y, _w, _h, BLACK);
+    draw(gfx);
+    _dirty = false;
+}
+
+
+UiLabel::UiLabel(int16_t x, int16_t y, int16_t w, int16_t h, const char * text, uint8_t size)
+    : UiWidget(x, y, w, h), _size(size)
+{
+    strncpy(_text, text, LabelChars-1);
+    _text[LabelChars-1] = 0;
+}
+
+void UiLabel::SetText(const char * text)
+{
+    if (strncmp(_text, text, LabelChars-1) == 0)
+        return;
+
+    strncpy(_text, text, LabelChars-1);
+    _text[LabelChars-1] = 0;
+    Invalidate();
+}
+
+void UiLabel::draw(Adafruit_GFX * gfx)
+{
+    gfx->setTextSize(_size);
+    gfx->setTextColor(WHITE);
+    bool wrap = gfx->getTextWrap();
+    gfx->setTextWrap(false); // Text must stay in its box
+    gfx->setCursor(_x, _y);
+    gfx->print(_text);
+    gfx->setTextWrap(wrap);
+}
+
+
+UiNumber::UiNumber(int16_t x, int16_t y, int16_t w, int16_t h,
+                   const char * prefix, const char * unit, uint8_t decimals, uint8_t size)
+    : UiLabel(x, y, w, h, "", size), _prefix(prefix), _unit(unit), _decimals((decimals > 3) ? 3 : decimals)
+{
+}
+
+void UiNumber::SetValue(float value)
+{
+    char number[LabelChars];
+    char text[2*LabelChars]; // Cut by SetText()
+
+    formatNumber(number, sizeof(number), value, _decimals);
+    snprintf(text, sizeof(text), "%s%s%s", _prefix, number, _unit);
+    SetText(text);
+}
+
+
+UiRange::UiRange(int16_t x, int16_t y, int16_t w, int16_t h, const char * unit, uint8_t decimals, uint8_t size)
+    : UiLabel(x, y, w, h, "", size), _unit(unit), _decimals((decimals > 3) ? 3 : decimals)
+{
+}
+
+void UiRange::SetRange(float min, float max)
+{
+    char low[LabelChars];
+    char high[LabelChars];
+    char text[3*LabelChars]; // Cut by SetText()
+
+    formatNumber(low, sizeof(low), min, _decimals);
+    formatNumber(high, sizeof(high), max, _decimals);
+    snprintf(text, sizeof(text), "%s .. %s%s", low, high, _unit);
+    SetText(text);
+}
+
+
+UiIcon::UiIcon(int16_t x, int16_t y, int16_t w, int16_t h, const GFXiconSet * icons, Selector select,
+               int32_t state)
+    : UiWidget(x, y, w, h), _icons(icons), _select(select), _state(state)
+{
+}
+
+void UiIcon::SetState(int32_t state)
+{
+    if (state == _state)
+        return;
+
+    _state = state;
+    Invalidate();
+}
+
+void UiIcon::Render(Adafruit_GFX * gfx)
+{
+    int16_t index = _select(_state);
+
+    if ((index >= 0) && (_icons->icon[index].width >= _w) && (_icons->icon[index].height >= _h))
+        draw(gfx); // Opaque icon covers the box, no need to clear it
+    else
+        UiWidget::Render(gfx);
+    _dirty = false;
+}
+
+void UiIcon::draw(Adafruit_GFX * gfx)
+{
+    int16_t index = _select(_state);
+
+    if (index >= 0)
+        gfx->drawIcon(_x, _y, _icons, index, WHITE, BLACK);
+}
+
+
+UiLog::UiLog(int16_t x, int16_t y, int16_t w)
+    : UiWidget(x, y, w, Lines*LineHeight)
+{
+    memset(_lines, 0, sizeof(_lines));
+    Invalidate();
+}
+
+bool UiLog::Append(const char * line)
+{
+    size_t slot;
+    bool scroll = (_count >= Lines);
+
+    if (scroll)
+    {
+        slot = _head;
+        _head = (_head + 1) % Lines;
+    }
+    else
+    {
+        slot = (_head + _count) % Lines;
+        _count++;
+    }
+
+    strncpy(_lines[slot], line, LineChars-1);
+    _lines[slot][LineChars-1] = 0;
+    _dirtySlots |= (1 << slot);
+    _dirty = true;
+    return scroll;
+}
+
+void UiLog::Invalidate(void)
+{
+    _dirtySlots = (1 << Lines) - 1;
+    _dirty = true;
+}
+
+void UiLog::Render(Adafruit_GFX * gfx)
+{
+    draw(gfx);
+    _dirtySlots = 0;
+    _dirty = false;
+}
+
+void UiLog::draw(Adafruit_GFX * gfx)
+{
+    for (size_t slot = 0; slot < Lines; slot++)
+    {
+        if (_dirtySlots & (1 << slot))
+            drawSlot(gfx, slot);
+    }
+}
+
+void UiLog::drawSlot(Adafruit_GFX * gfx, size_t slot)
+{
+    int16_t y = _y + slot*LineHeight;
+
+    gfx->fillRect(_x, y, _w, LineHeight, BLACK);
+    gfx->setTextSize(1);
+    gfx->setTextColor(WHITE);
+    bool wrap = gfx->getTextWrap();
+    gfx->setTextWrap(false); // Overlong lines must not spill into the next slot
+    gfx->setCursor(_x, y);
+    gfx->print(_lines[slot]);
+    gfx->setTextWrap(wrap);
+}
+
+
+UiTrend::UiTrend(SSD1306 * display, int16_t x, int16_t y, int16_t w, int16_t h)
+    : UiWidget(x, y, (w > (int16_t)MaxSamples) ? MaxSamples : w, h), _display(display)
+{
+}
+
+void UiTrend::AddSample(float value)
+{
+    // Once the ring is full the oldest sample is overwritten, if it was an extreme
+    // the range may shrink
+    bool dropped = (_count == slots()) &&
+                   ((_samples[_next] <= _min) || (_samples[_next] >= _max));
+
+    if (_count == 0)
+    {
+        _min = value;
+        _max = value;
+        _full = true;
+    }
+    else if ((value < _min) || (value > _max))
+    {
+        _min = (value < _min) ? value : _min;
+        _max = (value > _max) ? value : _max;
+        _full = true;
+    }
+
+    _samples[_next] = value;
+    _next = (_next + 1) % slots();
+    if (_count < slots())
+        _count++;
+    _added++;
+    _dirty = true;
+
+    if (dropped)
+        updateRange();
+}
+
+// Range of the samples in the ring, the graph is redrawn if it changed
+void UiTrend::updateRange(void)
+{
+    float min = _samples[0];
+    float max = _samples[0];
+
+    for (size_t k = 1; k < _count; k++)
+    {
+        min = (_samples[k] < min) ? _samples[k] : min;
+        max = (_samples[k] > max) ? _samples[k] : max;
+    }
+    if ((min != _min) || (max != _max))
+    {
+        _min = min;
+        _max = max;
+        _full = true;
+    }
+}
+
+void UiTrend::Invalidate(void)
+{
+    _full = true;
+    _dirty = true;
+}
+
+void UiTrend::Render(Adafruit_GFX * gfx)
+{
+    if (_full || (_added >= (size_t)_w))
+    {
+        UiWidget::Render(gfx);
+    }
+    else
+    {
+        _display->shiftLeft(_x, _y, _w, _h, _added);
+        for (int16_t c = _w - _added; c < _w; c++)
+            drawColumn(gfx, c);
+    }
+    _added = 0;
+    _full = false;
+    _dirty = false;
+}
+
+void UiTrend::draw(Adafruit_GFX * gfx)
+{
+    for (int16_t c = 0; c < _w; c++)
+        drawColumn(gfx, c);
+}
+
+int16_t UiTrend::toRow(float value) const
+{
+    if (_max <= _min)
+        return _y + _h / 2;
+    return _y + _h - 1 - (int16_t)((value - _min) * (_h - 1) / (_max - _min) + 0.5f);
+}
+
+// The samples are right aligned, each column connects its sample with the previous one
+void UiTrend::drawColumn(Adafruit_GFX * gfx, int16_t column)
+{
+    int16_t k = column + _count - _w; // Sample index, oldest first
+    if (k < 0)
+        return;
+
+    int16_t row = toRow(sample(k));
+    int16_t prev = (k > 0) ? toRow(sample(k - 1)) : row;
+    int16_t top = (row < prev) ? row : prev;
+    int16_t bottom = (row < prev) ? prev : row;
+    gfx->drawFastVLine(_x + column, top, bottom - top + 1, WHITE);
+}
+
+
+UiBackground::~UiBackground()
+{
+    free(_data);
+}
+
+bool UiBackground::Capture(const SSD1306 * display, uint8_t page0, uint8_t pages)
+{
+    int16_t width = display->width();
+    uint8_t available = display->height() / 8;
+    if (page0 >= available)
+        pages = 0;
+    else if (pages > available - page0)
+        pages = available - page0;
+
+    const uint8_t * frame = display->getBuffer() + page0 * width;
+    size_t length = pages * width;
+
+    free(_data);
+    _data = nullptr;
+    _size = 0;
+    _width = width;
+    _page0 = page0;
+    _pages = 0;
+
+    // First pass counts the encoded bytes, the second one stores them
+    size_t size = encode(frame, length, nullptr);
+    if (size > 0)
+    {
+        _data = (uint8_t *)malloc(size);
+        if (!_data)
+            return false;
+        encode(frame, length, _data);
+    }
+    _size = size;
+    _pages = pages;
+    return true;
+}
+
+// Same format as the splash of SSD1306: a run of zero bytes is stored as 0x00 followed
+// by the run length (1..255), any other byte as it is. Returns the encoded size, dst
+// may be null to get the size only.
+size_t UiBackground::encode(const uint8_t * src, size_t length, uint8_t * dst)
+{
+    size_t size = 0;
+
+    for (size_t i = 0; i < length;)
+    {
+        if (src[i] != 0)
+        {
+            if (dst)
+                dst[size] = src[i];
+            size++;
+            i++;
+            continue;
+        }
+
+        uint8_t run = 0;
+        while ((i < length) && (src[i] == 0) && (run < 255))
+        {
+            run++;
+            i++;
+        }
+        if (dst)
+        {
+            dst[size] = 0x00;
+            dst[size + 1] = run;
+        }
+        size += 2;
+    }
+    return size;
+}
+
+// Decodes one page at a time, runs may continue on the next page
+void UiBackground::Restore(SSD1306 * display) const
+{
+    uint8_t page[SSD1306_LCDWIDTH];
+    size_t i = 0;
+    uint8_t value = 0;
+    uint8_t run = 0;
+
+    for (uint8_t p = 0; p < _pages; p++)
+    {
+        for (int16_t x = 0; x < _width; x++)
+        {
+            if (run == 0)
+            {
+                value = _data[i++];
+                run = (value == 0x00) ? _data[i++] : 1;
+            }
+            page[x] = value;
+            run--;
+        }
+        display->writePages(_page0 + p, 1, page);
+    }
+}
+
+
+void UiScreen::Add(UiWidget * widget)
+{
+    widget->_next = nullptr;
+    if (_last)
+        _last->_next = widget;
+    else
+        _first = widget;
+    _last = widget;
+}
+
+void UiScreen::Invalidate(void)
+{
+    for (UiWidget * w = _first; w; w = w->_next)
+        w->Invalidate();
+}
+
+bool UiScreen::Render(Adafruit_GFX * gfx)
+{
+    bool drawn = false;
+
+    for (UiWidget * w = _first; w; w = w->_next)
+    {
+        if (!w->IsDirty())
+            continue;
+        w->Render(gfx);
+        drawn = true;
+    }
+    return drawn;
+}
@@ -12,9 +12,15 @@
 #pragma once 
 
 #include <stdint.h>
+#include <string.h>
 #include "Adafruit_GFX.h"
 #include "SpiPort.h"
+#include "I2cPort.h"
 #include "GpioPort.h"
+#include "GlyphAtlas.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
 
   // draw a single pixel
   // _display->drawPixel(10, 10, WHITE); 
@@ -53,8 +59,10 @@
 #define WHITE 1
 #define INVERSE 2
 
+// Largest panel the controller supports, smaller ones use a part of its RAM
 #define SSD1306_LCDWIDTH                  128
 #define SSD1306_LCDHEIGHT                 64
+#define SSD1306_LCDPAGES                  (SSD1306_LCDHEIGHT / 8)
 
 #define SSD1306_SETCONTRAST 0x81
 #define SSD1306_DISPLAYALLON_RESUME 0xA4
@@ -90,6 +98,8 @@
 
 #define SSD1306_CHARGEPUMP 0x8D
 
+#define SSD1306_I2C_ADDRESS 0x3C // 0x3D with SA0 high
+
 #define SSD1306_EXTERNALVCC 0x1
 #define SSD1306_SWITCHCAPVCC 0x2
 
@@ -102,17 +112,35 @@
 #define SSD1306_VERTICAL_AND_RIGHT_HORIZONTAL_SCROLL 0x29
 #define SSD1306_VERTICAL_AND_LEFT_HORIZONTAL_SCROLL 0x2A
 
+/**
+ * @brief Driver for SSD1306 panels of any supported size
+ * @details The frame buffer is provided by the derived class, use SSD1306Panel
+ *  to get an instance with a buffer of the right size.
+ *  The panel is connected by SPI (with DC line) or I2C. On I2C every command batch
+ *  and every data window is one transaction, so the bus can be shared with other
+ *  devices on the same I2cPort (e.g. Shtc3_Sensor) at any point in between.
+ */
 class SSD1306 : public Adafruit_GFX {
  public:
-  SSD1306(SpiPort * spiI, OutputPort * dc, OutputPort * rst);
-  
   void Init(uint8_t switchvcc = SSD1306_SWITCHCAPVCC, bool reset=true);
   void ssd1306_command(uint8_t c);
 
+  // Command batch: cmd() collects bytes, commit() sends them as one transaction
+  void beginCommands(void);
+  void cmd(uint8_t c);
+  void commit(void);
+
   void clearDisplay(void);
+  void drawSplash(void);
   void invertDisplay(uint8_t i);
   void display();
 
+  // Double buffered mode: Drawing goes to the back buffer, present() hands the
+  // modified regions to a low priority task that streams them to the panel.
+  bool StartFlushTask(UBaseType_t priority = tskIDLE_PRIORITY + 1);
+  void present(void);
+  bool isFlushing(void) const { return _flushing; }
+
   void startscrollright(uint8_t start, uint8_t stop);
   void startscrollleft(uint8_t start, uint8_t stop);
 
@@ -120,29 +148,241 @@ class SSD1306 : public Adafruit_GFX {
   void startscrolldiagleft(uint8_t start, uint8_t stop);
   void stopscroll(void);
 
+  // Hardware vertical scrolling without continuous scroll: the content of the
+  // rows below the fixed area is rotated by the start line, the fixed rows stay
+  // in place. Moving the start line does not touch the RAM.
+  void setScrollArea(uint8_t fixedRows, uint8_t scrollRows);
+  void setStartLine(uint8_t line);
+
+  // Moves the content of the area n columns to the left and clears the n columns
+  // at its right end. Works on panel coordinates, i.e. the rotation is not applied.
+  void shiftLeft(int16_t x, int16_t y, int16_t w, int16_t h, int16_t n);
+
+  // Frame in panel layout, e.g. to capture the screen content
+  const uint8_t * getBuffer(void) const { return _buffer; }
+  // Copies whole pages in panel layout into the frame, e.g. content captured from
+  // getBuffer() before. The pages are cleared for src == nullptr.
+  void writePages(uint8_t page0, uint8_t pages, const uint8_t * src);
+
+  // Transfer statistics since the last reset, e.g. to compare the cost of UI updates
+  struct TxStats {
+    uint32_t transactions;
+    uint32_t commandBytes;
+    uint32_t dataBytes;
+  };
+  const TxStats & txStats(void) const { return _txStats; }
+  void resetTxStats(void) { memset(&_txStats, 0, sizeof(_txStats)); }
+
   void dim(bool dim);
   void drawPixel(int16_t x, int16_t y, uint16_t color);
 
   virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
   virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  virtual void fillScreen(uint16_t color);
+  virtual void fillSpans(const GFXspan * spans, uint16_t count, bool vertical, uint16_t color);
+
+  virtual void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color);
+  virtual void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color, uint16_t bg);
+  virtual void drawBitmap(int16_t x, int16_t y, uint8_t *bitmap, int16_t w, int16_t h, uint16_t color);
+  virtual void drawBitmap(int16_t x, int16_t y, uint8_t *bitmap, int16_t w, int16_t h, uint16_t color, uint16_t bg);
+
+  // Text is blitted column wise for the classic font and for GFX fonts that have
+  // an atlas attached, sizes up to MaxScaledTextSize (a scaled glyph column has
+  // to fit into 32 bits). Everything else takes the generic path.
+  static const uint8_t MaxScaledTextSize = 4;
+  // An invalid atlas (see GlyphAtlas::IsValid()) is not used
+  void setGlyphAtlas(GlyphAtlas * atlas) {
+    _atlas = ((atlas != nullptr) && atlas->IsValid()) ? atlas : nullptr;
+  }
+  virtual void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size);
+  virtual void drawGlyph(int16_t x, int16_t y, uint16_t index, uint16_t color, uint8_t size);
+
+  // Icons are stored in page order. An opaque icon that starts on a page boundary
+  // is copied byte by byte, otherwise the columns are shifted into place.
+  virtual void drawIcon(int16_t x, int16_t y, const GFXiconSet * set, uint8_t index, uint16_t color, uint16_t bg);
+
+  // Gray values (0 = black, 255 = white) are dithered to the two levels of the panel
+  // and written as page bytes, 32 rows per column at a time. The ordered patterns
+  // are anchored to the image, so an icon looks the same at every position.
+  // Error diffusion (Floyd-Steinberg) looks smoother but costs about twice as much.
+  enum GrayDither { DitherBayer4, DitherBayer8, DitherDiffusion };
+  void setGrayDither(GrayDither dither) { _dither = dither; }
+  virtual void drawGrayscaleBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h);
+  virtual void drawGrayscaleBitmap(int16_t x, int16_t y, uint8_t *bitmap, int16_t w, int16_t h);
+  virtual void drawGrayscaleBitmap(int16_t x, int16_t y, const uint8_t bitmap[], const uint8_t mask[],
+                                   int16_t w, int16_t h);
+  virtual void drawGrayscaleBitmap(int16_t x, int16_t y, uint8_t *bitmap, uint8_t *mask, int16_t w, int16_t h);
+
+ protected:
+  SSD1306(SpiPort * spiI, OutputPort * dc, OutputPort * rst,
+          int16_t w, int16_t h, uint8_t * buffer);
+  SSD1306(I2cPort * i2c, uint8_t address, OutputPort * rst,
+          int16_t w, int16_t h, uint8_t * buffer);
+
+  uint8_t * _buffer; // Frame in panel layout: pages of 8 rows, one byte per column
+  uint8_t _pages;    // Number of pages, HEIGHT / 8
+
+  // Works on panel coordinates, i.e. the rotation is already applied
+  inline void markDirty(int16_t x0, int16_t x1, uint8_t page0, uint8_t page1) {
+    for (uint8_t p = page0; p <= page1; p++) {
+      if (x0 < _dirtyFirst[p]) _dirtyFirst[p] = x0;
+      if (x1 > _dirtyLast[p])  _dirtyLast[p]  = x1;
+    }
+  }
+  void fillRectInternal(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
 
  private:
   SpiPort * _spiI;
   OutputPort * _dc;
   OutputPort * _rst;
+  I2cPort * _i2c = nullptr;
+  uint8_t _i2cAddr = SSD1306_I2C_ADDRESS;
+  void transmit(bool data, const uint8_t * src, size_t len);
+  TxStats _txStats = {};
   int8_t _vccState;
+  uint8_t _contrast = 0xCF; // Set by Init() for the panel, restored by dim(false)
+
+  uint8_t _cmdBuf[32]; // Fits the complete init sequence
+  uint8_t _cmdLen = 0;
+
+  // Column range per page that was modified since the last display() call.
+  // A clean page is marked by first > last.
+  uint8_t _dirtyFirst[SSD1306_LCDPAGES];
+  uint8_t _dirtyLast[SSD1306_LCDPAGES];
+  inline uint16_t bufferSize(void) const { return WIDTH * _pages; }
+  inline void markAllDirty(void);
+  inline void markAllClean(void);
+  void transmitDirty(const uint8_t * src, uint8_t * first, uint8_t * last);
+  void sendWindow(const uint8_t * src, uint8_t col0, uint8_t col1, uint8_t page0, uint8_t page1);
+
+  // Front buffer and the regions of it that are pending for the flush task
+  uint8_t * _front = nullptr;
+  uint8_t _flushFirst[SSD1306_LCDPAGES];
+  uint8_t _flushLast[SSD1306_LCDPAGES];
+  volatile bool _flushing = false;
+  SemaphoreHandle_t _flushRequest = nullptr;
+  SemaphoreHandle_t _flushDone = nullptr;
+  void waitForFlush(void);
+  void releaseFlushTask(void);
+  static void flushTask(void * pvParameters);
+
   inline void drawFastVLineInternal(int16_t x, int16_t y, int16_t h, uint16_t color);
   inline void drawFastHLineInternal(int16_t x, int16_t y, int16_t w, uint16_t color);
+  void fillPageRows(uint8_t page, uint8_t rows, const uint8_t * first, const uint8_t * end,
+                    uint16_t color);
+  void blitBitmap(int16_t x, int16_t y, const uint8_t * bitmap, int16_t w, int16_t h,
+                  uint16_t color, uint16_t bg, bool opaque);
+  inline void blitColumn(int16_t x, int16_t page, uint8_t shift, uint8_t bits, uint16_t color);
+  void blitColumnBits(int16_t x, int16_t top, uint32_t bits, uint8_t rows, uint16_t color, uint16_t bg,
+                      uint8_t columns = 1);
+  bool markArea(int16_t x, int16_t y, int16_t w, int16_t h);
+  void ditherBitmap(int16_t x, int16_t y, const uint8_t * bitmap, const uint8_t * mask, int16_t w, int16_t h);
+  void writeDithered(int16_t x, int16_t top, uint32_t bits, uint32_t mask, uint8_t rows);
+
+  GlyphAtlas * _atlas = nullptr;
+  GrayDither _dither = DitherBayer8;
+
+  friend class SSD1306Core;
 };
 
+/**
+ * @brief Rendering core (see gfxcore.h) that draws into the frame of a SSD1306
+ * @details Circles, triangles, lines and glyphs of custom fonts are drawn with an inlined
+ *  drawPixel() instead of one virtual call per pixel. Lines, rectangles, spans and the
+ *  blitted text of the driver are used as they are. Rotation, font and charset are read
+ *  from the display on every call, setting them on the core sets them on the display.
+ *  The dirty regions are tracked like for drawing on the display itself.
+ */
+class SSD1306Core : public GFXcore<SSD1306Core> {
+ public:
+  SSD1306Core(SSD1306 * display)
+    : GFXcore<SSD1306Core>(display->WIDTH, display->HEIGHT), _display(display) { }
+
+  // State of the display, the copies in GFXcore are not used
+  void setRotation(uint8_t r) { _display->setRotation(r); }
+  uint8_t getRotation(void) const { return _display->rotation; }
+  int16_t width(void) const { return _display->_width; }
+  int16_t height(void) const { return _display->_height; }
+  void setFont(const GFXfont * f = nullptr) { _display->setFont(f); }
+  const GFXfont * getFont(void) const { return _display->gfxFont; }
+  void cp437(bool x = true) { _display->cp437(x); }
+  bool getCp437(void) const { return _display->_cp437; }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if ((x < 0) || (y < 0) || (x >= width()) || (y >= height())) return;
+    uint8_t rotation = getRotation(); // Read by GFX_CORE_ROTATE
+    GFX_CORE_ROTATE(x, y);
+    _display->markDirty(x, x, y / 8, y / 8);
+    uint8_t * ptr = &_display->_buffer[x + (y / 8) * WIDTH];
+    switch (color) {
+      case WHITE:   *ptr |=  (1 << (y & 7)); break;
+      case BLACK:   *ptr &= ~(1 << (y & 7)); break;
+      case INVERSE: *ptr ^=  (1 << (y & 7)); break;
+    }
+  }
+
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    _display->SSD1306::drawFastVLine(x, y, h, color);
+  }
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    _display->SSD1306::drawFastHLine(x, y, w, color);
+  }
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    _display->SSD1306::fillRect(x, y, w, h, color);
+  }
+  void fillScreen(uint16_t color) {
+    _display->SSD1306::fillScreen(color);
+  }
+  void fillSpans(const GFXspan * spans, uint16_t count, bool vertical, uint16_t color) {
+    _display->SSD1306::fillSpans(spans, count, vertical, color);
+  }
+
+  // The text blits of the driver where they apply, the pixel path of the core otherwise
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size) {
+    if ((getRotation() == 0) && (size <= SSD1306::MaxScaledTextSize) && (getFont() == nullptr))
+      _display->SSD1306::drawChar(x, y, c, color, bg, size);
+    else
+      GFXcore<SSD1306Core>::drawChar(x, y, c, color, bg, size);
+  }
+  void drawGlyph(int16_t x, int16_t y, uint16_t index, uint16_t color, uint8_t size) {
+    GlyphAtlas * atlas = _display->_atlas;
+    if ((getRotation() == 0) && (size <= SSD1306::MaxScaledTextSize) &&
+        (atlas != nullptr) && (atlas->Font() == getFont()))
+      _display->SSD1306::drawGlyph(x, y, index, color, size);
+    else
+      GFXcore<SSD1306Core>::drawGlyph(x, y, index, color, size);
+  }
 
+ private:
+  SSD1306 * _display;
+};
 
+/**
+ * @brief SSD1306 with a Width x Height frame buffer inside the instance
+ * @details Panels of different size can be used side by side, e.g. SSD1306_128x64
+ *  and SSD1306_128x32. The buffer is cleared, call drawSplash() to show the logo.
+ */
+template <int16_t Width = SSD1306_LCDWIDTH, int16_t Height = SSD1306_LCDHEIGHT>
+class SSD1306Panel : public SSD1306 {
+  static_assert((Width > 0) && (Width <= SSD1306_LCDWIDTH), "Width not supported by SSD1306");
+  static_assert((Height >= 16) && (Height <= SSD1306_LCDHEIGHT) && (Height % 8 == 0),
+    "Height must be a multiple of 8 between 16 and 64");
 
+ public:
+  SSD1306Panel(SpiPort * spiI, OutputPort * dc, OutputPort * rst)
+    : SSD1306(spiI, dc, rst, Width, Height, _frame) {
+    memset(_frame, 0, sizeof(_frame));
+  }
 
+  SSD1306Panel(I2cPort * i2c, uint8_t address = SSD1306_I2C_ADDRESS, OutputPort * rst = nullptr)
+    : SSD1306(i2c, address, rst, Width, Height, _frame) {
+    memset(_frame, 0, sizeof(_frame));
+  }
 
+ private:
+  uint8_t _frame[Width * Height / 8];
+};
 
-
-
-
-
-
+typedef SSD1306Panel<128, 64> SSD1306_128x64;
+typedef SSD1306Panel<128, 32> SSD1306_128x32;
@@ -0,0 +1,133 @@
+/**
+ * @file Display_SSD1306Fixed.h
+ * @author Gustice
+ * @brief Display-Contoller with rotation fixed at compile time
+ * @details The runtime rotation of SSD1306 costs a switch on every pixel and every
+ *  pixel of a line is a virtual call. This variant resolves the transformation at
+ *  compile time and draws lines and circles by the rendering core (gfxcore.h) with
+ *  inlined pixel writes. SSD1306Core does the same for a display whose rotation is
+ *  only known at runtime, i.e. with a switch per pixel.
+ *  Use SSD1306Panel if the rotation has to be changed while running.
+ * @version 0.1
+ * @date 2021-01-01
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#pragma once
+
+#include <stdlib.h>
+#include "Display_SSD1306.h"
+
+template <uint8_t Rotation, int16_t Width, int16_t Height>
+class SSD1306Fixed;
+
+// Target of the rendering core for SSD1306Fixed: pixels, lines and rectangles go to
+// the non virtual functions of the display, the rotation is folded at compile time
+template <uint8_t Rotation, int16_t Width, int16_t Height>
+class SSD1306FixedCore : public GFXcore<SSD1306FixedCore<Rotation, Width, Height>> {
+ public:
+  SSD1306FixedCore(SSD1306Fixed<Rotation, Width, Height> * display)
+    : GFXcore<SSD1306FixedCore>(Width, Height), _display(display) {
+    this->setRotation(Rotation);
+  }
+
+  inline void drawPixel(int16_t x, int16_t y, uint16_t color) { _display->setPixel(x, y, color); }
+
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) { _display->fillArea(x, y, 1, h, color); }
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) { _display->fillArea(x, y, w, 1, color); }
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) { _display->fillArea(x, y, w, h, color); }
+
+ private:
+  SSD1306Fixed<Rotation, Width, Height> * _display;
+};
+
+template <uint8_t Rotation, int16_t Width = SSD1306_LCDWIDTH, int16_t Height = SSD1306_LCDHEIGHT>
+class SSD1306Fixed final : public SSD1306Panel<Width, Height> {
+  static_assert(Rotation < 4, "Rotation must be 0..3");
+
+ public:
+  // Drawing area as seen by the application
+  static const int16_t ViewWidth  = (Rotation & 1) ? Height : Width;
+  static const int16_t ViewHeight = (Rotation & 1) ? Width : Height;
+
+  SSD1306Fixed(SpiPort * spiI, OutputPort * dc, OutputPort * rst)
+    : SSD1306Panel<Width, Height>(spiI, dc, rst), _core(this) {
+    Adafruit_GFX::setRotation(Rotation);
+  }
+
+  SSD1306Fixed(I2cPort * i2c, uint8_t address = SSD1306_I2C_ADDRESS, OutputPort * rst = nullptr)
+    : SSD1306Panel<Width, Height>(i2c, address, rst), _core(this) {
+    Adafruit_GFX::setRotation(Rotation);
+  }
+
+  // Rotation is part of the type
+  void setRotation(uint8_t /*r*/) {}
+
+  // Non virtual pixel access for the hot loops
+  inline void setPixel(int16_t x, int16_t y, uint16_t color) {
+    if (((uint16_t)x >= (uint16_t)ViewWidth) || ((uint16_t)y >= (uint16_t)ViewHeight))
+      return;
+
+    int16_t px, py;
+    toPanel(x, y, px, py);
+
+    uint8_t page = py / 8;
+    uint8_t mask = 1 << (py & 7);
+    uint8_t * pBuf = &this->_buffer[px + page * Width];
+    this->markDirty(px, px, page, page);
+    switch (color)
+    {
+      case WHITE:   *pBuf |=  mask; break;
+      case BLACK:   *pBuf &= ~mask; break;
+      case INVERSE: *pBuf ^=  mask; break;
+    }
+  }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color)  { setPixel(x, y, color); }
+  void writePixel(int16_t x, int16_t y, uint16_t color) { setPixel(x, y, color); }
+
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)  { fillArea(x, y, w, 1, color); }
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)  { fillArea(x, y, 1, h, color); }
+  void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) { fillArea(x, y, w, 1, color); }
+  void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) { fillArea(x, y, 1, h, color); }
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)      { fillArea(x, y, w, h, color); }
+  void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) { fillArea(x, y, w, h, color); }
+
+  // Lines and circles by the rendering core, same pixels as Adafruit_GFX
+  void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    _core.drawLine(x0, y0, x1, y1, color);
+  }
+  void writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    _core.writeLine(x0, y0, x1, y1, color);
+  }
+  void drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+    _core.drawCircle(x0, y0, r, color);
+  }
+
+ private:
+  SSD1306FixedCore<Rotation, Width, Height> _core;
+  friend class SSD1306FixedCore<Rotation, Width, Height>;
+
+  // Same transformation as SSD1306::drawPixel, folded by the compiler
+  static inline void toPanel(int16_t x, int16_t y, int16_t & px, int16_t & py) {
+    switch (Rotation) {
+      case 0: px = x;              py = y;               break;
+      case 1: px = Width - 1 - y;  py = x;               break;
+      case 2: px = Width - 1 - x;  py = Height - 1 - y;  break;
+      case 3: px = y;              py = Height - 1 - x;  break;
+    }
+  }
+
+  inline void fillArea(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    if ((w <= 0) || (h <= 0))
+      return;
+
+    switch (Rotation) {
+      case 0: this->fillRectInternal(x, y, w, h, color);                          break;
+      case 1: this->fillRectInternal(Width - y - h, x, h, w, color);              break;
+      case 2: this->fillRectInternal(Width - x - w, Height - y - h, w, h, color); break;
+      case 3: this->fillRectInternal(y, Height - x - w, h, w, color);             break;
+    }
+  }
+};
@@ -0,0 +1,38 @@
+/**
+ * @file GlyphAtlas.h
+ * @author Gustice
+ * @brief Glyphs of a GFXfont pre-rasterized in SSD1306 page layout
+ * @details GFXfont glyphs are stored row by row as a continuous bit stream. The atlas
+ *  converts them once into columns of page bytes (LSB = top row), so printing a
+ *  character is a handful of byte operations on the frame buffer.
+ *  The classic built-in font is already stored in this layout and needs no atlas.
+ * @version 0.1
+ * @date 2021-01-01
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include "gfxfont.h"
+
+class GlyphAtlas
+{
+public:
+    /// The atlas is invalid if there is not enough memory or it would exceed 64 KiB
+    GlyphAtlas(const GFXfont * font);
+    ~GlyphAtlas();
+
+    bool IsValid(void) const { return _data != nullptr; }
+    const GFXfont * Font(void) const { return _font; }
+
+    /// Column data of glyph index c (position in font->glyph, see gfxFontGlyphIndex),
+    /// (height+7)/8 page bytes per column
+    const uint8_t * Columns(uint16_t c) const { return &_data[_offsets[c]]; }
+
+private:
+    const GFXfont * _font;
+    uint8_t * _data = nullptr;
+    uint16_t * _offsets = nullptr;
+};
@@ -11,6 +11,7 @@
 #pragma once 
 
 #include "Display_SSD1306.h"
+#include "UiWidgets.h"
 
 typedef struct point_def
 {
@@ -19,9 +20,34 @@ typedef struct point_def
 } point_t;
 
 
+/// Minimum and maximum of the last 24 hours, kept per hour
+class DailyRange
+{
+public:
+    static const size_t Hours = 24;
+
+    void Add(float value, uint32_t hour);
+    /// Returns false if there is no value of the last 24 hours
+    bool Get(uint32_t hour, float * min, float * max) const;
+
+private:
+    float _min[Hours];
+    float _max[Hours];
+    uint32_t _hour[Hours] = {}; // Hour of the slot + 1, 0 for an unused slot
+};
+
 class MyDisplay
 {
 public:
+    /// Screens of the status area, the log area is shown below each of them
+    enum Screen
+    {
+        ScreenValues,
+        ScreenRange,
+        ScreenNetwork,
+        ScreenCount
+    };
+
     MyDisplay(SSD1306 * display);
     ~MyDisplay(){}
 
@@ -29,19 +55,49 @@ public:
     void NewImage(void) {_display->clearDisplay();}
 
     void PrintInitFrame(bool wifiOk, bool supply, float battery);
-    void PrintLogLine(char * line);
+    void PrintLogLine(const char * line);
+
+    // Element updates, shown by the next Update()
+    void SetStatus(bool wifiOk, bool supply, float battery);
+    /// Signal strength of the connection in dBm, shown as 1 to 3 bars
+    void SetSignal(int8_t rssi);
+    void SetValues(float temperature, float humidity);
+    /// IP address of the station, shown on the network screen
+    void SetAddress(const char * address);
+    /// Redraws and transmits only the elements that changed
+    void Update(void);
+
+    /// Copies in the background of the screen and draws its elements
+    void ShowScreen(Screen screen);
+    /// Rotates through the screens, e.g. called every few seconds
+    void NextScreen(void);
+    Screen CurrentScreen(void) const { return _current; }
 
 private:
+    void renderBackground(Screen screen);
+
     SSD1306 * _display;
-    void printBattery(point_t anchor, uint32_t full);
-    void printConnectSymbol(point_t anchor);
-    void printPowerSymbol(point_t anchor);
-    void printWarningSymbol(point_t anchor);
 
-    static const size_t LogLines = 4;
-    static const size_t LogLineChars = 25; // Each line contains max 24 characters
-    char log[LogLines][LogLineChars]; 
+    Screen _current = ScreenValues;
+    UiBackground _backgrounds[ScreenCount];
+    UiScreen _screens[ScreenCount];
+    UiScreen _shared; // Shown on every screen
 
-    int logLine = 0;
-};
+    UiIcon _battery;
+    UiIcon _connection;
+    UiIcon _supply;
+    UiLog _log;
 
+    UiNumber _temperature;
+    UiNumber _humidity;
+    UiTrend _temperatureTrend;
+    UiTrend _humidityTrend;
+
+    DailyRange _temperatureDay;
+    DailyRange _humidityDay;
+    UiRange _temperatureRange;
+    UiRange _humidityRange;
+
+    UiLabel _signal;
+    UiLabel _address;
+};
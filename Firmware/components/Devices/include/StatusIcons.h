@@ -0,0 +1,76 @@
+// Generated by iconconvert, do not edit.  Add or change the images
+// and run the tool again.
+
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+
+const uint8_t StatusIconsBitmaps[] PROGMEM = {
+  // battery_0, 12x16
+  0x00, 0xF8, 0x08, 0x08, 0x0E, 0x0E, 0x0E, 0x0E, 0x08, 0x08, 0xF8, 0x00,
+  0x00, 0x7F, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x7F, 0x00,
+  // battery_1, 12x16
+  0x00, 0xF8, 0x08, 0x08, 0x0E, 0x0E, 0x0E, 0x0E, 0x08, 0x08, 0xF8, 0x00,
+  0x00, 0x7F, 0x70, 0x70, 0x70, 0x70, 0x70, 0x70, 0x70, 0x70, 0x7F, 0x00,
+  // battery_2, 12x16
+  0x00, 0xF8, 0x08, 0x08, 0x0E, 0x0E, 0x0E, 0x0E, 0x08, 0x08, 0xF8, 0x00,
+  0x00, 0x7F, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7F, 0x00,
+  // battery_3, 12x16
+  0x00, 0xF8, 0x08, 0x08, 0x0E, 0x0E, 0x0E, 0x0E, 0x08, 0x08, 0xF8, 0x00,
+  0x00, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x00,
+  // battery_4, 12x16
+  0x00, 0xF8, 0xC8, 0xC8, 0xCE, 0xCE, 0xCE, 0xCE, 0xC8, 0xC8, 0xF8, 0x00,
+  0x00, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x00,
+  // battery_5, 12x16
+  0x00, 0xF8, 0xF8, 0xF8, 0xFE, 0xFE, 0xFE, 0xFE, 0xF8, 0xF8, 0xF8, 0x00,
+  0x00, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x00,
+  // supply, 12x16
+  0x00, 0x00, 0xE0, 0xFC, 0xE0, 0xE0, 0xE0, 0xFC, 0xE0, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x01, 0x03, 0x07, 0x3F, 0x07, 0x03, 0x01, 0x00, 0x00, 0x00,
+  // warning, 12x16
+  0x00, 0x00, 0x00, 0x00, 0x7C, 0xFE, 0xFE, 0x7C, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x30, 0x7B, 0x7B, 0x30, 0x00, 0x00, 0x00, 0x00,
+  // wifi_1, 12x16
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x1E, 0x1E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  // wifi_2, 12x16
+  0x00, 0x00, 0x00, 0x00, 0xC0, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x1E, 0x1E, 0x1F, 0x1F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  // wifi_3, 12x16
+  0x00, 0x00, 0x00, 0x00, 0xC0, 0xC0, 0xF8, 0xF8, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x1E, 0x1E, 0x1F, 0x1F, 0x1F, 0x1F, 0x00, 0x00, 0x00, 0x00 };
+
+const GFXicon StatusIconsIcons[] PROGMEM = {
+  {     0,  12,  16 },  // battery_0
+  {    24,  12,  16 },  // battery_1
+  {    48,  12,  16 },  // battery_2
+  {    72,  12,  16 },  // battery_3
+  {    96,  12,  16 },  // battery_4
+  {   120,  12,  16 },  // battery_5
+  {   144,  12,  16 },  // supply
+  {   168,  12,  16 },  // warning
+  {   192,  12,  16 },  // wifi_1
+  {   216,  12,  16 },  // wifi_2
+  {   240,  12,  16 }   // wifi_3
+};
+
+enum {
+  StatusIcons_battery_0,
+  StatusIcons_battery_1,
+  StatusIcons_battery_2,
+  StatusIcons_battery_3,
+  StatusIcons_battery_4,
+  StatusIcons_battery_5,
+  StatusIcons_supply,
+  StatusIcons_warning,
+  StatusIcons_wifi_1,
+  StatusIcons_wifi_2,
+  StatusIcons_wifi_3
+};
+
+const GFXiconSet StatusIcons PROGMEM = {
+  (uint8_t  *)StatusIconsBitmaps,
+  (GFXicon  *)StatusIconsIcons,
+  11 };
+
+// Approx. 332 bytes
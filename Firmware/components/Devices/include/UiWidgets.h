@@ -0,0 +1,240 @@
+/**
+ * @file UiWidgets.h
+ * @author Gustice
+ * @brief Retained UI elements for the status screen
+ * @details Each widget owns a bounding box and keeps the state it shows. Setters only
+ *  invalidate a widget if its content really changed, UiScreen::Render() clears and
+ *  redraws the invalidated boxes only. Together with the dirty tracking of SSD1306 an
+ *  update transmits just the regions of the widgets that changed.
+ * @version 0.1
+ * @date 2021-01-01
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "Display_SSD1306.h"
+
+class UiWidget
+{
+public:
+    UiWidget(int16_t x, int16_t y, int16_t w, int16_t h);
+    virtual ~UiWidget() {}
+
+    /// Forces a redraw with the next render pass, e.g. after the screen was cleared
+    virtual void Invalidate(void) { _dirty = true; }
+    bool IsDirty(void) const { return _dirty; }
+
+    /// Clears the bounding box and draws the content
+    virtual void Render(Adafruit_GFX * gfx);
+
+protected:
+    virtual void draw(Adafruit_GFX * gfx) = 0;
+
+    int16_t _x, _y, _w, _h;
+    bool _dirty = true;
+
+private:
+    friend class UiScreen;
+    UiWidget * _next = nullptr;
+};
+
+/// Single line of text, the text is copied
+class UiLabel : public UiWidget
+{
+public:
+    static const size_t LabelChars = 22; // One line of the classic font on 128 pixels
+
+    UiLabel(int16_t x, int16_t y, int16_t w, int16_t h, const char * text = "", uint8_t size = 1);
+
+    void SetText(const char * text);
+    const char * Text(void) const { return _text; }
+
+protected:
+    void draw(Adafruit_GFX * gfx);
+
+private:
+    char _text[LabelChars];
+    uint8_t _size;
+};
+
+/// Fixed point number between prefix and unit, e.g. "T = 21.5 °C"
+class UiNumber : public UiLabel
+{
+public:
+    UiNumber(int16_t x, int16_t y, int16_t w, int16_t h,
+             const char * prefix, const char * unit, uint8_t decimals = 1, uint8_t size = 1);
+
+    void SetValue(float value);
+
+private:
+    const char * _prefix;
+    const char * _unit;
+    uint8_t _decimals;
+};
+
+/// Range of a value between the unit, e.g. "18.5 .. 24.1 °C"
+class UiRange : public UiLabel
+{
+public:
+    UiRange(int16_t x, int16_t y, int16_t w, int16_t h, const char * unit, uint8_t decimals = 1, uint8_t size = 1);
+
+    void SetRange(float min, float max);
+
+private:
+    const char * _unit;
+    uint8_t _decimals;
+};
+
+/**
+ * @brief Symbol of an icon set, selected by a state value
+ * @details The icon is blitted opaque. If it covers the whole box, drawing it is the
+ *  only write to the frame buffer.
+ */
+class UiIcon : public UiWidget
+{
+public:
+    /// Index of the icon in the set for 'state', negative for no icon
+    typedef int16_t (*Selector)(int32_t state);
+
+    UiIcon(int16_t x, int16_t y, int16_t w, int16_t h, const GFXiconSet * icons, Selector select,
+           int32_t state = 0);
+
+    void SetState(int32_t state);
+    int32_t State(void) const { return _state; }
+
+    void Render(Adafruit_GFX * gfx);
+
+protected:
+    void draw(Adafruit_GFX * gfx);
+
+private:
+    const GFXiconSet * _icons;
+    Selector _select;
+    int32_t _state;
+};
+
+/**
+ * @brief Ring of text lines, one line per page
+ * @details Lines are stored in slots of 8 rows. A new line replaces the oldest slot and
+ *  only this slot is redrawn. The panel has to show the slots starting at Head(),
+ *  see SSD1306::setStartLine.
+ */
+class UiLog : public UiWidget
+{
+public:
+    static const size_t Lines = 4;
+    static const size_t LineChars = 25; // Each line contains max 24 characters
+    static const int16_t LineHeight = 8;
+
+    UiLog(int16_t x, int16_t y, int16_t w);
+
+    /// Returns true if the oldest line was replaced, i.e. the content has to scroll
+    bool Append(const char * line);
+    /// Slot of the topmost visible line
+    size_t Head(void) const { return _head; }
+
+    void Invalidate(void);
+    void Render(Adafruit_GFX * gfx);
+
+protected:
+    void draw(Adafruit_GFX * gfx);
+
+private:
+    void drawSlot(Adafruit_GFX * gfx, size_t slot);
+
+    char _lines[Lines][LineChars];
+    size_t _count = 0; // Number of lines in use
+    size_t _head = 0;
+    uint8_t _dirtySlots;
+};
+
+/**
+ * @brief Trend graph of the last samples, one column per sample
+ * @details A new sample shifts the graph by one column in the frame buffer and only
+ *  the newest column is drawn. The y-axis is the range of the kept samples. It changes
+ *  when a new sample is outside of it or when the oldest extreme drops out, just then
+ *  the graph is redrawn completely.
+ *  The box is given in panel coordinates, the display must not be rotated.
+ */
+class UiTrend : public UiWidget
+{
+public:
+    static const size_t MaxSamples = SSD1306_LCDWIDTH;
+
+    UiTrend(SSD1306 * display, int16_t x, int16_t y, int16_t w, int16_t h);
+
+    void AddSample(float value);
+
+    void Invalidate(void);
+    void Render(Adafruit_GFX * gfx);
+
+protected:
+    void draw(Adafruit_GFX * gfx);
+
+private:
+    // One sample more than columns, the leftmost column connects to its predecessor
+    size_t slots(void) const { return _w + 1; }
+    float sample(size_t k) const { return _samples[(_next + slots() - _count + k) % slots()]; }
+    int16_t toRow(float value) const;
+    void updateRange(void);
+    void drawColumn(Adafruit_GFX * gfx, int16_t column);
+
+    SSD1306 * _display;
+    float _samples[MaxSamples + 1];
+    size_t _next = 0;  // Slot of the next sample
+    size_t _count = 0; // Number of samples, up to slots()
+    size_t _added = 0; // Samples since the last render
+    float _min = 0;
+    float _max = 0;
+    bool _full = true;
+};
+
+/**
+ * @brief Static content of a screen area, rendered once and copied back on demand
+ * @details The area consists of whole pages. They are kept with runs of zero bytes
+ *  encoded like the splash of SSD1306, so the mostly empty status area costs a few
+ *  bytes per text line only. Restore() decodes the pages back one at a time.
+ *  The display must not be rotated.
+ */
+class UiBackground
+{
+public:
+    UiBackground(void) {}
+    ~UiBackground();
+
+    /// Keeps the current content of the pages page0 .. page0+pages-1, false if out of memory
+    bool Capture(const SSD1306 * display, uint8_t page0, uint8_t pages);
+    /// Writes the kept content back, the area is transmitted with the next display()
+    void Restore(SSD1306 * display) const;
+
+    /// Bytes kept
+    size_t Size(void) const { return _size; }
+
+private:
+    static size_t encode(const uint8_t * src, size_t length, uint8_t * dst);
+
+    uint8_t * _data = nullptr;
+    size_t _size = 0;
+    int16_t _width = 0;
+    uint8_t _page0 = 0;
+    uint8_t _pages = 0;
+};
+
+/// Widgets of one screen in drawing order
+class UiScreen
+{
+public:
+    void Add(UiWidget * widget);
+    void Invalidate(void);
+
+    /// Redraws the invalidated widgets, returns false if nothing was drawn
+    bool Render(Adafruit_GFX * gfx);
+
+private:
+    UiWidget * _first = nullptr;
+    UiWidget * _last = nullptr;
+};
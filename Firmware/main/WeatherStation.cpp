@@ -168,7 +168,7 @@ void app_main()
     ESP_LOGD(TAG, "Setup Sensor");
     Shtc3_Sensor tempSens(&sensPort);
     ESP_LOGD(TAG, "Setup Display");
-    // SSD1306 displayDriver(&displayPort, &dispDc, &dispRst);
+    // SSD1306_128x64 displayDriver(&displayPort, &dispDc, &dispRst);
     ESP_LOGD(TAG, "Setup Ui");
     // MyDisplay displayUi(&displayDriver);
     // displayUi.PrintInitFrame(true,true,0.5f);
@@ -208,7 +208,8 @@ void app_main()
         }
         else
         {
-            // displayUi.PrintLogLine(line);
+            // displayUi.SetValues(temp, hum);
+            // displayUi.Update();
             ESP_LOGI(TAG, "T=%d / H=%d", (uint32_t)temp, (uint32_t)hum);
             Mqtt_PublishValues(cycleStamp, temp, 0.5f, 0, doorOpen);
             Mqtt_PublishTemperature(temp);